@@ -0,0 +1,192 @@
+﻿// ConnectionTracker.cpp
+#include "ConnectionTracker.h"
+#include <chrono>
+#include <cstring>
+
+bool ConnectionKey::operator==(const ConnectionKey& other) const {
+    return std::memcmp(this, &other, sizeof(ConnectionKey)) == 0;
+}
+
+// 按 8 字节分块混合（FNV 风格乘法），键中全部字节都参与散列
+size_t ConnectionKeyHash::operator()(const ConnectionKey& key) const {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&key);
+    ULONGLONG hash = 14695981039346656037ULL;
+    size_t offset = 0;
+    for (; offset + sizeof(ULONGLONG) <= sizeof(ConnectionKey); offset += sizeof(ULONGLONG)) {
+        ULONGLONG chunk;
+        std::memcpy(&chunk, bytes + offset, sizeof(chunk));
+        hash = (hash ^ chunk) * 1099511628211ULL;
+        hash ^= hash >> 29;
+    }
+    for (; offset < sizeof(ConnectionKey); ++offset) {
+        hash = (hash ^ bytes[offset]) * 1099511628211ULL;
+    }
+    return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+ConnectionKey MakeConnectionKey(const ConnectionInfo& connection) {
+    ConnectionKey key;
+    std::memset(&key, 0, sizeof(key));
+    std::memcpy(key.localAddress, connection.localAddress, sizeof(key.localAddress));
+    std::memcpy(key.remoteAddress, connection.remoteAddress, sizeof(key.remoteAddress));
+    key.localPort = connection.localPort;
+    key.remotePort = connection.remotePort;
+    key.pid = connection.pid;
+    key.protocol = connection.protocol;
+    key.family = connection.family;
+    return key;
+}
+
+ConnectionTracker::ConnectionTracker(size_t maxClosed)
+    : m_generation(0), m_closedNext(0), m_maxClosed(maxClosed) {}
+
+ULONGLONG ConnectionTracker::Now() {
+    auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<ULONGLONG>(
+        std::chrono::duration_cast<std::chrono::microseconds>(sinceEpoch).count()) * 10 + kUnixEpochInFileTime;
+}
+
+void ConnectionTracker::Update(const std::vector<ConnectionInfo>& connections, std::vector<ConnectionEvent>& events) {
+    Update(connections, events, Now());
+}
+
+void ConnectionTracker::Update(const std::vector<ConnectionInfo>& connections, std::vector<ConnectionEvent>& events, ULONGLONG now) {
+    Update(connections, nullptr, events, now);
+}
+
+// 按间隔计算速率；计数回退（不应发生）时视为 0
+static double ByteRate(ULONGLONG current, ULONGLONG previous, double seconds) {
+    return current >= previous ? (current - previous) / seconds : 0.0;
+}
+
+void ConnectionTracker::Update(const std::vector<ConnectionInfo>& connections, std::vector<ConnectionStats>* stats,
+    std::vector<ConnectionEvent>& events, ULONGLONG now) {
+    ++m_generation;
+    bool hasStats = stats && stats->size() == connections.size();
+
+    // 先更新已有连接并移除已关闭的连接，再插入新连接：活动表的峰值为前后两次快照中较大者，
+    // 而不是两者之和，连接大量更替时桶数组不会因此翻倍
+    m_opened.clear();
+    for (size_t i = 0; i < connections.size(); ++i) {
+        const ConnectionInfo& connection = connections[i];
+        auto it = m_active.find(MakeConnectionKey(connection));
+        if (it == m_active.end()) {
+            m_opened.push_back(i);
+            continue;
+        }
+        Entry& entry = it->second;
+
+        // 同一快照中重复出现的连接（如多个进程共享的监听套接字）只记录一次
+        if (entry.lastGeneration == m_generation) {
+            continue;
+        }
+        entry.lastGeneration = m_generation;
+
+        if (hasStats) {
+            ConnectionStats& current = (*stats)[i];
+            const ConnectionStats& previous = entry.tracked.stats;
+            double seconds = (now - entry.tracked.lastSeen) / 10000000.0;
+            if (seconds > 0.0) {
+                current.sendRate = ByteRate(current.bytesSent, previous.bytesSent, seconds);
+                current.receiveRate = ByteRate(current.bytesReceived, previous.bytesReceived, seconds);
+            }
+            entry.tracked.stats = current;
+        }
+        entry.tracked.lastSeen = now;
+
+        ConnectionState previousState = entry.tracked.connection.state;
+        entry.tracked.connection = connection;
+        if (previousState != connection.state) {
+            events.push_back(ConnectionEvent{ CONNECTION_EVENT_STATE_CHANGED, previousState, entry.tracked });
+        }
+    }
+
+    // 本次未出现的连接视为已关闭
+    for (auto it = m_active.begin(); it != m_active.end();) {
+        if (it->second.lastGeneration != m_generation) {
+            events.push_back(ConnectionEvent{ CONNECTION_EVENT_CLOSED, CONNECTION_STATE_UNKNOWN, it->second.tracked });
+            RecordClosed(it->second.tracked);
+            it = m_active.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    for (size_t i : m_opened) {
+        const ConnectionInfo& connection = connections[i];
+        auto result = m_active.try_emplace(MakeConnectionKey(connection));
+        if (!result.second) {
+            continue;   // 同一快照中重复出现的新连接
+        }
+        Entry& entry = result.first->second;
+        entry.tracked.connection = connection;
+        entry.tracked.firstSeen = now;
+        entry.tracked.lastSeen = now;
+        entry.tracked.stats = hasStats ? (*stats)[i] : ConnectionStats();
+        entry.lastGeneration = m_generation;
+        events.push_back(ConnectionEvent{ CONNECTION_EVENT_OPENED, CONNECTION_STATE_UNKNOWN, entry.tracked });
+    }
+
+    // 连接数高峰过后桶数组不会自动收缩，明显过大时按当前大小重建
+    if (m_active.bucket_count() > 1024 && m_active.size() * 8 < m_active.bucket_count()) {
+        m_active.rehash(0);
+    }
+}
+
+void ConnectionTracker::RecordClosed(const TrackedConnection& tracked) {
+    if (m_maxClosed == 0) {
+        return;
+    }
+
+    if (m_closed.size() < m_maxClosed) {
+        m_closed.push_back(tracked);
+    }
+    else {
+        m_closed[m_closedNext] = tracked;
+    }
+    m_closedNext = (m_closedNext + 1) % m_maxClosed;
+}
+
+void ConnectionTracker::GetActiveConnections(std::vector<TrackedConnection>& connections) const {
+    connections.clear();
+    connections.reserve(m_active.size());
+    for (const auto& pair : m_active) {
+        connections.push_back(pair.second.tracked);
+    }
+}
+
+void ConnectionTracker::GetClosedConnections(std::vector<TrackedConnection>& connections) const {
+    connections.clear();
+    connections.reserve(m_closed.size());
+    // 未写满时从头开始，写满后从最早的记录（下一个写入位置）开始
+    size_t start = m_closed.size() < m_maxClosed ? 0 : m_closedNext;
+    for (size_t i = 0; i < m_closed.size(); ++i) {
+        connections.push_back(m_closed[(start + i) % m_closed.size()]);
+    }
+}
+
+const TrackedConnection* ConnectionTracker::FindActive(const ConnectionInfo& connection) const {
+    auto it = m_active.find(MakeConnectionKey(connection));
+    return it != m_active.end() ? &it->second.tracked : nullptr;
+}
+
+void ConnectionTracker::SetMaxClosed(size_t maxClosed) {
+    std::vector<TrackedConnection> closed;
+    GetClosedConnections(closed);
+    if (closed.size() > maxClosed) {
+        closed.erase(closed.begin(), closed.end() - maxClosed);
+    }
+
+    m_maxClosed = maxClosed;
+    m_closed = std::move(closed);
+    m_closed.shrink_to_fit();
+    m_closedNext = maxClosed ? m_closed.size() % maxClosed : 0;
+}
+
+void ConnectionTracker::Reset() {
+    m_active.clear();
+    m_generation = 0;
+    m_closed.clear();
+    m_closedNext = 0;
+}
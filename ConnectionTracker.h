@@ -0,0 +1,104 @@
+﻿// ConnectionTracker.h
+#pragma once
+#include "NetworkCollector.h"
+#include <unordered_map>
+#include <vector>
+
+// 连接身份：五元组（协议、本地/远程地址与端口）+ 所属进程，不含状态。
+// 全部字节都有确定取值（含填充），可直接按字节比较和散列
+struct ConnectionKey {
+    BYTE localAddress[16];
+    BYTE remoteAddress[16];
+    WORD localPort;
+    WORD remotePort;
+    DWORD pid;
+    BYTE protocol;
+    AddressFamily family;
+    BYTE reserved[2];
+
+    bool operator==(const ConnectionKey& other) const;
+};
+
+struct ConnectionKeyHash {
+    size_t operator()(const ConnectionKey& key) const;
+};
+
+ConnectionKey MakeConnectionKey(const ConnectionInfo& connection);
+
+enum ConnectionEventType : BYTE {
+    CONNECTION_EVENT_OPENED,          // 首次出现
+    CONNECTION_EVENT_CLOSED,          // 本次采集中消失
+    CONNECTION_EVENT_STATE_CHANGED    // 状态变化（如 SYN_SENT -> ESTABLISHED）
+};
+
+// 被跟踪的连接：最近一次记录及首次、最近一次出现的时刻（FILETIME 计数，100 纳秒）
+struct TrackedConnection {
+    ConnectionInfo connection;
+    ULONGLONG firstSeen;
+    ULONGLONG lastSeen;
+    ConnectionStats stats;     // 最近一次采样的流量统计及速率（未采集统计时为 0）
+
+    // 已知存续时长（秒）：两次采集之间建立又关闭的连接无法被观察到
+    double GetDurationSeconds() const { return (lastSeen - firstSeen) / 10000000.0; }
+    InternedString GetFirstSeenString() const { return FormatFileTimeCached(UInt64ToFileTime(firstSeen)); }
+    InternedString GetLastSeenString() const { return FormatFileTimeCached(UInt64ToFileTime(lastSeen)); }
+};
+
+struct ConnectionEvent {
+    ConnectionEventType type;
+    ConnectionState previousState;    // 仅 STATE_CHANGED 有效
+    TrackedConnection tracked;        // CLOSED 事件中为连接的最后一次记录
+};
+
+// 连接生命周期跟踪：比较相邻两次连接快照，产生打开、关闭、状态变化事件。
+// 活动表的大小等于当前连接数；已关闭连接保存在定长环形表中，
+// 连接频繁建立关闭时内存占用也保持有界
+class ConnectionTracker {
+public:
+    explicit ConnectionTracker(size_t maxClosed = 4096);
+
+    // 用新的连接快照更新活动表，事件追加到 events；now 为 FILETIME 计数
+    void Update(const std::vector<ConnectionInfo>& connections, std::vector<ConnectionEvent>& events);
+    void Update(const std::vector<ConnectionInfo>& connections, std::vector<ConnectionEvent>& events, ULONGLONG now);
+    // 附带流量统计（与 connections 下标对应）：根据同一连接的上一次采样计算收发速率，
+    // 结果写回 stats 并保存在跟踪记录中；新出现的连接速率为 0
+    void Update(const std::vector<ConnectionInfo>& connections, std::vector<ConnectionStats>* stats,
+        std::vector<ConnectionEvent>& events, ULONGLONG now);
+
+    // 当前活动连接（顺序不定）
+    void GetActiveConnections(std::vector<TrackedConnection>& connections) const;
+    // 最近关闭的连接，按关闭先后排列，最多 GetMaxClosed() 条
+    void GetClosedConnections(std::vector<TrackedConnection>& connections) const;
+    // 查询活动连接，不存在时返回 nullptr
+    const TrackedConnection* FindActive(const ConnectionInfo& connection) const;
+
+    size_t GetActiveCount() const { return m_active.size(); }
+    // 活动表的桶数：连接高峰过后应随活动连接数回落
+    size_t GetActiveBucketCount() const { return m_active.bucket_count(); }
+    size_t GetClosedCount() const { return m_closed.size(); }
+    size_t GetMaxClosed() const { return m_maxClosed; }
+    // 调整关闭连接表容量，超出部分丢弃最早的记录
+    void SetMaxClosed(size_t maxClosed);
+
+    void Reset();
+
+    // 当前时刻的 FILETIME 计数（1601 纪元，100 纳秒）
+    static ULONGLONG Now();
+
+private:
+    struct Entry {
+        TrackedConnection tracked;
+        DWORD lastGeneration;
+    };
+
+    void RecordClosed(const TrackedConnection& tracked);
+
+    std::unordered_map<ConnectionKey, Entry, ConnectionKeyHash> m_active;
+    DWORD m_generation;
+    std::vector<size_t> m_opened;   // 本次新出现的连接在快照中的下标，容量在多次更新间复用
+
+    // 关闭连接环形表：m_closedNext 为下一个写入位置，写满后覆盖最早的记录
+    std::vector<TrackedConnection> m_closed;
+    size_t m_closedNext;
+    size_t m_maxClosed;
+};
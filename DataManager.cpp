@@ -1,6 +1,7 @@
 ﻿// DataManager.cpp
 
 #include "DataManager.h"
+#include <cwctype>
 
 bool DataManager::InitGlobalInstance() {
     return GetInstance().Initialize();
@@ -13,6 +14,7 @@ DataManager& DataManager::GetInstance() {
 
 // 析构函数
 DataManager::~DataManager() {
+    StopProcessEvents();
     StopAutoRefresh();
     Cleanup();
     if (m_refreshThread) {
@@ -25,14 +27,21 @@ DataManager::DataManager()
     : m_refreshInterval(5),
     m_autoRefreshRunning(false),
     m_refreshThread(nullptr),
-    m_initialized(false) {
+    m_initialized(false),
+    m_processEventThread(nullptr),
+    m_processEventsRunning(false),
+    m_reconcileRequested(false),
+    m_reconcileInterval(60),
+    m_lastProcessScan(0) {
 
     // 创建收集器实例
     m_processCollector = std::make_unique<ProcessCollector>();
     m_serviceCollector = std::make_unique<ServiceCollector>();
     m_networkCollector = std::make_unique<NetworkCollector>();
     m_sessionCollector = std::make_unique<SessionCollector>();
+    m_diskCollector = std::make_unique<DiskCollector>();
     m_systemInfoCollector = std::make_unique<SystemInfoCollector>();
+    m_systemSampler = std::make_unique<SystemSampler>();
 }
 
 // 初始化所有收集器 - 线程安全版本
@@ -68,12 +77,25 @@ bool DataManager::Initialize() {
         return false;
     }
 
+    if (!m_diskCollector->Initialize()) {
+        std::cerr << "Failed to initialize disk collector!" << std::endl;
+        Cleanup();
+        return false;
+    }
+
     if (!m_systemInfoCollector->Initialize()) {
         std::cerr << "Failed to initialize system info collector!" << std::endl;
         Cleanup();
         return false;
     }
 
+    // 采样线程独立于界面与自动刷新，初始化后一直运行
+    if (!m_systemSampler->Start(m_systemSampler->GetInterval())) {
+        std::cerr << "Failed to start system sampler!" << std::endl;
+        Cleanup();
+        return false;
+    }
+
     // 所有收集器都初始化成功
     m_initialized = true;
     return true;
@@ -82,7 +104,9 @@ bool DataManager::Initialize() {
 // 清理资源
 void DataManager::Cleanup() {
     // 按相反顺序释放资源
+    if (m_systemSampler) m_systemSampler->Stop();
     if (m_systemInfoCollector) m_systemInfoCollector->Cleanup();
+    if (m_diskCollector) m_diskCollector->Cleanup();
     if (m_sessionCollector) m_sessionCollector->Cleanup();
     if (m_networkCollector) m_networkCollector->Cleanup();
     if (m_serviceCollector) m_serviceCollector->Cleanup();
@@ -96,26 +120,93 @@ bool DataManager::CollectProcesses() {
     std::lock_guard<std::mutex> lock(m_dataMutex);
 
     std::vector<ProcessInfo> processes;
-    if (!m_processCollector->CollectProcesses(processes)) {
+    ProcessDelta delta;
+    if (!m_processCollector->CollectProcesses(processes, delta)) {
         std::cerr << "Failed to collect processes!" << std::endl;
         return false;
     }
 
-    m_processes = std::move(processes);
+    // 系统信息尚未采集时以硬件线程数归一化
+    DWORD cpuCores = m_systemInventory ? m_systemInventory->cpuCores : std::thread::hardware_concurrency();
+    m_processRates.Update(processes, cpuCores);
+    ApplyProcessChanges(processes, delta);
+    m_lastProcessScan = std::chrono::steady_clock::now().time_since_epoch().count();
+    return true;
+}
+
+// 刷新进程计数器
+bool DataManager::RefreshProcessCounters() {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+
+    ProcessDelta delta;
+    if (!m_processCollector->RefreshVolatileFields(m_processes, delta)) {
+        // 有进程已退出或 PID 被复用但事件尚未到达，下一轮做一次全量扫描校正
+        m_reconcileRequested = true;
+    }
+
+    DWORD cpuCores = m_systemInventory ? m_systemInventory->cpuCores : std::thread::hardware_concurrency();
+    m_processRates.Update(m_processes, cpuCores);
+    ApplyProcessChanges(m_processes, delta);
     return true;
 }
 
+// 用新的进程快照及其变化更新进程树、列式表等派生数据（调用方持有 m_dataMutex）
+void DataManager::ApplyProcessChanges(std::vector<ProcessInfo>& processes, ProcessDelta& delta) {
+    m_processTree.Apply(processes, delta);
+    m_processTable.Build(processes);
+    m_processIndex.Build(processes);
+
+    // 启动、退出或更换映像的进程需要重新关联套接字
+    std::vector<DWORD> changedPids;
+    for (size_t index : delta.added) {
+        changedPids.push_back(processes[index].pid);
+    }
+    for (const auto& removed : delta.removed) {
+        changedPids.push_back(removed.pid);
+    }
+    for (const auto& change : delta.changed) {
+        if (change.changedFields & PROCESS_CHANGED_IMAGE) {
+            changedPids.push_back(change.key.pid);
+        }
+    }
+    m_networkCollector->OnProcessesChanged(changedPids);
+
+    if (&processes != &m_processes) {
+        m_processes = std::move(processes);
+    }
+    m_processDelta = std::move(delta);
+
+    // 旧快照已替换，回收不再被引用的驻留字符串
+    StringPool::Instance().Reclaim();
+}
+
 // 收集服务信息
 bool DataManager::CollectServices() {
     std::lock_guard<std::mutex> lock(m_dataMutex);
 
+    // 保留的最近配置变化数
+    const size_t maxConfigChanges = 256;
+
     std::vector<ServiceInfo> services;
-    if (!m_serviceCollector->CollectServices(services)) {
+    std::vector<ServiceConfigChange> changes;
+    if (!m_serviceCollector->CollectServices(services, changes)) {
         std::cerr << "Failed to collect services!" << std::endl;
         return false;
     }
 
+    for (auto& change : changes) {
+        if (change.changedFields & SERVICE_CONFIG_CHANGED_BINARY_PATH) {
+            std::cerr << "Service binary path changed: " << WideToUtf8(change.serviceName) << " \""
+                << WideToUtf8(change.oldBinaryPath) << "\" -> \"" << WideToUtf8(change.newBinaryPath) << "\"" << std::endl;
+        }
+        m_serviceConfigChanges.push_back(std::move(change));
+    }
+    while (m_serviceConfigChanges.size() > maxConfigChanges) {
+        m_serviceConfigChanges.pop_front();
+    }
+
     m_services = std::move(services);
+    StringPool::Instance().Reclaim();
     return true;
 }
 
@@ -124,12 +215,29 @@ bool DataManager::CollectConnections() {
     std::lock_guard<std::mutex> lock(m_dataMutex);
 
     std::vector<ConnectionInfo> connections;
-    if (!m_networkCollector->CollectConnections(connections)) {
+    std::vector<ConnectionStats> stats;
+    if (!m_networkCollector->CollectConnections(connections, stats)) {
         std::cerr << "Failed to collect connections!" << std::endl;
         return false;
     }
 
+    // 保留的最近连接事件数；连接频繁建立关闭时单次刷新的事件可能很多，只保留最新的部分
+    const size_t maxRecentEvents = 4096;
+
+    std::vector<ConnectionEvent> events;
+    ULONGLONG now = ConnectionTracker::Now();
+    m_connectionTracker.Update(connections, &stats, events, now);
+    m_networkAggregates.Apply(events, now);
+    size_t first = events.size() > maxRecentEvents ? events.size() - maxRecentEvents : 0;
+    m_recentConnectionEvents.insert(m_recentConnectionEvents.end(), events.begin() + first, events.end());
+    while (m_recentConnectionEvents.size() > maxRecentEvents) {
+        m_recentConnectionEvents.pop_front();
+    }
+
     m_connections = std::move(connections);
+    m_connectionStats = std::move(stats);
+    // 每个连接显示本地、远程两个端点，留出余量容纳刷新之间新建的连接
+    SetEndpointFormatCacheCapacity(m_connections.size() * 2 + m_connections.size() / 4);
     return true;
 }
 
@@ -147,111 +255,244 @@ bool DataManager::CollectSessions() {
     return true;
 }
 
-// 收集系统信息
-bool DataManager::CollectSystemInfo() {
+// 收集磁盘 I/O
+bool DataManager::CollectDisks() {
     std::lock_guard<std::mutex> lock(m_dataMutex);
 
-    std::unique_ptr<SystemInfo> systemInfo = m_systemInfoCollector->CollectSystemInfo();
-    if (!systemInfo) {
-        std::cerr << "Failed to collect system info!" << std::endl;
+    // 直接写入成员，复用设备名等字符串的容量
+    if (!m_diskCollector->CollectDisks(m_disks)) {
+        std::cerr << "Failed to collect disks!" << std::endl;
         return false;
     }
+    return true;
+}
 
-    m_systemInfo = std::move(systemInfo);
+// 收集系统信息；动态计数器由采样线程按固定节拍采样，这里不再重复采集
+bool DataManager::CollectSystemInfo() {
+    if (m_systemInventoryInvalid.exchange(false) || !m_systemInventory) {
+        // 清单采集较慢，不持有数据锁
+        std::unique_ptr<SystemInventory> inventory = m_systemInfoCollector->CollectInventory();
+        if (!inventory) {
+            m_systemInventoryInvalid = true;
+            std::cerr << "Failed to collect system inventory!" << std::endl;
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_dataMutex);
+        m_systemInventory = std::move(inventory);
+    }
     return true;
 }
 
+void DataManager::InvalidateSystemInventory() {
+    m_systemInventoryInvalid = true;
+}
+
 // 获取进程信息
-const std::vector<ProcessInfo>& DataManager::GetProcesses() const {
+std::vector<ProcessInfo> DataManager::GetProcesses() const {
     std::lock_guard<std::mutex> lock(m_dataMutex);
     return m_processes;
 }
 
+// 获取进程变化
+ProcessDelta DataManager::GetProcessDelta() const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    return m_processDelta;
+}
+
+// 获取进程树
+ProcessTree DataManager::GetProcessTree() const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    return m_processTree;
+}
+
+// 获取进程汇总
+ProcessSummary DataManager::GetProcessSummary() const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    return m_processTable.Summarize();
+}
+
+// 获取指定列取值最大的前 count 个进程
+std::vector<ProcessInfo> DataManager::GetTopProcesses(ProcessTable::Column column, size_t count) const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+
+    std::vector<ProcessInfo> result;
+    for (size_t row : m_processTable.TopN(column, count)) {
+        result.push_back(m_processes[row]);
+    }
+    return result;
+}
+
+// 获取按指定列排序的进程列表
+std::vector<ProcessInfo> DataManager::GetSortedProcesses(ProcessTable::Column column, bool descending) const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+
+    std::vector<ProcessInfo> result;
+    result.reserve(m_processes.size());
+    for (size_t row : m_processTable.SortedRows(column, descending)) {
+        result.push_back(m_processes[row]);
+    }
+    return result;
+}
+
+// 按 pid 查找进程
+ProcessHandle DataManager::FindProcess(DWORD pid) const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+
+    ProcessHandle handle;
+    size_t row = m_processIndex.Find(pid);
+    if (row == ProcessIndex::npos) {
+        return handle;
+    }
+
+    const ProcessInfo& info = m_processes[row];
+    handle.pid = info.pid;
+    handle.parentPid = info.parentPid;
+    handle.createTime = info.createTime;
+    handle.processName = info.processName;
+    handle.executablePath = info.executablePath;
+    handle.valid = true;
+    return handle;
+}
+
 // 获取服务信息
-const std::vector<ServiceInfo>& DataManager::GetServices() const {
+std::vector<ServiceInfo> DataManager::GetServices() const {
     std::lock_guard<std::mutex> lock(m_dataMutex);
     return m_services;
 }
 
+// 获取服务配置变化
+std::vector<ServiceConfigChange> DataManager::GetServiceConfigChanges() const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    return std::vector<ServiceConfigChange>(m_serviceConfigChanges.begin(), m_serviceConfigChanges.end());
+}
+
 // 获取网络连接信息
 const std::vector<ConnectionInfo>& DataManager::GetConnections() const {
     std::lock_guard<std::mutex> lock(m_dataMutex);
     return m_connections;
 }
 
+// 获取带生命周期时刻的连接列表
+std::vector<TrackedConnection> DataManager::GetTrackedConnections() const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+
+    std::vector<TrackedConnection> result;
+    result.reserve(m_connections.size());
+    for (size_t i = 0; i < m_connections.size(); ++i) {
+        const ConnectionInfo& connection = m_connections[i];
+        const TrackedConnection* tracked = m_connectionTracker.FindActive(connection);
+        result.push_back(tracked ? *tracked : TrackedConnection{ connection, 0, 0, ConnectionStats() });
+        // 同一连接在快照中重复出现时，每一行保留各自的记录
+        result.back().connection = connection;
+        if (i < m_connectionStats.size()) {
+            result.back().stats = m_connectionStats[i];
+        }
+    }
+    return result;
+}
+
+// 获取最近关闭的连接
+std::vector<TrackedConnection> DataManager::GetClosedConnections() const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+
+    std::vector<TrackedConnection> result;
+    m_connectionTracker.GetClosedConnections(result);
+    return result;
+}
+
+// 获取最近的连接事件
+std::vector<ConnectionEvent> DataManager::GetRecentConnectionEvents() const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    return std::vector<ConnectionEvent>(m_recentConnectionEvents.begin(), m_recentConnectionEvents.end());
+}
+
+// 获取连接汇总
+NetworkSummary DataManager::GetNetworkSummary(size_t topCount) const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+
+    NetworkSummary summary;
+    summary.stateCounts = m_networkAggregates.GetStateCounts();
+    summary.topProcesses = m_networkAggregates.TopProcesses(topCount);
+    summary.topRemotePrefixes = m_networkAggregates.TopRemotePrefixes(topCount);
+    summary.listeningPorts = m_networkAggregates.ListeningPorts();
+    summary.stateHistory = m_networkAggregates.GetStateHistory();
+    return summary;
+}
+
 // 获取会话信息
 const std::vector<SessionInfo>& DataManager::GetSessions() const {
     std::lock_guard<std::mutex> lock(m_dataMutex);
     return m_sessions;
 }
 
-// 获取系统信息
-const SystemInfo& DataManager::GetSystemInfo() const {
+std::vector<DiskInfo> DataManager::GetDisks() const {
     std::lock_guard<std::mutex> lock(m_dataMutex);
-    if (!m_systemInfo) {
-        static SystemInfo emptyInfo;
-        return emptyInfo;
-    }
-    return *m_systemInfo;
+    return m_disks;
 }
 
-// 辅助函数：将FILETIME转换为64位整数（单位：100纳秒）
-ULONGLONG FileTimeToUInt64(const FILETIME& ft) {
-    ULARGE_INTEGER ul;
-    ul.LowPart = ft.dwLowDateTime;
-    ul.HighPart = ft.dwHighDateTime;
-    return ul.QuadPart;
+// 获取系统静态清单；清单失效后会被重新采集的对象替换，因此在锁内复制
+SystemInventory DataManager::GetSystemInventory() const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    return m_systemInventory ? *m_systemInventory : SystemInventory();
 }
 
-// 计算CPU使用率
-const double DataManager::GetCpuUsage() const {
-    std::lock_guard<std::mutex> lock(m_dataMutex); // 确保线程安全
+SystemCounters DataManager::GetSystemCounters() const {
+    SystemSample sample;
+    m_systemSampler->GetLatest(sample);
+    return sample.counters;
+}
 
-    // 检查系统信息是否有效
-    if (!m_systemInfo) {
-        return 0.0;
+// 与 GetCpuUsage 相同，按采样线程的样本对计算；只有一个样本时各项为 0
+void DataManager::GetCpuCoreUsage(std::vector<CpuCoreUsage>& usage) const {
+    static const CpuCoreSample empty;
+    std::vector<CpuCoreSample> samples;
+    size_t count = m_systemSampler->GetCoreHistory(2, samples);
+    if (count == 0) {
+        usage.clear();
+        return;
     }
+    CalculateCpuCoreUsage(count == 2 ? samples[0] : empty, samples[count - 1], usage);
+}
 
-    const SystemInfo& currentInfo = *m_systemInfo;
-
-    // 首次调用时，仅记录当前CPU时间，不计算使用率
-    static FILETIME s_lastIdleTime = { 0 };
-    static FILETIME s_lastKernelTime = { 0 };
-    static FILETIME s_lastUserTime = { 0 };
-    static bool s_isFirstCall = true;
+// CPU 使用率：取采样线程最近两个样本按各自的时间戳计算，不保存调用方状态，多处调用互不干扰
+const double DataManager::GetCpuUsage() const {
+    std::vector<SystemSample> samples;
+    if (m_systemSampler->GetHistory(2, samples) < 2) {
+        return 0.0;
+    }
+    return (std::max)(0.0, (std::min)(100.0, CalculateCpuUsage(samples[0], samples[1])));
+}
 
-    if (s_isFirstCall) {
-        // 记录首次采集的时间
-        s_lastIdleTime = currentInfo.idleTime;
-        s_lastKernelTime = currentInfo.kernelTime;
-        s_lastUserTime = currentInfo.userTime;
-        s_isFirstCall = false;
-        return 0.0; // 首次调用无法计算，返回0
+MemoryRates DataManager::GetMemoryRates() const {
+    std::vector<SystemSample> samples;
+    if (m_systemSampler->GetHistory(2, samples) < 2) {
+        return MemoryRates();
     }
+    return CalculateMemoryRates(samples[0], samples[1]);
+}
 
-    // 计算两次采集的时间差值（单位：100纳秒）
-    ULONGLONG idleDiff = FileTimeToUInt64(currentInfo.idleTime) - FileTimeToUInt64(s_lastIdleTime);
-    ULONGLONG kernelDiff = FileTimeToUInt64(currentInfo.kernelTime) - FileTimeToUInt64(s_lastKernelTime);
-    ULONGLONG userDiff = FileTimeToUInt64(currentInfo.userTime) - FileTimeToUInt64(s_lastUserTime);
+void DataManager::SetSystemSampleInterval(std::chrono::milliseconds interval) {
+    m_systemSampler->SetInterval(interval);
+}
 
-    // 更新上次采集的时间（用于下次计算）
-    s_lastIdleTime = currentInfo.idleTime;
-    s_lastKernelTime = currentInfo.kernelTime;
-    s_lastUserTime = currentInfo.userTime;
+std::chrono::milliseconds DataManager::GetSystemSampleInterval() const {
+    return m_systemSampler->GetInterval();
+}
 
-    // 总CPU时间 = 内核时间差 + 用户时间差（系统总消耗的CPU时间）
-    ULONGLONG totalDiff = kernelDiff + userDiff;
+SystemSampler::Cursor DataManager::CreateSystemSampleCursor(bool fromOldest) const {
+    return m_systemSampler->CreateCursor(fromOldest);
+}
 
-    // 避免除零错误（时间差为0时返回0）
-    if (totalDiff == 0) {
-        return 0.0;
-    }
+bool DataManager::ReadSystemSample(SystemSampler::Cursor& cursor, SystemSample& sample) const {
+    return m_systemSampler->Read(cursor, sample);
+}
 
-    // CPU使用率 = (1 - 空闲时间差 / 总时间差) × 100%
-    double usage = (1.0 - static_cast<double>(idleDiff) / totalDiff) * 100.0;
+bool DataManager::GetLatestSystemSample(SystemSample& sample) const {
+    return m_systemSampler->GetLatest(sample);
+}
 
-    // 确保使用率在0-100之间（避免浮点计算误差）
-    return max(0.0, min(100.0, usage));
+size_t DataManager::GetSystemSampleHistory(size_t count, std::vector<SystemSample>& samples) const {
+    return m_systemSampler->GetHistory(count, samples);
 }
 
 bool DataManager::TerminateTargetProcessByPid(DWORD pid)
@@ -266,79 +507,101 @@ bool DataManager::TerminateTargetProcessByName(const std::string& processName)
 
 
 bool DataManager::StartTargetService(const std::wstring& serviceName) {
-    SC_HANDLE schSCManager = OpenSCManager(NULL, NULL, SC_MANAGER_ALL_ACCESS);
-    if (schSCManager == NULL) {
-        std::cerr << "OpenSCManager failed!" << std::endl;
-        return false;
-    }
-
-    SC_HANDLE schService = OpenServiceW(schSCManager, serviceName.c_str(), SERVICE_ALL_ACCESS);
-    if (schService == NULL) {
-        std::cerr << "OpenServiceW failed for service: " << WideToMultiByte(serviceName) << std::endl;
-        CloseServiceHandle(schSCManager);
-        return false;
-    }
-
-    BOOL result = ::StartServiceW(schService, 0, NULL);
-    if (!result && GetLastError() == ERROR_SERVICE_ALREADY_RUNNING) {
-        std::wcout << L"Service " << serviceName << L" is already running." << std::endl;
-        result = TRUE;
-    }
-
-    CloseServiceHandle(schService);
-    CloseServiceHandle(schSCManager);
-    return result != 0;
+    return ControlServiceAsync(serviceName, SERVICE_OPERATION_START).get().Succeeded();
 }
 
 // 停止服务
 bool DataManager::StopService(const std::wstring& serviceName) {
-    // 打开服务控制管理器数据库，获取其句柄
-    SC_HANDLE schSCManager = OpenSCManager(NULL, NULL, SC_MANAGER_ALL_ACCESS);
-    if (schSCManager == NULL) {
-        // 若打开失败，输出错误信息并返回 false
-        std::cerr << "OpenSCManager failed!" << std::endl;
-        return false;
-    }
+    return ControlServiceAsync(serviceName, SERVICE_OPERATION_STOP).get().Succeeded();
+}
 
-    // 打开指定名称的服务，获取其句柄
-    SC_HANDLE schService = OpenService(schSCManager, serviceName.c_str(), SERVICE_ALL_ACCESS);
-    if (schService == NULL) {
-        // 若打开失败，输出错误信息，关闭服务控制管理器句柄并返回 false
-        std::cerr << "OpenService failed for service: " << WideToMultiByte(serviceName) << std::endl;
-        CloseServiceHandle(schSCManager);
-        return false;
-    }
+// 重启服务：确认停止后再启动
+bool DataManager::RestartService(const std::wstring& serviceName) {
+    return ControlServiceAsync(serviceName, SERVICE_OPERATION_RESTART).get().Succeeded();
+}
 
-    // 定义一个 SERVICE_STATUS 结构体来存储服务状态信息
-    SERVICE_STATUS serviceStatus = { 0 };
-    // 调用 ControlService 函数尝试停止服务
-    BOOL result = ControlService(schService, SERVICE_CONTROL_STOP, &serviceStatus);
-    if (!result && GetLastError() == ERROR_SERVICE_NOT_ACTIVE) {
-        // 若服务已经停止，输出提示信息并将 result 设为 TRUE
-        std::wcout << L"Service " << serviceName << L" is already stopped." << std::endl;
-        result = TRUE;
+std::future<ServiceOperationOutcome> DataManager::ControlServiceAsync(const std::wstring& serviceName,
+    ServiceOperationType type, ServiceOperationCallback callback) {
+    ServiceController* controller = m_serviceCollector->GetController();
+    if (!controller) {
+        // 服务采集器未初始化，直接返回失败结果
+        std::promise<ServiceOperationOutcome> promise;
+        ServiceOperationOutcome outcome;
+        outcome.serviceName = serviceName;
+        outcome.type = type;
+        outcome.result = SERVICE_OPERATION_FAILED;
+        if (callback) {
+            callback(outcome);
+        }
+        promise.set_value(outcome);
+        return promise.get_future();
     }
 
-    // 关闭服务句柄
-    CloseServiceHandle(schService);
-    // 关闭服务控制管理器句柄
-    CloseServiceHandle(schSCManager);
-    // 返回停止服务操作的结果
-    return result != 0;
+    return controller->Submit(serviceName, type,
+        [this, callback](const ServiceOperationOutcome& outcome) {
+            ApplyServiceOutcome(outcome);
+            if (callback) {
+                callback(outcome);
+            }
+        });
 }
 
+std::vector<std::future<ServiceOperationOutcome>> DataManager::ControlServicesAsync(
+    const std::vector<std::wstring>& serviceNames, ServiceOperationType type, ServiceOperationCallback callback) {
+    std::vector<std::future<ServiceOperationOutcome>> futures;
+    futures.reserve(serviceNames.size());
+    for (const auto& serviceName : serviceNames) {
+        futures.push_back(ControlServiceAsync(serviceName, type, callback));
+    }
+    return futures;
+}
 
+bool DataManager::PlanServiceOperation(const std::vector<std::wstring>& serviceNames, ServiceOperationType type,
+    ServiceOperationPlan& plan) const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    return m_serviceCollector->GetDependencyGraph().Plan(serviceNames, type, plan);
+}
 
-// 重启服务
-bool DataManager::RestartService(const std::wstring& serviceName) {
-    if (!StopService(serviceName)) {
-        return false;
+std::future<ServicePlanOutcome> DataManager::ExecuteServicePlan(const ServiceOperationPlan& plan,
+    ServiceOperationCallback stepCallback) {
+    ServiceController* controller = m_serviceCollector->GetController();
+    if (!controller) {
+        // 服务采集器未初始化，全部步骤记为失败
+        std::promise<ServicePlanOutcome> promise;
+        ServicePlanOutcome outcome;
+        for (const auto& step : plan.steps) {
+            ServiceOperationOutcome stepOutcome;
+            stepOutcome.serviceName = step.serviceName;
+            stepOutcome.type = step.type;
+            stepOutcome.result = SERVICE_OPERATION_FAILED;
+            outcome.steps.push_back(stepOutcome);
+        }
+        outcome.failedCount = outcome.steps.size();
+        promise.set_value(outcome);
+        return promise.get_future();
     }
 
-    // 等待服务停止
-    Sleep(1000);
+    return controller->SubmitPlan(plan,
+        [this, stepCallback](const ServiceOperationOutcome& outcome) {
+            ApplyServiceOutcome(outcome);
+            if (stepCallback) {
+                stepCallback(outcome);
+            }
+        });
+}
+
+void DataManager::ApplyServiceOutcome(const ServiceOperationOutcome& outcome) {
+    if (outcome.finalStatus == 0) {
+        return;
+    }
 
-    return StartTargetService(serviceName);
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    for (auto& service : m_services) {
+        if (service.serviceName == outcome.serviceName) {
+            service.status = outcome.finalStatus;
+            break;
+        }
+    }
 }
 
 
@@ -409,6 +672,12 @@ void DataManager::SetRefreshInterval(int seconds) {
     m_refreshInterval = seconds;
 }
 
+// 设置进程查询线程数
+void DataManager::SetProcessWorkerCount(size_t workerCount) {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    m_processCollector->SetWorkerCount(workerCount);
+}
+
 // 开始自动刷新
 void DataManager::StartAutoRefresh() {
     if (m_autoRefreshRunning) {
@@ -439,9 +708,117 @@ void DataManager::ManualRefresh() {
     CollectServices();
     CollectConnections();
     CollectSessions();
+    CollectDisks();
     CollectSystemInfo();
 }
 
+// 启动进程事件监听
+bool DataManager::StartProcessEvents() {
+    if (m_processEventsRunning) {
+        return true;
+    }
+    StopProcessEvents();  // 回收之前因出错而退出的事件线程
+
+    m_processEventSource = CreateProcessEventSource();
+    if (!m_processEventSource || !m_processEventSource->Initialize()) {
+        m_processEventSource.reset();
+        return false;
+    }
+
+    // 先做一次全量扫描作为事件增量更新的基准
+    CollectProcesses();
+
+    m_processEventsRunning = true;
+    m_processEventThread = new std::thread(&DataManager::ProcessEventThreadFunction, this);
+    return true;
+}
+
+// 停止进程事件监听
+void DataManager::StopProcessEvents() {
+    if (!m_processEventThread) {
+        return;
+    }
+
+    m_processEventsRunning = false;
+    if (m_processEventThread->joinable()) {
+        m_processEventThread->join();
+    }
+    delete m_processEventThread;
+    m_processEventThread = nullptr;
+
+    m_processEventSource->Cleanup();
+    m_processEventSource.reset();
+}
+
+bool DataManager::IsProcessEventsActive() const {
+    return m_processEventsRunning;
+}
+
+// 设置事件模式下进程全量扫描的校正间隔
+void DataManager::SetReconcileInterval(int seconds) {
+    m_reconcileInterval = seconds;
+}
+
+// 获取最近的进程事件
+std::vector<ProcessEvent> DataManager::GetRecentProcessEvents() const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+    return std::vector<ProcessEvent>(m_recentProcessEvents.begin(), m_recentProcessEvents.end());
+}
+
+void DataManager::SetProcessChangeCallback(std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(m_processChangeCallbackMutex);
+    m_processChangeCallback = std::move(callback);
+}
+
+// 通知进程列表已更新（调用方不得持有 m_dataMutex，回调可能立即读取数据）
+void DataManager::NotifyProcessesChanged() {
+    std::lock_guard<std::mutex> lock(m_processChangeCallbackMutex);
+    if (m_processChangeCallback) {
+        m_processChangeCallback();
+    }
+}
+
+// 进程事件线程：等待内核事件并增量更新进程列表
+void DataManager::ProcessEventThreadFunction() {
+    // 保留的最近事件数
+    const size_t maxRecentEvents = 1024;
+
+    std::vector<ProcessEvent> events;
+    while (m_processEventsRunning) {
+        events.clear();
+        // 超时较短，以便及时响应停止请求
+        if (!m_processEventSource->WaitEvents(events, 200)) {
+            std::cerr << "Process event source failed, falling back to polling." << std::endl;
+            m_processEventsRunning = false;
+            break;
+        }
+        if (events.empty()) {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+            ProcessDelta delta;
+            if (!m_processCollector->ApplyEvents(events, m_processes, delta)) {
+                continue;
+            }
+            ApplyProcessChanges(m_processes, delta);
+
+            for (auto& event : events) {
+                if (event.type == PROCESS_EVENT_LOST) {
+                    m_reconcileRequested = true;
+                    continue;
+                }
+                m_recentProcessEvents.push_back(std::move(event));
+            }
+            while (m_recentProcessEvents.size() > maxRecentEvents) {
+                m_recentProcessEvents.pop_front();
+            }
+        }
+        NotifyProcessesChanged();
+    }
+}
+
 // 过滤进程信息
 std::vector<ProcessInfo> DataManager::FilterProcesses(const std::wstring& searchText) const {
     std::lock_guard<std::mutex> lock(m_dataMutex);
@@ -521,9 +898,9 @@ void DataManager::OutputProcesses(const std::vector<ProcessInfo>& processes) con
     for (const auto& process : processList) {
         std::wcout << std::left << std::setw(8) << process.pid
             << std::setw(8) << process.parentPid
-            << std::setw(25) << process.processName.substr(0, 22)
+            << std::setw(25) << process.processName.str().substr(0, 22)
             << std::setw(20) << process.memoryUsage
-            << std::setw(20) << process.creationTime
+            << std::setw(20) << process.GetCreationTimeString().str()
             << std::endl;
     }
 }
@@ -544,7 +921,7 @@ void DataManager::OutputServices(const std::vector<ServiceInfo>& services) const
 
     for (const auto& service : serviceList) {
         std::wcout << std::left << std::setw(25) << service.serviceName.substr(0, 22)
-            << std::setw(30) << service.displayName.substr(0, 27)
+            << std::setw(30) << service.displayName.str().substr(0, 27)
             << std::setw(15) << std::to_wstring(service.status)
             << std::setw(15) << std::to_wstring(service.startType)
             << std::endl;
@@ -567,9 +944,9 @@ void DataManager::OutputConnections(const std::vector<ConnectionInfo>& connectio
 
     for (const auto& connection : connectionList) {
         std::wcout << std::left << std::setw(8) << (connection.protocol == IPPROTO_TCP ? L"TCP" : L"UDP")
-            << std::setw(25) << connection.localAddress
-            << std::setw(25) << connection.remoteAddress
-            << std::setw(15) << connection.state
+            << std::setw(25) << connection.GetLocalAddressString().str()
+            << std::setw(25) << connection.GetRemoteAddressString().str()
+            << std::setw(15) << connection.GetStateString()
             << std::setw(8) << connection.pid
             << std::endl;
     }
@@ -594,44 +971,98 @@ void DataManager::OutputSessions(const std::vector<SessionInfo>& sessions) const
         std::wcout << std::left << std::setw(10) << session.sessionId
             << std::setw(20) << session.userName
             << std::setw(20) << session.domain
-            << std::setw(20) << session.loginTime
+            << std::setw(20) << session.GetLoginTimeString()
             << std::setw(15) << std::to_wstring(session.state)
             << std::endl;
     }
 }
 
+// 输出磁盘 I/O
+void DataManager::OutputDisks(const std::vector<DiskInfo>& disks) const {
+    std::lock_guard<std::mutex> lock(m_dataMutex);
+
+    const auto& diskList = disks.empty() ? m_disks : disks;
+
+    std::wcout << std::left << std::setw(16) << L"Device"
+        << std::setw(10) << L"Read/s"
+        << std::setw(10) << L"Write/s"
+        << std::setw(12) << L"Read KB/s"
+        << std::setw(12) << L"Write KB/s"
+        << std::setw(10) << L"Await ms"
+        << std::setw(8) << L"Queue"
+        << std::setw(8) << L"Util %"
+        << std::endl;
+
+    std::wcout << std::wstring(86, L'-') << std::endl;
+
+    std::streamsize precision = std::wcout.precision(1);
+    std::wcout << std::fixed;
+    for (const auto& disk : diskList) {
+        // 读写合并的平均延迟按各自的请求数加权
+        double iops = disk.readIops + disk.writeIops;
+        double await = iops > 0.0 ? (disk.readLatencyMs * disk.readIops + disk.writeLatencyMs * disk.writeIops) / iops : 0.0;
+        std::wcout << std::left << std::setw(16) << disk.deviceName
+            << std::setw(10) << disk.readIops
+            << std::setw(10) << disk.writeIops
+            << std::setw(12) << disk.readBytesPerSec / 1024.0
+            << std::setw(12) << disk.writeBytesPerSec / 1024.0
+            << std::setw(10) << await
+            << std::setw(8) << disk.queueDepth
+            << std::setw(8) << disk.utilization
+            << std::endl;
+    }
+    std::wcout.unsetf(std::ios::floatfield);
+    std::wcout.precision(precision);
+}
+
 // 输出系统信息
 void DataManager::OutputSystemInfo() const {
     std::lock_guard<std::mutex> lock(m_dataMutex);
 
-    if (!m_systemInfo) {
+    if (!m_systemInventory) {
         std::wcout << L"系统信息未收集" << std::endl;
         return;
     }
 
-    const auto& info = *m_systemInfo;
+    const auto& info = *m_systemInventory;
+    const SystemCounters counters = GetSystemCounters();
 
     std::wcout << L"OS Version: " << info.osVersion << std::endl;
     std::wcout << L"Hostname: " << info.hostName << std::endl;
     std::wcout << L"Current User: " << info.userName << std::endl;
     std::wcout << L"System Uptime: " << info.systemUpTime << std::endl;
-    std::wcout << L"Physical Memory: " << std::to_wstring(info.totalPhysicalMemory)
-        << L" (Available: " << std::to_wstring(info.availablePhysicalMemory) << L")" << std::endl;
+    std::wcout << L"Physical Memory: " << std::to_wstring(counters.totalPhysicalMemory)
+        << L" (Available: " << std::to_wstring(counters.availablePhysicalMemory) << L")" << std::endl;
     std::wcout << L"CPU: " << info.cpuInfo << L" (" << info.cpuCores << L" cores)" << std::endl;
 }
 
 // 刷新线程函数
 void DataManager::RefreshThreadFunction() {
     while (m_autoRefreshRunning) {
-        ManualRefresh();
+        // 进程事件生效时进程列表已实时更新，全量扫描只用于定期校正或事件丢失后的补救；
+        // 其余轮次仍刷新内存与 CPU 时间，保证使用率、增长速度和子树合计不过期
+        std::chrono::steady_clock::time_point lastScan{ std::chrono::steady_clock::duration(m_lastProcessScan.load()) };
+        bool reconcileDue = std::chrono::steady_clock::now() - lastScan >= std::chrono::seconds(m_reconcileInterval);
+        bool refreshed = false;
+        if (!m_processEventsRunning || reconcileDue || m_reconcileRequested.exchange(false)) {
+            refreshed = CollectProcesses();
+        }
+        else {
+            refreshed = RefreshProcessCounters();
+        }
+        if (refreshed) {
+            NotifyProcessesChanged();
+        }
+        CollectServices();
+        CollectConnections();
+        CollectSessions();
+        CollectDisks();
+        CollectSystemInfo();
         std::this_thread::sleep_for(std::chrono::seconds(m_refreshInterval));
     }
 }
 
 std::string WideToMultiByte(const std::wstring& wstr)
 {
-    int size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), NULL, 0, NULL, NULL);
-    std::string strTo(size_needed, 0);
-    WideCharToMultiByte(CP_UTF8, 0, &wstr[0], (int)wstr.size(), &strTo[0], size_needed, NULL, NULL);
-    return strTo;
+    return WideToUtf8(wstr);
 }
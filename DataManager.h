@@ -5,29 +5,45 @@
 #include <mutex>
 #include <memory>
 #include <string>
-#include<Windows.h>
+#include "PlatformCompat.h"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
 #include <fstream>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <functional>
 //
 #include"ProcessCollector.h"
 #include"ServiceCollector.h"
 #include"NetworkCollector.h"
 #include"SessionCollector.h"
+#include"DiskCollector.h"
 #include"SystemInfoCollector.h"
+#include"SystemSampler.h"
+#include"ProcessRateCalculator.h"
+#include"ProcessTree.h"
+#include"ProcessTable.h"
+#include"ProcessIndex.h"
+#include"ConnectionTracker.h"
+#include"NetworkAggregates.h"
 // 前置声明
 struct ProcessInfo;
 struct ServiceInfo;
 struct ConnectionInfo;
 struct SessionInfo;
-struct SystemInfo;
+struct DiskInfo;
+struct SystemInventory;
+struct SystemCounters;
 
 class ProcessCollector;
 class ServiceCollector;
 class NetworkCollector;
 class SessionCollector;
+class DiskCollector;
 class SystemInfoCollector;
 std::string WideToMultiByte(const std::wstring& wstr);
 
@@ -45,27 +61,93 @@ public:
 
     // 数据收集方法
     bool CollectProcesses();
+    // 不枚举进程，只刷新现有进程的内存与 CPU 时间并更新速率、进程树与列式表；
+    // 进程事件生效时代替全量扫描按刷新间隔执行
+    bool RefreshProcessCounters();
     bool CollectServices();
     bool CollectConnections();
     bool CollectSessions();
+    // 采集块设备 I/O；速率相对上一次采集计算，调用间隔即统计窗口
+    bool CollectDisks();
+    // 采集系统信息：静态清单缺失或已失效时重新采集；动态计数器只由采样线程采样
     bool CollectSystemInfo();
+    // 使静态清单失效（如主机名或用户变化），下次 CollectSystemInfo 时重新采集
+    void InvalidateSystemInventory();
 
     // 数据获取方法
-    const std::vector<ProcessInfo>& GetProcesses() const;
-    const std::vector<ServiceInfo>& GetServices() const;
+    // 进程列表的副本：进程事件线程随时可能更新内部数据，因此在锁内复制后返回
+    std::vector<ProcessInfo> GetProcesses() const;
+    // 最近一次进程刷新相对上一次的变化（下标对应同一时刻的 GetProcesses()，按值返回）
+    ProcessDelta GetProcessDelta() const;
+    // 进程树（父子关系与子树内存、CPU 时间统计），随每次进程刷新增量更新，按值返回
+    ProcessTree GetProcessTree() const;
+    // 进程汇总（总内存、CPU 时间与使用率等），基于列式进程表计算
+    ProcessSummary GetProcessSummary() const;
+    // 按指定列取值最大的前 count 个进程
+    std::vector<ProcessInfo> GetTopProcesses(ProcessTable::Column column, size_t count) const;
+    // 按指定列排序的进程列表
+    std::vector<ProcessInfo> GetSortedProcesses(ProcessTable::Column column, bool descending) const;
+    // 按 pid 查找当前快照中的进程（O(1)），不存在时返回无效句柄；句柄在快照刷新后仍可使用
+    ProcessHandle FindProcess(DWORD pid) const;
+    // 服务列表的副本：服务操作完成时控制线程会更新其中的状态，调用方不能持有内部列表的引用
+    std::vector<ServiceInfo> GetServices() const;
+    // 最近检测到的服务配置变化（启动类型、二进制路径），按发现顺序
+    std::vector<ServiceConfigChange> GetServiceConfigChanges() const;
     const std::vector<ConnectionInfo>& GetConnections() const;
+    // 带首次/最近出现时刻与流量统计的连接列表，顺序与 GetConnections() 一致
+    std::vector<TrackedConnection> GetTrackedConnections() const;
+    // 最近关闭的连接（有界），按关闭先后排列
+    std::vector<TrackedConnection> GetClosedConnections() const;
+    // 最近的连接打开、关闭与状态变化事件，按发生顺序
+    std::vector<ConnectionEvent> GetRecentConnectionEvents() const;
+    // 连接汇总：各状态计数、连接最多的 topCount 个进程与远程网段、监听端口、状态变化趋势
+    NetworkSummary GetNetworkSummary(size_t topCount = 10) const;
     const std::vector<SessionInfo>& GetSessions() const;
-    const SystemInfo& GetSystemInfo() const;
+    // 各块设备最近一个采集间隔内的 IOPS、吞吐、平均延迟与队列深度（按值返回）
+    std::vector<DiskInfo> GetDisks() const;
+    // 静态清单（操作系统、主机名、CPU 型号与核心数等，按值返回），尚未采集时返回空清单
+    SystemInventory GetSystemInventory() const;
+    // 采样线程最近一个样本的动态计数器（按值返回），尚无样本时各项为 0
+    SystemCounters GetSystemCounters() const;
 	const double GetCpuUsage() const;
+    // 最近两个样本之间的换页、主缺页速率与内存停顿占比
+    MemoryRates GetMemoryRates() const;
+    // 采样线程：以固定间隔（不小于 100ms，默认 1 秒）采样系统计数器，界面隐藏时照常运行
+    void SetSystemSampleInterval(std::chrono::milliseconds interval);
+    std::chrono::milliseconds GetSystemSampleInterval() const;
+    // 每个读者创建自己的游标，逐个读取新样本；落后超过缓冲区容量时跳过被覆盖的样本（计入 cursor.dropped）
+    SystemSampler::Cursor CreateSystemSampleCursor(bool fromOldest = false) const;
+    bool ReadSystemSample(SystemSampler::Cursor& cursor, SystemSample& sample) const;
+    // 最新的样本，与 GetCpuUsage、GetMemoryRates 使用的样本一致；尚无样本时返回 false
+    bool GetLatestSystemSample(SystemSample& sample) const;
+    // 最近至多 count 个样本，按时间顺序
+    size_t GetSystemSampleHistory(size_t count, std::vector<SystemSample>& samples) const;
+    // 采样线程最近两个逐核样本之间各逻辑处理器的使用率（按 cpuId 升序），多处调用互不干扰；
+    // 写入调用方的缓冲区以复用其容量
+    void GetCpuCoreUsage(std::vector<CpuCoreUsage>& usage) const;
 
     // 进程操作
     bool TerminateTargetProcessByPid(DWORD pid);
     bool TerminateTargetProcessByName(const std::string& processName);
 
-    // 服务操作
+    // 服务操作（同步）：等待服务到达目标状态或超时，会阻塞调用线程
     bool StartTargetService(const std::wstring& serviceName);
     bool StopService(const std::wstring& serviceName);
     bool RestartService(const std::wstring& serviceName);
+    // 服务操作（异步）：立即返回；完成时先在锁内更新服务列表中该服务的状态，再在控制线程上调用 callback，
+    // 界面需自行把 callback 转到界面线程
+    std::future<ServiceOperationOutcome> ControlServiceAsync(const std::wstring& serviceName,
+        ServiceOperationType type, ServiceOperationCallback callback = nullptr);
+    // 批量提交，不同服务的操作并发执行
+    std::vector<std::future<ServiceOperationOutcome>> ControlServicesAsync(const std::vector<std::wstring>& serviceNames,
+        ServiceOperationType type, ServiceOperationCallback callback = nullptr);
+    // 按最近一次采集的依赖图生成操作计划（停止/重启会连带未停止的依赖方，启动会连带未运行的依赖）；
+    // 服务不存在或涉及依赖环时返回 false
+    bool PlanServiceOperation(const std::vector<std::wstring>& serviceNames, ServiceOperationType type,
+        ServiceOperationPlan& plan) const;
+    // 异步执行计划，互不依赖的分支并发执行；每个步骤完成后更新服务状态并调用 stepCallback
+    std::future<ServicePlanOutcome> ExecuteServicePlan(const ServiceOperationPlan& plan,
+        ServiceOperationCallback stepCallback = nullptr);
 
     // 数据导出
     //bool ExportProcessesToCSV(const std::wstring& filePath) const;
@@ -73,10 +155,25 @@ public:
 
     // 刷新设置
     void SetRefreshInterval(int seconds);
+    // 设置并行查询进程详情的线程数
+    void SetProcessWorkerCount(size_t workerCount);
     void StartAutoRefresh();
     void StopAutoRefresh();
     void ManualRefresh();
 
+    // 进程事件：启用后由内核推送进程创建/退出并增量更新进程列表，
+    // 自动刷新时进程全量扫描降为每 reconcileInterval 秒一次的校正。平台不支持或无权限时返回 false
+    bool StartProcessEvents();
+    void StopProcessEvents();
+    bool IsProcessEventsActive() const;
+    void SetReconcileInterval(int seconds);
+    // 最近的进程事件（含已退出的短命进程），按发生顺序
+    std::vector<ProcessEvent> GetRecentProcessEvents() const;
+    // 后台线程（进程事件线程、自动刷新线程）更新进程列表后调用 callback，调用时不持有数据锁。
+    // callback 在后台线程上执行，界面只应在其中发出排队信号；传入空函数注销，
+    // 注销会等待正在执行的回调结束，之后可以安全销毁回调引用的对象
+    void SetProcessChangeCallback(std::function<void()> callback);
+
     // 数据过滤
     std::vector<ProcessInfo> FilterProcesses(const std::wstring& searchText) const;
     std::vector<ServiceInfo> FilterServices(const std::wstring& searchText) const;
@@ -86,6 +183,7 @@ public:
     void OutputServices(const std::vector<ServiceInfo>& services = {}) const;
     void OutputConnections(const std::vector<ConnectionInfo>& connections = {}) const;
     void OutputSessions(const std::vector<SessionInfo>& sessions = {}) const;
+    void OutputDisks(const std::vector<DiskInfo>& disks = {}) const;
     void OutputSystemInfo() const;
 
 private:
@@ -99,17 +197,31 @@ private:
 
     // 数据存储
     std::vector<ProcessInfo> m_processes;
+    ProcessDelta m_processDelta;
+    ProcessTree m_processTree;
+    ProcessTable m_processTable;     // m_processes 数值字段的列式副本
+    ProcessIndex m_processIndex;     // pid -> m_processes 下标
     std::vector<ServiceInfo> m_services;
+    std::deque<ServiceConfigChange> m_serviceConfigChanges;
     std::vector<ConnectionInfo> m_connections;
+    std::vector<ConnectionStats> m_connectionStats;   // 与 m_connections 下标对应，含收发速率
+    ConnectionTracker m_connectionTracker;
+    NetworkAggregates m_networkAggregates;   // 由连接事件增量维护
+    std::deque<ConnectionEvent> m_recentConnectionEvents;
     std::vector<SessionInfo> m_sessions;
-    std::unique_ptr<SystemInfo> m_systemInfo;
+    std::vector<DiskInfo> m_disks;
+    std::unique_ptr<SystemInventory> m_systemInventory;
+    std::atomic<bool> m_systemInventoryInvalid{ true };
 
     // 收集器
     std::unique_ptr<ProcessCollector> m_processCollector;
     std::unique_ptr<ServiceCollector> m_serviceCollector;
     std::unique_ptr<NetworkCollector> m_networkCollector;
     std::unique_ptr<SessionCollector> m_sessionCollector;
+    std::unique_ptr<DiskCollector> m_diskCollector;
     std::unique_ptr<SystemInfoCollector> m_systemInfoCollector;
+    std::unique_ptr<SystemSampler> m_systemSampler;   // 使用独立的数据源，不经过 m_dataMutex
+    ProcessRateCalculator m_processRates;
 
     // 刷新设置
     int m_refreshInterval;
@@ -123,4 +235,21 @@ private:
 
     // 刷新线程函数
     void RefreshThreadFunction();
+
+    // 进程事件
+    void ProcessEventThreadFunction();
+    void ApplyProcessChanges(std::vector<ProcessInfo>& processes, ProcessDelta& delta);
+    void NotifyProcessesChanged();
+    // 服务操作完成后按最终状态更新 m_services，无需等待下一次全量刷新
+    void ApplyServiceOutcome(const ServiceOperationOutcome& outcome);
+
+    std::unique_ptr<IProcessEventSource> m_processEventSource;
+    std::thread* m_processEventThread;
+    std::atomic<bool> m_processEventsRunning;
+    std::atomic<bool> m_reconcileRequested;     // 事件丢失时要求立即全量扫描
+    int m_reconcileInterval;
+    std::atomic<std::chrono::steady_clock::rep> m_lastProcessScan;  // 最近一次全量扫描时刻（steady_clock 计数）
+    std::deque<ProcessEvent> m_recentProcessEvents;
+    std::function<void()> m_processChangeCallback;
+    std::mutex m_processChangeCallbackMutex;   // 回调执行期间持有，注销时据此等待
 };
\ No newline at end of file
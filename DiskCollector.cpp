@@ -0,0 +1,90 @@
+﻿// DiskCollector.cpp
+#include "DiskCollector.h"
+#include <algorithm>
+#include <iostream>
+
+DiskCollector::DiskCollector() : m_source(CreateDiskSource()), m_initialized(false) {}
+
+DiskCollector::DiskCollector(std::unique_ptr<IDiskSource> source)
+    : m_source(std::move(source)), m_initialized(false) {}
+
+DiskCollector::~DiskCollector() {
+    Cleanup();
+}
+
+bool DiskCollector::Initialize() {
+    m_initialized = m_source && m_source->Initialize();
+    return m_initialized;
+}
+
+void DiskCollector::Cleanup() {
+    if (m_source) {
+        m_source->Cleanup();
+    }
+    m_initialized = false;
+    m_current.clear();
+    m_previous.clear();
+    m_previousIndex.clear();
+}
+
+// 计数回退（设备重置，不应发生）时视为 0
+static ULONGLONG Delta(ULONGLONG current, ULONGLONG previous) {
+    return current >= previous ? current - previous : 0;
+}
+
+bool DiskCollector::CollectDisks(std::vector<DiskInfo>& disks) {
+    if (!m_initialized) {
+        return false;
+    }
+
+    m_currentTime = std::chrono::steady_clock::now();
+    if (!m_source->QueryDiskCounters(m_current)) {
+        return false;
+    }
+
+    // 间隔（100 纳秒）；首次采样时为 0，速率全部为 0
+    double interval = m_previous.empty() ? 0.0
+        : std::chrono::duration<double, std::ratio<1, 10000000>>(m_currentTime - m_previousTime).count();
+    double seconds = interval / 10000000.0;
+
+    disks.resize(m_current.size());
+    for (size_t i = 0; i < m_current.size(); ++i) {
+        const DiskCounters& current = m_current[i];
+        DiskInfo& disk = disks[i];
+        disk = DiskInfo();
+        disk.deviceName = current.deviceName;
+        disk.inFlight = current.inFlight;
+        disk.bytesRead = current.bytesRead;
+        disk.bytesWritten = current.bytesWritten;
+
+        auto it = m_previousIndex.find(current.deviceName);
+        if (seconds <= 0.0 || it == m_previousIndex.end()) {
+            continue;
+        }
+        const DiskCounters& previous = m_previous[it->second];
+
+        ULONGLONG reads = Delta(current.readsCompleted, previous.readsCompleted);
+        ULONGLONG writes = Delta(current.writesCompleted, previous.writesCompleted);
+        disk.readIops = reads / seconds;
+        disk.writeIops = writes / seconds;
+        disk.readBytesPerSec = Delta(current.bytesRead, previous.bytesRead) / seconds;
+        disk.writeBytesPerSec = Delta(current.bytesWritten, previous.bytesWritten) / seconds;
+        if (reads > 0) {
+            disk.readLatencyMs = Delta(current.readTime, previous.readTime) / 10000.0 / reads;
+        }
+        if (writes > 0) {
+            disk.writeLatencyMs = Delta(current.writeTime, previous.writeTime) / 10000.0 / writes;
+        }
+        disk.queueDepth = Delta(current.weightedIoTime, previous.weightedIoTime) / interval;
+        disk.utilization = (std::min)(100.0, Delta(current.busyTime, previous.busyTime) * 100.0 / interval);
+    }
+
+    // 本次计数成为下一次的基准；交换缓冲区以复用设备名字符串的容量
+    m_previous.swap(m_current);
+    m_previousTime = m_currentTime;
+    m_previousIndex.clear();
+    for (size_t i = 0; i < m_previous.size(); ++i) {
+        m_previousIndex.emplace(m_previous[i].deviceName, i);
+    }
+    return true;
+}
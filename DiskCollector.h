@@ -0,0 +1,63 @@
+﻿// DiskCollector.h
+#pragma once
+#include "PlatformCompat.h"
+#include "DiskSource.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 块设备自开机以来的累计计数；时间均为 100 纳秒
+struct DiskCounters {
+    std::wstring deviceName;
+    ULONGLONG readsCompleted = 0;
+    ULONGLONG writesCompleted = 0;
+    ULONGLONG bytesRead = 0;
+    ULONGLONG bytesWritten = 0;
+    ULONGLONG readTime = 0;          // 已完成读请求的耗时之和
+    ULONGLONG writeTime = 0;
+    ULONGLONG busyTime = 0;          // 设备上至少有一个请求的时间
+    ULONGLONG weightedIoTime = 0;    // 每个请求排队与处理时间之和，除以间隔即平均队列深度
+    DWORD inFlight = 0;              // 采样时刻未完成的请求数
+};
+
+// 两次采样之间的磁盘活动
+struct DiskInfo {
+    std::wstring deviceName;
+    double readIops = 0.0;
+    double writeIops = 0.0;
+    double readBytesPerSec = 0.0;
+    double writeBytesPerSec = 0.0;
+    double readLatencyMs = 0.0;      // 间隔内完成的读请求的平均耗时
+    double writeLatencyMs = 0.0;
+    double queueDepth = 0.0;         // 间隔内的平均队列深度
+    double utilization = 0.0;        // 忙碌时间占比（%）
+    DWORD inFlight = 0;
+    ULONGLONG bytesRead = 0;         // 累计值，供显示总量
+    ULONGLONG bytesWritten = 0;
+};
+
+class DiskCollector {
+public:
+    DiskCollector();
+    // 使用指定的数据源（便于替换平台实现或注入测试数据）
+    explicit DiskCollector(std::unique_ptr<IDiskSource> source);
+    ~DiskCollector();
+
+    bool Initialize();
+    void Cleanup();
+
+    // 采样并计算相对上一次调用的速率；首次调用或新出现的设备速率为 0
+    bool CollectDisks(std::vector<DiskInfo>& disks);
+
+private:
+    std::unique_ptr<IDiskSource> m_source;
+    bool m_initialized;
+
+    std::vector<DiskCounters> m_current;
+    std::vector<DiskCounters> m_previous;
+    std::unordered_map<std::wstring, size_t> m_previousIndex;   // 设备名 -> m_previous 下标
+    std::chrono::steady_clock::time_point m_currentTime;
+    std::chrono::steady_clock::time_point m_previousTime;
+};
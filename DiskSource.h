@@ -0,0 +1,23 @@
+﻿// DiskSource.h
+#pragma once
+#include "PlatformCompat.h"
+#include <memory>
+#include <vector>
+
+struct DiskCounters;
+
+// 块设备 I/O 计数数据源接口 - 屏蔽各平台的磁盘性能计数实现
+// Windows 实现见 DiskSourceWin.cpp（IOCTL_DISK_PERFORMANCE），Linux 实现见 DiskSourceLinux.cpp（/proc/diskstats）
+class IDiskSource {
+public:
+    virtual ~IDiskSource() = default;
+
+    virtual bool Initialize() = 0;
+    virtual void Cleanup() = 0;
+
+    // 查询每个物理块设备的累计计数（不含分区）；实现应复用 disks 中已有元素的容量
+    virtual bool QueryDiskCounters(std::vector<DiskCounters>& disks) = 0;
+};
+
+// 创建当前平台的默认磁盘数据源
+std::unique_ptr<IDiskSource> CreateDiskSource();
@@ -0,0 +1,145 @@
+﻿// DiskSourceLinux.cpp
+// Linux 磁盘数据源：/proc/diskstats，只保留 /sys/block 下的整盘设备（不含分区），跳过从未有过 I/O 的设备
+#ifdef __linux__
+#include "DiskCollector.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+
+class LinuxDiskSource : public IDiskSource {
+public:
+    ~LinuxDiskSource() override { Cleanup(); }
+
+    bool Initialize() override;
+    void Cleanup() override;
+
+    bool QueryDiskCounters(std::vector<DiskCounters>& disks) override;
+
+private:
+    bool IsWholeDisk(const std::string& name);
+
+    int m_diskStatsFd = -1;
+    std::vector<char> m_buffer = std::vector<char>(8192);   // 读不完整时加倍后重读
+    std::unordered_map<std::string, bool> m_wholeDisk;      // 设备名 -> 是否整盘，避免每次采样访问 sysfs
+    std::string m_name;
+};
+
+bool LinuxDiskSource::Initialize() {
+    if (m_diskStatsFd < 0) {
+        m_diskStatsFd = open("/proc/diskstats", O_RDONLY | O_CLOEXEC);
+    }
+    return m_diskStatsFd >= 0;
+}
+
+void LinuxDiskSource::Cleanup() {
+    if (m_diskStatsFd >= 0) {
+        close(m_diskStatsFd);
+        m_diskStatsFd = -1;
+    }
+    m_wholeDisk.clear();
+}
+
+// 分区没有 /sys/block/<name> 目录；名称中的 '/' 在 sysfs 中写作 '!'
+bool LinuxDiskSource::IsWholeDisk(const std::string& name) {
+    auto it = m_wholeDisk.find(name);
+    if (it != m_wholeDisk.end()) {
+        return it->second;
+    }
+    std::string path = "/sys/block/" + name;
+    std::replace(path.begin() + 11, path.end(), '/', '!');
+    bool wholeDisk = access(path.c_str(), F_OK) == 0;
+    m_wholeDisk.emplace(name, wholeDisk);
+    return wholeDisk;
+}
+
+// 跳过空白后解析十进制整数
+static ULONGLONG ParseUnsigned(const char*& cursor) {
+    while (*cursor == ' ' || *cursor == '\t') {
+        ++cursor;
+    }
+    ULONGLONG value = 0;
+    while (*cursor >= '0' && *cursor <= '9') {
+        value = value * 10 + static_cast<ULONGLONG>(*cursor - '0');
+        ++cursor;
+    }
+    return value;
+}
+
+// 每行："major minor name reads merged sectors readMs writes merged sectors writeMs inFlight ioMs weightedMs ..."
+// 扇区固定按 512 字节计，时间单位为毫秒
+bool LinuxDiskSource::QueryDiskCounters(std::vector<DiskCounters>& disks) {
+    if (m_diskStatsFd < 0) {
+        return false;
+    }
+
+    ssize_t length = 0;
+    for (;;) {
+        length = pread(m_diskStatsFd, m_buffer.data(), m_buffer.size() - 1, 0);
+        if (length < 0) {
+            return false;
+        }
+        if (static_cast<size_t>(length) < m_buffer.size() - 1) {
+            break;
+        }
+        m_buffer.resize(m_buffer.size() * 2);
+    }
+    m_buffer[length] = '\0';
+
+    size_t count = 0;
+    for (const char* line = m_buffer.data(); *line;) {
+        const char* cursor = line;
+        ParseUnsigned(cursor);   // major
+        ParseUnsigned(cursor);   // minor
+        while (*cursor == ' ') {
+            ++cursor;
+        }
+        const char* nameEnd = cursor;
+        while (*nameEnd && *nameEnd != ' ' && *nameEnd != '\n') {
+            ++nameEnd;
+        }
+        m_name.assign(cursor, nameEnd);
+        cursor = nameEnd;
+
+        ULONGLONG fields[11];
+        for (ULONGLONG& value : fields) {
+            value = ParseUnsigned(cursor);
+        }
+        ULONGLONG reads = fields[0], readSectors = fields[2], readMs = fields[3];
+        ULONGLONG writes = fields[4], writeSectors = fields[6], writeMs = fields[7];
+        ULONGLONG inFlight = fields[8], ioMs = fields[9], weightedMs = fields[10];
+
+        if (!m_name.empty() && reads + writes > 0 && IsWholeDisk(m_name)) {
+            if (count == disks.size()) {
+                disks.emplace_back();
+            }
+            DiskCounters& disk = disks[count++];
+            disk.deviceName.assign(m_name.begin(), m_name.end());
+            disk.readsCompleted = reads;
+            disk.writesCompleted = writes;
+            disk.bytesRead = readSectors * 512;
+            disk.bytesWritten = writeSectors * 512;
+            disk.readTime = readMs * 10000;
+            disk.writeTime = writeMs * 10000;
+            disk.busyTime = ioMs * 10000;
+            disk.weightedIoTime = weightedMs * 10000;
+            disk.inFlight = static_cast<DWORD>(inFlight);
+        }
+
+        const char* next = strchr(cursor, '\n');
+        if (!next) {
+            break;
+        }
+        line = next + 1;
+    }
+    disks.resize(count);
+    return true;
+}
+
+std::unique_ptr<IDiskSource> CreateDiskSource() {
+    return std::make_unique<LinuxDiskSource>();
+}
+
+#endif // __linux__
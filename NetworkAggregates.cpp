@@ -0,0 +1,138 @@
+﻿// NetworkAggregates.cpp
+#include "NetworkAggregates.h"
+#include <algorithm>
+#include <cstring>
+
+InternedString RemotePrefix::ToString() const {
+    BYTE address[16] = {};
+    memcpy(address, &bits, sizeof(bits));
+    bool ipv6 = family == ADDRESS_FAMILY_IPV6;
+    return FormatPrefixCached(ipv6, address, ipv6 ? 64 : 24);
+}
+
+// 未连接的端点（监听、UDP）远程地址全为 0，不计入远程网段
+static bool MakeRemotePrefix(const ConnectionInfo& connection, RemotePrefix& prefix) {
+    size_t addressSize = connection.IsIpv6() ? 16 : 4;
+    bool unspecified = true;
+    for (size_t i = 0; i < addressSize; ++i) {
+        if (connection.remoteAddress[i] != 0) {
+            unspecified = false;
+            break;
+        }
+    }
+    if (unspecified) {
+        return false;
+    }
+
+    prefix.bits = 0;
+    memcpy(&prefix.bits, connection.remoteAddress, connection.IsIpv6() ? 8 : 3);
+    prefix.family = connection.family;
+    return true;
+}
+
+// 按 delta（+1/-1）调整连接所在各分组的计数，计数归零的分组删除
+template <typename Map, typename Key>
+static void AdjustCounts(Map& map, const Key& key, ConnectionState state, int delta) {
+    ConnectionCounts& counts = map[key];
+    counts.total += delta;
+    counts.byState[state] += delta;
+    if (counts.total == 0) {
+        map.erase(key);
+    }
+}
+
+void NetworkAggregates::Add(const ConnectionInfo& connection, ConnectionState state, int delta) {
+    m_stateCounts.total += delta;
+    m_stateCounts.byState[state] += delta;
+
+    AdjustCounts(m_byPid, connection.pid, state, delta);
+
+    RemotePrefix prefix;
+    if (MakeRemotePrefix(connection, prefix)) {
+        AdjustCounts(m_byRemote, prefix, state, delta);
+    }
+
+    DWORD portKey = (static_cast<DWORD>(connection.protocol) << 16) | connection.localPort;
+    ListenPortCounts& port = m_byLocalPort[portKey];
+    port.protocol = connection.protocol;
+    port.port = connection.localPort;
+    if (state == CONNECTION_STATE_LISTEN) {
+        port.listeners += delta;
+    }
+    else {
+        port.connections += delta;
+    }
+    if (port.listeners == 0 && port.connections == 0) {
+        m_byLocalPort.erase(portKey);
+    }
+}
+
+void NetworkAggregates::Apply(const std::vector<ConnectionEvent>& events, ULONGLONG now) {
+    for (const auto& event : events) {
+        const ConnectionInfo& connection = event.tracked.connection;
+        switch (event.type) {
+        case CONNECTION_EVENT_OPENED:
+            Add(connection, connection.state, 1);
+            break;
+        case CONNECTION_EVENT_CLOSED:
+            Add(connection, connection.state, -1);
+            break;
+        case CONNECTION_EVENT_STATE_CHANGED:
+            Add(connection, event.previousState, -1);
+            Add(connection, connection.state, 1);
+            break;
+        }
+    }
+
+    ConnectionStateSample sample;
+    sample.timestamp = now;
+    memcpy(sample.byState, m_stateCounts.byState, sizeof(sample.byState));
+    m_history.push_back(sample);
+    while (m_history.size() > m_maxHistory) {
+        m_history.pop_front();
+    }
+}
+
+// 分组数远少于连接数，只对前 count 个分组排序
+template <typename Map>
+static std::vector<std::pair<typename Map::key_type, ConnectionCounts>> TopGroups(const Map& map, size_t count) {
+    std::vector<std::pair<typename Map::key_type, ConnectionCounts>> groups(map.begin(), map.end());
+    count = std::min(count, groups.size());
+    std::partial_sort(groups.begin(), groups.begin() + count, groups.end(),
+        [](const auto& a, const auto& b) { return a.second.total > b.second.total; });
+    groups.resize(count);
+    return groups;
+}
+
+std::vector<std::pair<DWORD, ConnectionCounts>> NetworkAggregates::TopProcesses(size_t count) const {
+    return TopGroups(m_byPid, count);
+}
+
+std::vector<std::pair<RemotePrefix, ConnectionCounts>> NetworkAggregates::TopRemotePrefixes(size_t count) const {
+    return TopGroups(m_byRemote, count);
+}
+
+std::vector<ListenPortCounts> NetworkAggregates::ListeningPorts() const {
+    std::vector<ListenPortCounts> ports;
+    for (const auto& pair : m_byLocalPort) {
+        if (pair.second.listeners > 0) {
+            ports.push_back(pair.second);
+        }
+    }
+    std::sort(ports.begin(), ports.end(), [](const ListenPortCounts& a, const ListenPortCounts& b) {
+        return a.connections != b.connections ? a.connections > b.connections : a.port < b.port;
+    });
+    return ports;
+}
+
+std::vector<ConnectionStateSample> NetworkAggregates::GetStateHistory() const {
+    return std::vector<ConnectionStateSample>(m_history.begin(), m_history.end());
+}
+
+void NetworkAggregates::Reset() {
+    m_stateCounts = ConnectionCounts();
+    m_byPid.clear();
+    m_byRemote.clear();
+    m_byLocalPort.clear();
+    m_history.clear();
+}
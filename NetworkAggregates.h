@@ -0,0 +1,84 @@
+﻿// NetworkAggregates.h
+#pragma once
+#include "ConnectionTracker.h"
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+// 按状态分类的连接计数
+struct ConnectionCounts {
+    DWORD total = 0;
+    DWORD byState[CONNECTION_STATE_DELETE_TCB + 1] = {};
+
+    DWORD Get(ConnectionState state) const { return byState[state]; }
+};
+
+// 远程网段：IPv4 取 /24，IPv6 取 /64
+struct RemotePrefix {
+    ULONGLONG bits = 0;          // 网段前缀的原始字节（网络字节序，不足 8 字节时高位补 0）
+    AddressFamily family = ADDRESS_FAMILY_IPV4;
+
+    bool operator==(const RemotePrefix& other) const { return bits == other.bits && family == other.family; }
+    InternedString ToString() const;
+};
+
+struct RemotePrefixHash {
+    size_t operator()(const RemotePrefix& prefix) const {
+        return std::hash<ULONGLONG>()(prefix.bits * 0x9E3779B97F4A7C15ULL + prefix.family);
+    }
+};
+
+// 监听端口：监听套接字数与使用该本地端口的其他连接数（通常为入站连接）
+struct ListenPortCounts {
+    BYTE protocol = 0;
+    WORD port = 0;
+    DWORD listeners = 0;
+    DWORD connections = 0;
+};
+
+// 一次刷新后各状态的连接数，用于观察 TIME_WAIT 等状态的变化趋势
+struct ConnectionStateSample {
+    ULONGLONG timestamp = 0;     // FILETIME 计数
+    DWORD byState[CONNECTION_STATE_DELETE_TCB + 1] = {};
+};
+
+// 汇总视图（DataManager::GetNetworkSummary 的返回值）
+struct NetworkSummary {
+    ConnectionCounts stateCounts;
+    std::vector<std::pair<DWORD, ConnectionCounts>> topProcesses;
+    std::vector<std::pair<RemotePrefix, ConnectionCounts>> topRemotePrefixes;
+    std::vector<ListenPortCounts> listeningPorts;
+    std::vector<ConnectionStateSample> stateHistory;
+};
+
+// 网络连接汇总：由 ConnectionTracker 的打开、关闭、状态变化事件增量维护按进程、
+// 按远程网段、按本地端口、按状态的计数，刷新时无需重新遍历连接表。
+// 计数归零的分组立即删除，表的大小不超过活动连接数
+class NetworkAggregates {
+public:
+    // 应用一次刷新产生的连接事件，并记录一个状态采样（now 为 FILETIME 计数）
+    void Apply(const std::vector<ConnectionEvent>& events, ULONGLONG now);
+
+    const ConnectionCounts& GetStateCounts() const { return m_stateCounts; }
+
+    // 连接数最多的前 count 个进程 / 远程网段，按总数降序
+    std::vector<std::pair<DWORD, ConnectionCounts>> TopProcesses(size_t count) const;
+    std::vector<std::pair<RemotePrefix, ConnectionCounts>> TopRemotePrefixes(size_t count) const;
+    // 有监听套接字的本地端口，按连接数降序
+    std::vector<ListenPortCounts> ListeningPorts() const;
+    // 最近的状态采样，按时间先后排列
+    std::vector<ConnectionStateSample> GetStateHistory() const;
+
+    void SetMaxHistory(size_t maxHistory) { m_maxHistory = maxHistory; }
+    void Reset();
+
+private:
+    void Add(const ConnectionInfo& connection, ConnectionState state, int delta);
+
+    ConnectionCounts m_stateCounts;
+    std::unordered_map<DWORD, ConnectionCounts> m_byPid;
+    std::unordered_map<RemotePrefix, ConnectionCounts, RemotePrefixHash> m_byRemote;
+    std::unordered_map<DWORD, ListenPortCounts> m_byLocalPort;   // (协议 << 16) | 端口
+    std::deque<ConnectionStateSample> m_history;
+    size_t m_maxHistory = 120;
+};
@@ -1,18 +1,18 @@
-// NetworkCollector.cpp
+﻿// NetworkCollector.cpp
 #include "NetworkCollector.h"
 
-NetworkCollector::NetworkCollector() : m_initialized(false) {}
+NetworkCollector::NetworkCollector()
+    : m_source(CreateNetworkSource()), m_initialized(false), m_stateMask(CONNECTION_STATES_ALL) {}
+
+NetworkCollector::NetworkCollector(std::unique_ptr<INetworkSource> source)
+    : m_source(std::move(source)), m_initialized(false), m_stateMask(CONNECTION_STATES_ALL) {}
 
 NetworkCollector::~NetworkCollector() {
     Cleanup();
 }
 
-//  NetworkCollector  Initialize 
 bool NetworkCollector::Initialize() {
-    WSADATA wsaData;
-    // ʼ Winsock 2.2 汾
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-        // 
+    if (!m_source || !m_source->Initialize()) {
         return false;
     }
     m_initialized = true;
@@ -21,50 +21,26 @@ bool NetworkCollector::Initialize() {
 
 void NetworkCollector::Cleanup() {
     if (m_initialized) {
-        WSACleanup();
+        m_source->Cleanup();
         m_initialized = false;
     }
 }
 
-// IPv4ַתΪַ
-std::wstring FormatIpAddress(DWORD ipAddress) {
-    char ipStr[46] = { 0 }; // 㹻洢IPv6ַ
-    wchar_t ipWide[64] = { 0 };
-
-    // תIPַΪַ
-    inet_ntop(AF_INET, &ipAddress, ipStr, sizeof(ipStr));
-
-    // תΪַ
-    int len = MultiByteToWideChar(CP_UTF8, 0, ipStr, -1, ipWide, _countof(ipWide));
-    if (len > 0) {
-        return std::wstring(ipWide);
-    }
-
-    return L"0.0.0.0";
-}
-
-// ʽַͶ˿
-std::wstring FormatAddressAndPort(DWORD ipAddress, u_short port) {
-    std::wostringstream oss;
-    oss << FormatIpAddress(ipAddress) << L":" << ntohs(port);
-    return oss.str();
-}
-
-// ȡTCP״̬Ŀַʾ
-std::wstring GetTcpStateDescription(DWORD state) {
+const wchar_t* ConnectionStateToString(ConnectionState state) {
     switch (state) {
-    case MIB_TCP_STATE_CLOSED: return L"Closed";
-    case MIB_TCP_STATE_LISTEN: return L"Listening";
-    case MIB_TCP_STATE_SYN_SENT: return L"SYN Sent";
-    case MIB_TCP_STATE_SYN_RCVD: return L"SYN Received";
-    case MIB_TCP_STATE_ESTAB: return L"Established";
-    case MIB_TCP_STATE_FIN_WAIT1: return L"FIN_WAIT1";
-    case MIB_TCP_STATE_FIN_WAIT2: return L"FIN_WAIT2";
-    case MIB_TCP_STATE_CLOSE_WAIT: return L"CLOSE_WAIT";
-    case MIB_TCP_STATE_CLOSING: return L"CLOSING";
-    case MIB_TCP_STATE_LAST_ACK: return L"LAST_ACK";
-    case MIB_TCP_STATE_TIME_WAIT: return L"TIME_WAIT";
-    default: return L"Unknown";
+    case CONNECTION_STATE_CLOSED: return L"CLOSED";
+    case CONNECTION_STATE_LISTEN: return L"LISTENING";
+    case CONNECTION_STATE_SYN_SENT: return L"SYN_SENT";
+    case CONNECTION_STATE_SYN_RECEIVED: return L"SYN_RECV";
+    case CONNECTION_STATE_ESTABLISHED: return L"ESTABLISHED";
+    case CONNECTION_STATE_FIN_WAIT1: return L"FIN_WAIT1";
+    case CONNECTION_STATE_FIN_WAIT2: return L"FIN_WAIT2";
+    case CONNECTION_STATE_CLOSE_WAIT: return L"CLOSE_WAIT";
+    case CONNECTION_STATE_CLOSING: return L"CLOSING";
+    case CONNECTION_STATE_LAST_ACK: return L"LAST_ACK";
+    case CONNECTION_STATE_TIME_WAIT: return L"TIME_WAIT";
+    case CONNECTION_STATE_DELETE_TCB: return L"DELETE_TCB";
+    default: return L"UNKNOWN";
     }
 }
 
@@ -74,71 +50,30 @@ bool NetworkCollector::CollectConnections(std::vector<ConnectionInfo>& connectio
     }
 
     connections.clear();
+    return m_source->EnumerateConnections(connections, nullptr, m_stateMask);
+}
 
-    // ȡTCP
-    DWORD size = 0;
-    if (GetExtendedTcpTable(NULL, &size, FALSE, AF_INET, TCP_TABLE_OWNER_PID_ALL, 0) != ERROR_INSUFFICIENT_BUFFER) {
-        std::cerr << "Failed to get TCP table size. Error: " << GetLastError() << std::endl;
-        return false;
-    }
-
-    std::vector<unsigned char> buffer(size);
-    MIB_TCPTABLE_OWNER_PID* tcpTable = reinterpret_cast<MIB_TCPTABLE_OWNER_PID*>(buffer.data());
-
-    if (GetExtendedTcpTable(tcpTable, &size, FALSE, AF_INET, TCP_TABLE_OWNER_PID_ALL, 0) != NO_ERROR) {
-        std::cerr << "Failed to get TCP table. Error: " << GetLastError() << std::endl;
-        return false;
-    }
-
-    for (DWORD i = 0; i < tcpTable->dwNumEntries; ++i) {
-        MIB_TCPROW_OWNER_PID row = tcpTable->table[i];
-
-        ConnectionInfo conn;
-        conn.protocol = IPPROTO_TCP;
-        conn.localAddress = FormatAddressAndPort(row.dwLocalAddr, row.dwLocalPort);
-
-        // ʽԶ̵ַ
-        if (row.dwRemoteAddr == 0) {
-            conn.remoteAddress = L"0.0.0.0:0";
-        }
-        else {
-            conn.remoteAddress = FormatAddressAndPort(row.dwRemoteAddr, row.dwRemotePort);
-        }
-
-        // ״̬
-        conn.state = GetTcpStateDescription(row.dwState);
-        conn.pid = row.dwOwningPid;
-
-        connections.push_back(conn);
-    }
-
-    // ȡUDP
-    size = 0;
-    if (GetExtendedUdpTable(NULL, &size, FALSE, AF_INET, UDP_TABLE_OWNER_PID, 0) != ERROR_INSUFFICIENT_BUFFER) {
-        std::cerr << "Failed to get UDP table size. Error: " << GetLastError() << std::endl;
+bool NetworkCollector::CollectConnections(std::vector<ConnectionInfo>& connections, std::vector<ConnectionStats>& stats) {
+    if (!m_initialized) {
         return false;
     }
 
-    buffer.resize(size);
-    MIB_UDPTABLE_OWNER_PID* udpTable = reinterpret_cast<MIB_UDPTABLE_OWNER_PID*>(buffer.data());
-
-    if (GetExtendedUdpTable(udpTable, &size, FALSE, AF_INET, UDP_TABLE_OWNER_PID, 0) != NO_ERROR) {
-        std::cerr << "Failed to get UDP table. Error: " << GetLastError() << std::endl;
+    connections.clear();
+    stats.clear();
+    if (!m_source->EnumerateConnections(connections, &stats, m_stateMask)) {
         return false;
     }
+    // 数据源未提供统计时补齐为 0，保证下标对应
+    stats.resize(connections.size());
+    return true;
+}
 
-    for (DWORD i = 0; i < udpTable->dwNumEntries; ++i) {
-        MIB_UDPROW_OWNER_PID row = udpTable->table[i];
-
-        ConnectionInfo conn;
-        conn.protocol = IPPROTO_UDP;
-        conn.localAddress = FormatAddressAndPort(row.dwLocalAddr, row.dwLocalPort);
-        conn.remoteAddress = L"0.0.0.0:0";
-        conn.state = L"Listening";
-        conn.pid = row.dwOwningPid;
-
-        connections.push_back(conn);
+void NetworkCollector::OnProcessesChanged(const std::vector<DWORD>& pids) {
+    if (m_source && !pids.empty()) {
+        m_source->InvalidateProcesses(pids);
     }
+}
 
-    return true;
-}
\ No newline at end of file
+void NetworkCollector::SetStateFilter(DWORD stateMask) {
+    m_stateMask = stateMask & CONNECTION_STATES_ALL;
+}
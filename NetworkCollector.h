@@ -1,45 +1,105 @@
-#ifndef NETWORKCOLLECTOR_H
+﻿#ifndef NETWORKCOLLECTOR_H
 #define NETWORKCOLLECTOR_H
 
+#include "PlatformCompat.h"
+#include "NetworkSource.h"
+#include "ValueFormatter.h"
 
-#define WIN32_LEAN_AND_MEAN
-
-#include <Windows.h>
+#ifdef _WIN32
 #include <WinSock2.h>
-#include <iphlpapi.h>
-#include <ws2tcpip.h>
-#include <locale>
-#include <codecvt>
+#else
+#include <netinet/in.h>
+#endif
+
 #include <vector>
 #include <string>
-#include <iostream>
-#include <sstream>
+#include <memory>
+
 
-#pragma comment(lib, "iphlpapi.lib")
-#pragma comment(lib, "ws2_32.lib")
 
+// 地址族（与平台的 AF_INET/AF_INET6 取值无关）
+enum AddressFamily : BYTE {
+    ADDRESS_FAMILY_IPV4 = 4,
+    ADDRESS_FAMILY_IPV6 = 6
+};
+
+// TCP 连接状态，取值与 Windows 的 MIB_TCP_STATE 一致；UDP 端点记为 LISTEN
+enum ConnectionState : BYTE {
+    CONNECTION_STATE_UNKNOWN = 0,
+    CONNECTION_STATE_CLOSED = 1,
+    CONNECTION_STATE_LISTEN = 2,
+    CONNECTION_STATE_SYN_SENT = 3,
+    CONNECTION_STATE_SYN_RECEIVED = 4,
+    CONNECTION_STATE_ESTABLISHED = 5,
+    CONNECTION_STATE_FIN_WAIT1 = 6,
+    CONNECTION_STATE_FIN_WAIT2 = 7,
+    CONNECTION_STATE_CLOSE_WAIT = 8,
+    CONNECTION_STATE_CLOSING = 9,
+    CONNECTION_STATE_LAST_ACK = 10,
+    CONNECTION_STATE_TIME_WAIT = 11,
+    CONNECTION_STATE_DELETE_TCB = 12
+};
 
+// 状态的显示文本（如 L"ESTABLISHED"），返回静态字符串
+const wchar_t* ConnectionStateToString(ConnectionState state);
 
+// 连接状态过滤掩码，按 ConnectionState 取位组合；UDP 端点对应 LISTEN 位
+inline DWORD ConnectionStateMask(ConnectionState state) { return 1u << state; }
+constexpr DWORD CONNECTION_STATES_ALL = 0x1FFF;
+
+// 定长 POD 连接记录，不含任何堆内存；地址、状态的文本仅在显示时生成
 struct ConnectionInfo {
-    int protocol; // IPPROTO_TCP or IPPROTO_UDP
-    std::wstring localAddress;
-    std::wstring remoteAddress;
-    std::wstring state;
+    BYTE localAddress[16];     // 网络字节序，IPv4 只使用前 4 字节
+    BYTE remoteAddress[16];
+    WORD localPort;            // 主机字节序
+    WORD remotePort;
     DWORD pid;
+    BYTE protocol;             // IPPROTO_TCP 或 IPPROTO_UDP
+    AddressFamily family;
+    ConnectionState state;
+
+    bool IsIpv6() const { return family == ADDRESS_FAMILY_IPV6; }
+
+    // "地址:端口" 显示文本，显示时才格式化
+    InternedString GetLocalAddressString() const { return FormatEndpointCached(IsIpv6(), localAddress, localPort); }
+    InternedString GetRemoteAddressString() const { return FormatEndpointCached(IsIpv6(), remoteAddress, remotePort); }
+    const wchar_t* GetStateString() const { return ConnectionStateToString(state); }
+};
+
+// 连接的流量与时延统计，与 ConnectionInfo 分开存放（下标一一对应），保持连接记录紧凑。
+// 目前由 Linux 后端的 TCP 连接提供，其他情况全部为 0
+struct ConnectionStats {
+    ULONGLONG bytesSent = 0;         // 累计发送并已被确认的字节数
+    ULONGLONG bytesReceived = 0;     // 累计接收字节数
+    DWORD retransmits = 0;           // 累计重传报文数
+    DWORD rttMicroseconds = 0;       // 平滑 RTT（微秒）
+    double sendRate = 0.0;           // 字节/秒，由 ConnectionTracker 根据上一次采样计算
+    double receiveRate = 0.0;
 };
 
 class NetworkCollector {
 public:
     NetworkCollector();
+    // 使用指定的数据源（便于替换平台实现或注入测试数据）
+    explicit NetworkCollector(std::unique_ptr<INetworkSource> source);
     ~NetworkCollector();
 
     bool Initialize();
     void Cleanup();
 
     bool CollectConnections(std::vector<ConnectionInfo>& connections);
+    // 同时采集流量统计，stats 与 connections 下标对应（同一次转储内完成）
+    bool CollectConnections(std::vector<ConnectionInfo>& connections, std::vector<ConnectionStats>& stats);
+    // 只采集指定状态的连接（ConnectionStateMask 组合），默认 CONNECTION_STATES_ALL
+    void SetStateFilter(DWORD stateMask);
+    DWORD GetStateFilter() const { return m_stateMask; }
+    // 根据进程变化使相关进程的套接字归属失效（见 SocketOwnerIndex）
+    void OnProcessesChanged(const std::vector<DWORD>& pids);
 
 private:
+    std::unique_ptr<INetworkSource> m_source;
     bool m_initialized;
+    DWORD m_stateMask;
 };
 
-#endif // NETWORKCOLLECTOR_H
\ No newline at end of file
+#endif // NETWORKCOLLECTOR_H
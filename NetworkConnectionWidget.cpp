@@ -1,5 +1,5 @@
 ﻿// networkconnectionwidget.cpp
-#include "networkconnectionwidget.h"
+#include "NetworkConnectionWidget.h"
 
 // 协议类型转换（数字转文本）
 QString protocolToString(int protocol) {
@@ -16,7 +16,10 @@ NetworkConnectionWidget::NetworkConnectionWidget(QWidget* parent) :
     m_model(nullptr),
     m_refreshBtn(nullptr),
     m_statusLabel(nullptr),
-    m_filterCombo(nullptr)
+    m_filterCombo(nullptr),
+    m_stateSummaryLabel(nullptr),
+    m_summaryView(nullptr),
+    m_summaryModel(nullptr)
 {
     initUI();
     onRefreshButtonClicked(); // 初始化时加载数据
@@ -37,10 +40,10 @@ public:
             QStyleOptionViewItem opt = option;
 
             // 根据协议设置行背景色
-            if (protocol == "TCP") {
+            if (protocol.startsWith("TCP")) {
                 opt.backgroundBrush = QBrush(QColor(220, 230, 241)); // 浅蓝色
             }
-            else if (protocol == "UDP") {
+            else if (protocol.startsWith("UDP")) {
                 opt.backgroundBrush = QBrush(QColor(232, 245, 233)); // 浅绿色
             }
 
@@ -67,7 +70,7 @@ void NetworkConnectionWidget::initUI() {
 
     // 过滤下拉框
     m_filterCombo = new QComboBox(this);
-    m_filterCombo->addItems({ "全部连接", "TCP连接", "UDP连接" });
+    m_filterCombo->addItems({ "全部连接", "TCP连接", "UDP连接", "最近关闭" });
     connect(m_filterCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
         this, &NetworkConnectionWidget::onFilterChanged);
     controlLayout->addWidget(m_filterCombo);
@@ -75,9 +78,10 @@ void NetworkConnectionWidget::initUI() {
     controlLayout->addStretch(); // 填充剩余空间
 
     // 初始化表格模型
-    m_model = new QStandardItemModel(0, 6, this);
+    m_model = new QStandardItemModel(0, 11, this);
     m_model->setHorizontalHeaderLabels({
-        "协议", "本地地址", "远程地址", "状态", "PID", "进程名称"
+        "协议", "本地地址", "远程地址", "状态", "持续时间(s)",
+        "发送(KB/s)", "接收(KB/s)", "重传", "RTT(ms)", "PID", "进程名称"
         });
 
     // 初始化表格视图
@@ -98,12 +102,33 @@ void NetworkConnectionWidget::initUI() {
     // 设置垂直滚动条策略
     m_tableView->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
 
+    // 汇总面板
+    QGroupBox* summaryGroup = new QGroupBox("连接汇总", this);
+    QVBoxLayout* summaryLayout = new QVBoxLayout(summaryGroup);
+    m_stateSummaryLabel = new QLabel(summaryGroup);
+    m_stateSummaryLabel->setWordWrap(true);
+    m_summaryModel = new QStandardItemModel(0, 4, this);
+    m_summaryModel->setHorizontalHeaderLabels({ "分组", "连接数", "ESTABLISHED", "TIME_WAIT" });
+    m_summaryView = new QTreeView(summaryGroup);
+    m_summaryView->setModel(m_summaryModel);
+    m_summaryView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_summaryView->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    summaryLayout->addWidget(m_stateSummaryLabel);
+    summaryLayout->addWidget(m_summaryView);
+
+    // 连接表在上，汇总面板在下，可拖动调整高度
+    QSplitter* splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(m_tableView);
+    splitter->addWidget(summaryGroup);
+    splitter->setStretchFactor(0, 3);
+    splitter->setStretchFactor(1, 1);
+
     // 状态栏
     m_statusLabel = new QLabel("就绪", this);
 
     // 组装布局
     mainLayout->addLayout(controlLayout);
-    mainLayout->addWidget(m_tableView);
+    mainLayout->addWidget(splitter);
     mainLayout->addWidget(m_statusLabel);
 
     setLayout(mainLayout);
@@ -113,42 +138,44 @@ void NetworkConnectionWidget::refreshTable() {
     // 清空表格
     m_model->removeRows(0, m_model->rowCount());
 
-    // 获取网络连接数据
-    const std::vector<ConnectionInfo>& connections = DataManager::GetInstance().GetConnections();
+    // 过滤选项
+    int filterIndex = m_filterCombo->currentIndex();
+    bool showClosed = filterIndex == 3;
+
+    // 获取网络连接数据（附带首次/最近出现时刻）
+    std::vector<TrackedConnection> connections = showClosed
+        ? DataManager::GetInstance().GetClosedConnections()
+        : DataManager::GetInstance().GetTrackedConnections();
     if (connections.empty()) {
-        updateStatus("未发现网络连接");
+        updateStatus(showClosed ? "暂无已关闭的连接" : "未发现网络连接");
         return;
     }
 
-    // 获取进程列表（用于关联PID到进程名）
-    const std::vector<ProcessInfo>& processes = DataManager::GetInstance().GetProcesses();
-    std::map<DWORD, std::wstring> pidToName;
-    for (const auto& proc : processes) {
-        pidToName[proc.pid] = proc.processName;
-    }
-
-    // 过滤选项
-    int filterIndex = m_filterCombo->currentIndex();
-
     // 填充表格
     int displayedCount = 0;
-    for (const auto& conn : connections) {
+    for (const auto& tracked : connections) {
+        const ConnectionInfo& conn = tracked.connection;
+
         // 应用过滤
         if (filterIndex == 1 && conn.protocol != IPPROTO_TCP) continue; // 只显示TCP
         if (filterIndex == 2 && conn.protocol != IPPROTO_UDP) continue; // 只显示UDP
 
-        // 获取进程名
+        // 获取进程名（经 DataManager 的 pid 索引关联）
         QString processName = "[未知]";
-        auto it = pidToName.find(conn.pid);
-        if (it != pidToName.end()) {
-            processName = QString::fromStdWString(it->second);
+        ProcessHandle process = DataManager::GetInstance().FindProcess(conn.pid);
+        if (process.IsValid()) {
+            processName = QString::fromStdWString(process.processName);
         }
 
         // 创建表格行（带格式设置）
         QList<QStandardItem*> items;
 
         // 1. 协议列（行颜色区分）
-        QStandardItem* protoItem = new QStandardItem(protocolToString(conn.protocol));
+        QString protocolText = protocolToString(conn.protocol);
+        if (conn.IsIpv6()) {
+            protocolText += "v6";
+        }
+        QStandardItem* protoItem = new QStandardItem(protocolText);
         if (conn.protocol == IPPROTO_TCP) {
             protoItem->setBackground(QColor(220, 230, 241)); // 浅蓝色
         }
@@ -158,44 +185,77 @@ void NetworkConnectionWidget::refreshTable() {
         items << protoItem;
 
         // 2. 本地地址列（长地址截断+提示）
-        QString localAddr = QString::fromStdWString(conn.localAddress);
+        QString localAddr = QString::fromStdWString(conn.GetLocalAddressString());
         QStandardItem* localAddrItem = new QStandardItem(truncateAddress(localAddr,30));
         localAddrItem->setToolTip(localAddr); // 完整地址提示
         items << localAddrItem;
 
         // 3. 远程地址列（长地址截断+提示）
-        QString remoteAddr = QString::fromStdWString(conn.remoteAddress);
+        QString remoteAddr = QString::fromStdWString(conn.GetRemoteAddressString());
         QStandardItem* remoteAddrItem = new QStandardItem(truncateAddress(remoteAddr,30));
         remoteAddrItem->setToolTip(remoteAddr); // 完整地址提示
         items << remoteAddrItem;
 
         // 4. 状态列（颜色标记）
-        QStandardItem* stateItem = new QStandardItem(QString::fromStdWString(conn.state));
-        QString state = QString::fromStdWString(conn.state);
-        if (state == "ESTABLISHED") {
+        // 直接按状态枚举着色，不依赖显示文本的大小写
+        QStandardItem* stateItem = new QStandardItem(QString::fromWCharArray(conn.GetStateString()));
+        switch (conn.state) {
+        case CONNECTION_STATE_ESTABLISHED:
             stateItem->setForeground(QColor(0, 120, 215)); // 蓝色
-        }
-        else if (state == "LISTENING") {
+            break;
+        case CONNECTION_STATE_LISTEN:
             stateItem->setForeground(QColor(0, 177, 89)); // 绿色
-        }
-        else if (state == "CLOSE_WAIT") {
+            break;
+        case CONNECTION_STATE_CLOSE_WAIT:
             stateItem->setForeground(QColor(247, 150, 70)); // 橙色
-        }
-        else if (state == "TIME_WAIT") {
+            break;
+        case CONNECTION_STATE_TIME_WAIT:
             stateItem->setForeground(QColor(160, 80, 0)); // 棕色
-        }
-        else if (state == "CLOSED") {
+            break;
+        case CONNECTION_STATE_CLOSED:
             stateItem->setForeground(QColor(160, 160, 160)); // 灰色
-        }
-        else if (state == "SYN_SENT" || state == "SYN_RECV") {
+            break;
+        case CONNECTION_STATE_SYN_SENT:
+        case CONNECTION_STATE_SYN_RECEIVED:
             stateItem->setForeground(QColor(255, 59, 48)); // 红色
+            break;
+        default:
+            break;
         }
         items << stateItem;
 
-        // 5. PID列
+        // 5. 持续时间列（首次到最近一次出现，按数值排序）
+        QStandardItem* durationItem = new QStandardItem();
+        durationItem->setData(qRound(tracked.GetDurationSeconds()), Qt::DisplayRole);
+        durationItem->setToolTip(QString("首次出现 %1\n最近出现 %2")
+            .arg(QString::fromStdWString(tracked.GetFirstSeenString()))
+            .arg(QString::fromStdWString(tracked.GetLastSeenString())));
+        items << durationItem;
+
+        // 6-9. 流量统计列（数值型，可按吞吐量排序），累计字节数见提示
+        const ConnectionStats& stats = tracked.stats;
+        QStandardItem* sendItem = new QStandardItem();
+        sendItem->setData(qRound(stats.sendRate / 1024.0 * 10) / 10.0, Qt::DisplayRole);
+        sendItem->setToolTip(QString("累计发送 %1 KB").arg(stats.bytesSent / 1024));
+        items << sendItem;
+
+        QStandardItem* receiveItem = new QStandardItem();
+        receiveItem->setData(qRound(stats.receiveRate / 1024.0 * 10) / 10.0, Qt::DisplayRole);
+        receiveItem->setToolTip(QString("累计接收 %1 KB").arg(stats.bytesReceived / 1024));
+        items << receiveItem;
+
+        QStandardItem* retransItem = new QStandardItem();
+        retransItem->setData(static_cast<qulonglong>(stats.retransmits), Qt::DisplayRole);
+        items << retransItem;
+
+        QStandardItem* rttItem = new QStandardItem();
+        rttItem->setData(stats.rttMicroseconds / 1000.0, Qt::DisplayRole);
+        items << rttItem;
+
+        // 10. PID列
         items << new QStandardItem(QString::number(conn.pid));
 
-        // 6. 进程名列
+        // 11. 进程名列
         items << new QStandardItem(processName);
 
         // 设置所有单元格不可编辑
@@ -209,11 +269,82 @@ void NetworkConnectionWidget::refreshTable() {
     }
 
     // 更新状态栏
-    updateStatus(QString("共 %1 个网络连接，显示 %2 个")
+    updateStatus(QString(showClosed ? "最近关闭 %1 个网络连接，显示 %2 个" : "共 %1 个网络连接，显示 %2 个")
         .arg(connections.size())
         .arg(displayedCount));
 }
 
+// 汇总面板：数据来自 DataManager 增量维护的汇总表，不遍历连接列表
+void NetworkConnectionWidget::refreshSummary() {
+    NetworkSummary summary = DataManager::GetInstance().GetNetworkSummary(10);
+
+    // 各状态连接数（只列出非零状态），TIME_WAIT 附带相对最早采样的变化
+    QStringList stateTexts;
+    for (int state = CONNECTION_STATE_CLOSED; state <= CONNECTION_STATE_DELETE_TCB; ++state) {
+        DWORD count = summary.stateCounts.byState[state];
+        if (count == 0) {
+            continue;
+        }
+        QString text = QString("%1: %2")
+            .arg(QString::fromWCharArray(ConnectionStateToString(static_cast<ConnectionState>(state))))
+            .arg(count);
+        if (state == CONNECTION_STATE_TIME_WAIT && summary.stateHistory.size() > 1) {
+            long long change = static_cast<long long>(count) - summary.stateHistory.front().byState[state];
+            text += QString("（%1 次刷新内 %2%3）")
+                .arg(summary.stateHistory.size() - 1)
+                .arg(change >= 0 ? "+" : "")
+                .arg(change);
+        }
+        stateTexts << text;
+    }
+    m_stateSummaryLabel->setText(stateTexts.isEmpty()
+        ? QString("暂无连接")
+        : QString("共 %1 个连接　").arg(summary.stateCounts.total) + stateTexts.join("　"));
+
+    // 分组行：名称、总数、ESTABLISHED 数、TIME_WAIT 数
+    auto appendGroupRow = [](QStandardItem* parent, const QString& name, DWORD total, DWORD established, DWORD timeWait) {
+        QList<QStandardItem*> row;
+        row << new QStandardItem(name);
+        for (DWORD value : { total, established, timeWait }) {
+            QStandardItem* item = new QStandardItem();
+            item->setData(static_cast<qulonglong>(value), Qt::DisplayRole);
+            row << item;
+        }
+        parent->appendRow(row);
+    };
+
+    m_summaryModel->removeRows(0, m_summaryModel->rowCount());
+
+    QStandardItem* processGroup = new QStandardItem("按进程");
+    m_summaryModel->appendRow(processGroup);
+    for (const auto& pair : summary.topProcesses) {
+        ProcessHandle process = DataManager::GetInstance().FindProcess(pair.first);
+        QString name = process.IsValid() ? QString::fromStdWString(process.processName) : QString("[未知]");
+        appendGroupRow(processGroup, QString("%1 (%2)").arg(name).arg(pair.first), pair.second.total,
+            pair.second.Get(CONNECTION_STATE_ESTABLISHED), pair.second.Get(CONNECTION_STATE_TIME_WAIT));
+    }
+
+    QStandardItem* remoteGroup = new QStandardItem("按远程网段");
+    m_summaryModel->appendRow(remoteGroup);
+    for (const auto& pair : summary.topRemotePrefixes) {
+        appendGroupRow(remoteGroup, QString::fromStdWString(pair.first.ToString()), pair.second.total,
+            pair.second.Get(CONNECTION_STATE_ESTABLISHED), pair.second.Get(CONNECTION_STATE_TIME_WAIT));
+    }
+
+    QStandardItem* portGroup = new QStandardItem("按监听端口");
+    m_summaryModel->appendRow(portGroup);
+    for (const auto& port : summary.listeningPorts) {
+        // 端口分组只统计连接总数，状态列留空
+        QStandardItem* nameItem = new QStandardItem(QString("%1 %2").arg(protocolToString(port.protocol)).arg(port.port));
+        nameItem->setToolTip(QString("监听套接字 %1 个").arg(port.listeners));
+        QStandardItem* countItem = new QStandardItem();
+        countItem->setData(static_cast<qulonglong>(port.connections), Qt::DisplayRole);
+        portGroup->appendRow({ nameItem, countItem, new QStandardItem(), new QStandardItem() });
+    }
+
+    m_summaryView->expandAll();
+}
+
 // 辅助方法：截断过长的地址
 QString NetworkConnectionWidget::truncateAddress(const QString& address, int maxLength=30) {
     if (address.length() <= maxLength) {
@@ -251,6 +382,7 @@ void NetworkConnectionWidget::onRefreshButtonClicked() {
 
     // 刷新表格
     refreshTable();
+    refreshSummary();
 }
 
 void NetworkConnectionWidget::onFilterChanged(int index) {
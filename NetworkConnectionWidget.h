@@ -14,8 +14,11 @@
 #include<QComboBox>
 #include<QStyledItemDelegate>
 #include <QPainter>  // 添加这一行
+#include <QTreeView>
+#include <QSplitter>
+#include <QGroupBox>
 
-#include "datamanager.h" // 包含DataManager头文件
+#include "DataManager.h" // 包含DataManager头文件
 
 // 网络连接Widget
 class NetworkConnectionWidget : public QWidget {
@@ -31,6 +34,7 @@ private slots:
 private:
     void initUI(); // 初始化UI
     void refreshTable();
+    void refreshSummary(); // 刷新汇总面板
     QString truncateAddress(const QString& address, int maxLength);
     // 刷新表格数据
     void updateStatus(const QString& text); // 更新状态栏
@@ -40,6 +44,11 @@ private:
     QPushButton* m_refreshBtn; // 刷新按钮
     QLabel* m_statusLabel; // 状态栏
     QComboBox* m_filterCombo; // 过滤下拉框
+
+    // 汇总面板：按状态计数，以及按进程、远程网段、监听端口分组的连接数
+    QLabel* m_stateSummaryLabel;
+    QTreeView* m_summaryView;
+    QStandardItemModel* m_summaryModel;
 };
 
 #endif // NETWORKCONNECTIONWIDGET_H
\ No newline at end of file
@@ -0,0 +1,30 @@
+﻿// NetworkSource.h
+#pragma once
+#include "PlatformCompat.h"
+#include <memory>
+#include <vector>
+
+struct ConnectionInfo;
+struct ConnectionStats;
+
+// 网络连接数据源接口 - 屏蔽各平台的连接表获取实现
+// Windows 实现见 NetworkSourceWin.cpp（IP Helper），Linux 实现见 NetworkSourceLinux.cpp（netlink sock_diag）
+class INetworkSource {
+public:
+    virtual ~INetworkSource() = default;
+
+    virtual bool Initialize() = 0;
+    virtual void Cleanup() = 0;
+
+    // 枚举 TCP/UDP 连接，只追加状态在 stateMask（ConnectionStateMask 组合）中的连接；
+    // 平台支持时应在内核侧过滤，避免复制不需要的记录。
+    // stats 非空时在同一次枚举中追加流量统计（与 connections 下标对应），不支持的平台可以不填
+    virtual bool EnumerateConnections(std::vector<ConnectionInfo>& connections,
+        std::vector<ConnectionStats>* stats, DWORD stateMask) = 0;
+
+    // 通知进程启动、退出或更换映像，需要重新关联这些进程的套接字（连接表不含 PID 的平台使用）
+    virtual void InvalidateProcesses(const std::vector<DWORD>& pids) = 0;
+};
+
+// 创建当前平台的默认网络连接数据源
+std::unique_ptr<INetworkSource> CreateNetworkSource();
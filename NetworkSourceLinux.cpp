@@ -0,0 +1,250 @@
+﻿// NetworkSourceLinux.cpp
+// Linux 网络连接数据源：netlink sock_diag (inet_diag) 转储 TCP/UDP 套接字，
+// 状态在内核侧过滤，结果直接写入定长连接记录；TCP 流量统计取自同一次转储附带的 tcp_info；
+// PID 由增量维护的套接字 inode 索引关联
+#ifdef __linux__
+#include "NetworkCollector.h"
+#include "SocketOwnerIndex.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#include <linux/tcp.h>
+
+class LinuxNetworkSource : public INetworkSource {
+public:
+    LinuxNetworkSource() : m_socket(-1), m_sequence(0) {}
+    ~LinuxNetworkSource() override { Cleanup(); }
+
+    bool Initialize() override;
+    void Cleanup() override;
+
+    bool EnumerateConnections(std::vector<ConnectionInfo>& connections,
+        std::vector<ConnectionStats>* stats, DWORD stateMask) override;
+    void InvalidateProcesses(const std::vector<DWORD>& pids) override;
+
+private:
+    bool Dump(BYTE family, BYTE protocol, DWORD kernelStates,
+        std::vector<ConnectionInfo>& connections, std::vector<ConnectionStats>* stats);
+    void ParseMessage(const nlmsghdr* header, BYTE protocol,
+        std::vector<ConnectionInfo>& connections, std::vector<ConnectionStats>* stats) const;
+
+    int m_socket;
+    DWORD m_sequence;
+    std::vector<char> m_buffer;         // 接收缓冲区，在多次转储间复用
+    SocketOwnerIndex m_socketOwners;    // 套接字 inode -> pid
+};
+
+// Linux TCP 状态（include/net/tcp_states.h，从 1 开始）到 ConnectionState 的映射
+static const ConnectionState kLinuxTcpStates[] = {
+    CONNECTION_STATE_UNKNOWN,
+    CONNECTION_STATE_ESTABLISHED,   // TCP_ESTABLISHED
+    CONNECTION_STATE_SYN_SENT,      // TCP_SYN_SENT
+    CONNECTION_STATE_SYN_RECEIVED,  // TCP_SYN_RECV
+    CONNECTION_STATE_FIN_WAIT1,     // TCP_FIN_WAIT1
+    CONNECTION_STATE_FIN_WAIT2,     // TCP_FIN_WAIT2
+    CONNECTION_STATE_TIME_WAIT,     // TCP_TIME_WAIT
+    CONNECTION_STATE_CLOSED,        // TCP_CLOSE
+    CONNECTION_STATE_CLOSE_WAIT,    // TCP_CLOSE_WAIT
+    CONNECTION_STATE_LAST_ACK,      // TCP_LAST_ACK
+    CONNECTION_STATE_LISTEN,        // TCP_LISTEN
+    CONNECTION_STATE_CLOSING,       // TCP_CLOSING
+    CONNECTION_STATE_SYN_RECEIVED   // TCP_NEW_SYN_RECV（半连接请求）
+};
+static const int kLinuxTcpStateCount = sizeof(kLinuxTcpStates) / sizeof(kLinuxTcpStates[0]);
+
+// 将 ConnectionState 掩码换算为 inet_diag 请求中的内核状态位图
+static DWORD ToKernelStates(DWORD stateMask) {
+    DWORD kernelStates = 0;
+    for (int state = 1; state < kLinuxTcpStateCount; ++state) {
+        if (stateMask & ConnectionStateMask(kLinuxTcpStates[state])) {
+            kernelStates |= 1u << state;
+        }
+    }
+    return kernelStates;
+}
+
+bool LinuxNetworkSource::Initialize() {
+    if (m_socket >= 0) {
+        return true;
+    }
+
+    m_socket = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (m_socket < 0) {
+        std::cerr << "Failed to open sock_diag netlink socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // 单条转储消息不超过一页，多条合并后不超过 32KB，留出余量
+    m_buffer.resize(64 * 1024);
+    return true;
+}
+
+void LinuxNetworkSource::Cleanup() {
+    if (m_socket >= 0) {
+        close(m_socket);
+        m_socket = -1;
+    }
+}
+
+// UDP 端点统一记为 LISTEN，未选择该状态时不转储 UDP
+bool LinuxNetworkSource::EnumerateConnections(std::vector<ConnectionInfo>& connections,
+    std::vector<ConnectionStats>* stats, DWORD stateMask) {
+    if (m_socket < 0) {
+        return false;
+    }
+
+    m_socketOwners.Refresh();
+
+    DWORD tcpStates = ToKernelStates(stateMask);
+    if (tcpStates) {
+        if (!Dump(AF_INET, IPPROTO_TCP, tcpStates, connections, stats) ||
+            !Dump(AF_INET6, IPPROTO_TCP, tcpStates, connections, stats)) {
+            return false;
+        }
+    }
+
+    if (stateMask & ConnectionStateMask(CONNECTION_STATE_LISTEN)) {
+        const DWORD allStates = 0xFFFFFFFF;
+        if (!Dump(AF_INET, IPPROTO_UDP, allStates, connections, stats) ||
+            !Dump(AF_INET6, IPPROTO_UDP, allStates, connections, stats)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 发送一次 SOCK_DIAG_BY_FAMILY 转储请求，边接收边解析；需要统计时 TCP 请求附带 tcp_info
+bool LinuxNetworkSource::Dump(BYTE family, BYTE protocol, DWORD kernelStates,
+    std::vector<ConnectionInfo>& connections, std::vector<ConnectionStats>* stats) {
+    struct {
+        nlmsghdr header;
+        inet_diag_req_v2 request;
+    } message;
+    memset(&message, 0, sizeof(message));
+    message.header.nlmsg_len = sizeof(message);
+    message.header.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    message.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    message.header.nlmsg_seq = ++m_sequence;
+    message.request.sdiag_family = family;
+    message.request.sdiag_protocol = protocol;
+    message.request.idiag_states = kernelStates;
+    if (stats && protocol == IPPROTO_TCP) {
+        message.request.idiag_ext = 1 << (INET_DIAG_INFO - 1);
+    }
+
+    sockaddr_nl kernel;
+    memset(&kernel, 0, sizeof(kernel));
+    kernel.nl_family = AF_NETLINK;
+
+    if (sendto(m_socket, &message, sizeof(message), 0,
+        reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel)) < 0) {
+        std::cerr << "sock_diag request failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    for (;;) {
+        ssize_t length = recv(m_socket, m_buffer.data(), m_buffer.size(), 0);
+        if (length < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "sock_diag receive failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        int remaining = static_cast<int>(length);
+        for (const nlmsghdr* header = reinterpret_cast<const nlmsghdr*>(m_buffer.data());
+            NLMSG_OK(header, remaining); header = NLMSG_NEXT(header, remaining)) {
+            // 跳过此前中断的转储遗留的应答
+            if (header->nlmsg_seq != m_sequence) {
+                continue;
+            }
+            if (header->nlmsg_type == NLMSG_DONE) {
+                return true;
+            }
+            if (header->nlmsg_type == NLMSG_ERROR) {
+                const nlmsgerr* error = static_cast<const nlmsgerr*>(NLMSG_DATA(header));
+                // 内核未加载对应协议的 diag 模块（如 udp_diag）时视为没有连接
+                if (error->error == -ENOENT) {
+                    return true;
+                }
+                std::cerr << "sock_diag dump failed: " << strerror(-error->error) << std::endl;
+                return false;
+            }
+            if (header->nlmsg_type == SOCK_DIAG_BY_FAMILY &&
+                header->nlmsg_len >= NLMSG_LENGTH(sizeof(inet_diag_msg))) {
+                ParseMessage(header, protocol, connections, stats);
+            }
+        }
+    }
+}
+
+void LinuxNetworkSource::ParseMessage(const nlmsghdr* header, BYTE protocol,
+    std::vector<ConnectionInfo>& connections, std::vector<ConnectionStats>* stats) const {
+    const inet_diag_msg& msg = *static_cast<const inet_diag_msg*>(NLMSG_DATA(header));
+    ConnectionInfo conn = {};
+    conn.protocol = protocol;
+    conn.family = msg.idiag_family == AF_INET6 ? ADDRESS_FAMILY_IPV6 : ADDRESS_FAMILY_IPV4;
+
+    size_t addressSize = conn.IsIpv6() ? 16 : 4;
+    memcpy(conn.localAddress, msg.id.idiag_src, addressSize);
+    memcpy(conn.remoteAddress, msg.id.idiag_dst, addressSize);
+    conn.localPort = ntohs(msg.id.idiag_sport);
+    conn.remotePort = ntohs(msg.id.idiag_dport);
+
+    if (protocol == IPPROTO_UDP) {
+        conn.state = CONNECTION_STATE_LISTEN;
+    }
+    else {
+        conn.state = msg.idiag_state < kLinuxTcpStateCount ? kLinuxTcpStates[msg.idiag_state] : CONNECTION_STATE_UNKNOWN;
+    }
+
+    // TIME_WAIT 等已脱离进程的套接字 inode 为 0，无法关联进程
+    conn.pid = msg.idiag_inode ? m_socketOwners.FindOwner(msg.idiag_inode) : 0;
+
+    connections.push_back(conn);
+
+    if (!stats) {
+        return;
+    }
+
+    // 属性紧跟在 inet_diag_msg 之后；旧内核的 tcp_info 较短，缺少的字段按 0 处理
+    ConnectionStats connStats;
+    int attributeLength = static_cast<int>(header->nlmsg_len - NLMSG_LENGTH(sizeof(inet_diag_msg)));
+    for (const rtattr* attribute = reinterpret_cast<const rtattr*>(&msg + 1);
+        RTA_OK(attribute, attributeLength); attribute = RTA_NEXT(attribute, attributeLength)) {
+        if (attribute->rta_type != INET_DIAG_INFO) {
+            continue;
+        }
+        tcp_info info;
+        memset(&info, 0, sizeof(info));
+        size_t size = RTA_PAYLOAD(attribute) < sizeof(info) ? RTA_PAYLOAD(attribute) : sizeof(info);
+        memcpy(&info, RTA_DATA(attribute), size);
+
+        connStats.bytesSent = info.tcpi_bytes_acked;
+        connStats.bytesReceived = info.tcpi_bytes_received;
+        connStats.retransmits = info.tcpi_total_retrans;
+        connStats.rttMicroseconds = info.tcpi_rtt;
+        break;
+    }
+    stats->push_back(connStats);
+}
+
+void LinuxNetworkSource::InvalidateProcesses(const std::vector<DWORD>& pids) {
+    for (DWORD pid : pids) {
+        m_socketOwners.Invalidate(pid);
+    }
+}
+
+std::unique_ptr<INetworkSource> CreateNetworkSource() {
+    return std::make_unique<LinuxNetworkSource>();
+}
+
+#endif // __linux__
@@ -0,0 +1,128 @@
+﻿// PlatformCompat.cpp
+#include "PlatformCompat.h"
+#include <cwchar>
+#include <ctime>
+
+std::wstring FormatFileTime(const FILETIME& ft) {
+    wchar_t buffer[26];
+#ifdef _WIN32
+    SYSTEMTIME st;
+    FileTimeToSystemTime(&ft, &st);
+
+    swprintf_s(buffer, L"%04d-%02d-%02d %02d:%02d:%02d",
+        st.wYear, st.wMonth, st.wDay,
+        st.wHour, st.wMinute, st.wSecond);
+#else
+    ULONGLONG value = FileTimeToUInt64(ft);
+    time_t seconds = value > kUnixEpochInFileTime
+        ? static_cast<time_t>((value - kUnixEpochInFileTime) / 10000000ULL)
+        : 0;
+
+    struct tm st;
+    gmtime_r(&seconds, &st);
+
+    swprintf(buffer, sizeof(buffer) / sizeof(buffer[0]), L"%04d-%02d-%02d %02d:%02d:%02d",
+        st.tm_year + 1900, st.tm_mon + 1, st.tm_mday,
+        st.tm_hour, st.tm_min, st.tm_sec);
+#endif
+    return std::wstring(buffer);
+}
+
+#ifdef _WIN32
+
+std::wstring Utf8ToWide(const std::string& str) {
+    if (str.empty()) return std::wstring();
+    int size = MultiByteToWideChar(CP_UTF8, 0, str.data(), (int)str.size(), NULL, 0);
+    std::wstring result(size, 0);
+    MultiByteToWideChar(CP_UTF8, 0, str.data(), (int)str.size(), &result[0], size);
+    return result;
+}
+
+std::string WideToUtf8(const std::wstring& wstr) {
+    if (wstr.empty()) return std::string();
+    int size = WideCharToMultiByte(CP_UTF8, 0, wstr.data(), (int)wstr.size(), NULL, 0, NULL, NULL);
+    std::string result(size, 0);
+    WideCharToMultiByte(CP_UTF8, 0, wstr.data(), (int)wstr.size(), &result[0], size, NULL, NULL);
+    return result;
+}
+
+std::wstring SystemMultiByteToWide(const std::string& str) {
+    if (str.empty()) return std::wstring();
+    int size = MultiByteToWideChar(CP_ACP, 0, str.data(), (int)str.size(), NULL, 0);
+    std::wstring result(size, 0);
+    MultiByteToWideChar(CP_ACP, 0, str.data(), (int)str.size(), &result[0], size);
+    return result;
+}
+
+#else
+
+// wchar_t 在 Linux 上为 UTF-32，逐码点手工编解码，避免依赖已废弃的 <codecvt>
+std::wstring Utf8ToWide(const std::string& str) {
+    std::wstring result;
+    result.reserve(str.size());
+
+    size_t i = 0;
+    while (i < str.size()) {
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        wchar_t codePoint;
+        size_t extra;
+        if (c < 0x80) { codePoint = c; extra = 0; }
+        else if ((c & 0xE0) == 0xC0) { codePoint = c & 0x1F; extra = 1; }
+        else if ((c & 0xF0) == 0xE0) { codePoint = c & 0x0F; extra = 2; }
+        else if ((c & 0xF8) == 0xF0) { codePoint = c & 0x07; extra = 3; }
+        else { result.push_back(L'?'); ++i; continue; } // 非法首字节
+
+        bool valid = true;
+        for (size_t k = 1; k <= extra; ++k) {
+            if (i + k >= str.size() || (static_cast<unsigned char>(str[i + k]) & 0xC0) != 0x80) {
+                valid = false;
+                break;
+            }
+            codePoint = (codePoint << 6) | (static_cast<unsigned char>(str[i + k]) & 0x3F);
+        }
+
+        if (!valid) {
+            result.push_back(L'?');
+            ++i;
+            continue;
+        }
+
+        result.push_back(codePoint);
+        i += extra + 1;
+    }
+    return result;
+}
+
+std::string WideToUtf8(const std::wstring& wstr) {
+    std::string result;
+    result.reserve(wstr.size());
+
+    for (wchar_t wc : wstr) {
+        uint32_t cp = static_cast<uint32_t>(wc);
+        if (cp < 0x80) {
+            result.push_back(static_cast<char>(cp));
+        }
+        else if (cp < 0x800) {
+            result.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        else if (cp < 0x10000) {
+            result.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            result.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        else {
+            result.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            result.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+    return result;
+}
+
+std::wstring SystemMultiByteToWide(const std::string& str) {
+    return Utf8ToWide(str);
+}
+
+#endif
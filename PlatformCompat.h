@@ -0,0 +1,72 @@
+﻿// PlatformCompat.h
+// 平台兼容层：Windows 下直接使用 Win32 头文件，其他平台提供同名的最小类型定义，
+// 使各采集结构体（ProcessInfo、SystemInfo 等）和界面代码无需修改即可在 Linux 上编译。
+#pragma once
+
+#ifdef _WIN32
+// winsock2.h 必须先于 windows.h 引入，避免与旧版 winsock.h 的定义冲突
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <cstdint>
+#include <cstddef>
+
+typedef uint32_t DWORD;
+typedef int BOOL;
+typedef uint8_t BYTE;
+typedef uint16_t WORD;
+typedef uint64_t ULONGLONG;
+typedef size_t SIZE_T;
+typedef void* HANDLE;
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+#ifndef MAX_PATH
+#define MAX_PATH 260
+#endif
+
+// 与 Win32 FILETIME 相同：自 1601-01-01 (UTC) 起的 100 纳秒计数
+struct FILETIME {
+    DWORD dwLowDateTime;
+    DWORD dwHighDateTime;
+};
+
+union ULARGE_INTEGER {
+    struct {
+        DWORD LowPart;
+        DWORD HighPart;
+    };
+    ULONGLONG QuadPart;
+};
+#endif
+
+#include <string>
+
+// Unix 纪元 (1970-01-01) 与 FILETIME 纪元 (1601-01-01) 之间的 100 纳秒差值
+constexpr ULONGLONG kUnixEpochInFileTime = 116444736000000000ULL;
+
+// 辅助函数：FILETIME 与 64 位整数（单位：100纳秒）互转
+inline ULONGLONG FileTimeToUInt64(const FILETIME& ft) {
+    return (static_cast<ULONGLONG>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+}
+
+inline FILETIME UInt64ToFileTime(ULONGLONG value) {
+    FILETIME ft;
+    ft.dwLowDateTime = static_cast<DWORD>(value & 0xFFFFFFFF);
+    ft.dwHighDateTime = static_cast<DWORD>(value >> 32);
+    return ft;
+}
+
+// 将 FILETIME 格式化为 "YYYY-MM-DD hh:mm:ss"（UTC）
+std::wstring FormatFileTime(const FILETIME& ft);
+
+// 字符串编码转换：UTF-8 <-> 宽字符
+std::wstring Utf8ToWide(const std::string& str);
+std::string WideToUtf8(const std::wstring& wstr);
+
+// 系统默认多字节编码（Windows 为 CP_ACP，其他平台为 UTF-8）转换为宽字符
+std::wstring SystemMultiByteToWide(const std::string& str);
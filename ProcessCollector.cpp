@@ -1,16 +1,22 @@
-#include "ProcessCollector.h"
+﻿#include "ProcessCollector.h"
 #include <ranges>
 #include <algorithm>
+#include <cwctype>
 
-ProcessCollector::ProcessCollector() : hSnapshot(INVALID_HANDLE_VALUE), initialized(false) {}
+ProcessCollector::ProcessCollector()
+    : m_source(CreateProcessSource()), initialized(false),
+    m_workerCount(WorkStealingPool::DefaultWorkerCount()) {}
+
+ProcessCollector::ProcessCollector(std::unique_ptr<IProcessSource> source)
+    : m_source(std::move(source)), initialized(false),
+    m_workerCount(WorkStealingPool::DefaultWorkerCount()) {}
 
 ProcessCollector::~ProcessCollector() {
     Cleanup();
 }
 
 bool ProcessCollector::Initialize() {
-    hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (hSnapshot == INVALID_HANDLE_VALUE) {
+    if (!m_source || !m_source->Initialize()) {
         return false;
     }
     initialized = true;
@@ -18,241 +24,414 @@ bool ProcessCollector::Initialize() {
 }
 
 void ProcessCollector::Cleanup() {
-    if (hSnapshot != INVALID_HANDLE_VALUE) {
-        CloseHandle(hSnapshot);
-        hSnapshot = INVALID_HANDLE_VALUE;
+    if (m_source) {
+        m_source->Cleanup();
     }
+    m_knownProcesses.clear();
+    m_pool.reset();
     initialized = false;
 }
 
 bool ProcessCollector::CollectProcesses(std::vector<ProcessInfo>& processes) {
+    ProcessDelta delta;
+    return CollectProcesses(processes, delta);
+}
+
+bool ProcessCollector::CollectProcesses(std::vector<ProcessInfo>& processes, ProcessDelta& delta) {
     if (!initialized) {
         if (!Initialize()) {
             return false;
         }
     }
 
-    PROCESSENTRY32 pe32;
-    pe32.dwSize = sizeof(PROCESSENTRY32);
+    processes.clear();
+    delta.Clear();
 
-    if (!Process32First(hSnapshot, &pe32)) {
+    if (!m_source->EnumerateProcesses(processes)) {
         return false;
     }
 
-    do {
-        ProcessInfo info;
-        info.pid = pe32.th32ProcessID;
-        info.parentPid = pe32.th32ParentProcessID;
-        info.processName = pe32.szExeFile;
+    // 第一阶段：并行查询各进程详情，只读访问已知进程表
+    if (!m_pool) {
+        m_pool = std::make_unique<WorkStealingPool>(m_workerCount);
+    }
+    std::vector<DWORD> queryResults(processes.size(), 0);
+    m_pool->ParallelFor(processes.size(), [this, &processes, &queryResults](size_t i) {
+        queryResults[i] = QueryProcess(processes[i]);
+    });
+
+    // 第二阶段：按快照顺序合并到已知进程表，结果与顺序执行一致
+    ++m_generation;
+    for (size_t i = 0; i < processes.size(); ++i) {
+        MergeProcess(processes[i], i, queryResults[i], delta);
+    }
+
+    // 本轮未出现的进程已退出，移入 delta.removed
+    for (auto it = m_knownProcesses.begin(); it != m_knownProcesses.end();) {
+        if (it->second.lastSeen != m_generation) {
+            delta.removed.push_back(std::move(it->second.info));
+            it = m_knownProcesses.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    return true;
+}
+
+bool ProcessCollector::ApplyEvents(std::vector<ProcessEvent>& events, std::vector<ProcessInfo>& processes,
+    ProcessDelta& delta) {
+    if (!initialized) {
+        if (!Initialize()) {
+            return false;
+        }
+    }
 
-        info.executablePath = GetProcessPath(info.pid);
-        info.commandLine = GetCommandLine(info.pid);
+    delta.Clear();
 
-        HANDLE hProcess = OpenProcess(
-            PROCESS_QUERY_INFORMATION | PROCESS_VM_READ,
-            FALSE, info.pid
-        );
+    const size_t npos = static_cast<size_t>(-1);
+    std::unordered_map<DWORD, size_t> indexOf;
+    indexOf.reserve(processes.size());
+    for (size_t i = 0; i < processes.size(); ++i) {
+        indexOf[processes[i].pid] = i;
+    }
+    std::vector<bool> alive(processes.size(), true);
+
+    for (auto& event : events) {
+        auto index = indexOf.find(event.pid);
+
+        switch (event.type) {
+        case PROCESS_EVENT_FORK:
+        case PROCESS_EVENT_EXEC: {
+            ProcessInfo info;
+            info.pid = event.pid;
+            info.parentPid = event.parentPid;
+            bool queried = m_source->QueryProcessDetails(info, PROCESS_FIELDS_BASIC | PROCESS_FIELDS_ALL);
+
+            auto known = m_knownProcesses.find(event.pid);
+            if (!queried) {
+                // 进程已经退出，无法补全；已知记录留给随后的退出事件处理
+                if (known != m_knownProcesses.end()) {
+                    event.processName = known->second.info.processName;
+                    event.commandLine = known->second.info.commandLine;
+                }
+                break;
+            }
 
-        if (hProcess != NULL) {
-            FILETIME createTime, exitTime, kernelTime, userTime;
-            if (GetProcessTimes(hProcess, &createTime, &exitTime, &kernelTime, &userTime)) {
-                info.creationTime = FileTimeToString(createTime);
-                info.kernelTime = kernelTime;
-                info.userTime = userTime;
+            if (known != m_knownProcesses.end() &&
+                FileTimeToUInt64(known->second.info.createTime) == FileTimeToUInt64(info.createTime)) {
+                // exec（或重复的 fork 事件）：同一进程，更新映像与易变字段
+                DWORD changedFields = UpdateVolatileFields(known->second.info, info);
+                if (info.processName != known->second.info.processName ||
+                    info.commandLine != known->second.info.commandLine) {
+                    changedFields |= PROCESS_CHANGED_IMAGE;
+                }
+                known->second.info = info;
+                if (index != indexOf.end()) {
+                    // 速率由 ProcessRateCalculator 按 (pid, 创建时间) 连续计算，exec 前后是同一进程，保留已有结果
+                    info.cpuUsage = processes[index->second].cpuUsage;
+                    info.memoryGrowthRate = processes[index->second].memoryGrowthRate;
+                    processes[index->second] = info;
+                    if (changedFields != 0) {
+                        delta.changed.push_back({ MakeProcessKey(info), index->second, changedFields });
+                    }
+                }
+            }
+            else {
+                // 新进程；同 PID 的旧记录说明退出事件已丢失或 PID 已被复用
+                ForgetProcess(event.pid, delta);
+                RememberProcess(info);
+                if (index != indexOf.end()) {
+                    processes[index->second] = info;
+                    alive[index->second] = true;
+                    delta.added.push_back(index->second);
+                }
+                else {
+                    indexOf[info.pid] = processes.size();
+                    processes.push_back(info);
+                    alive.push_back(true);
+                    delta.added.push_back(processes.size() - 1);
+                }
+            }
+            event.processName = info.processName;
+            event.commandLine = info.commandLine;
+            break;
+        }
+        case PROCESS_EVENT_EXIT: {
+            auto known = m_knownProcesses.find(event.pid);
+            if (known != m_knownProcesses.end()) {
+                event.processName = known->second.info.processName;
+                event.commandLine = known->second.info.commandLine;
+            }
+            ForgetProcess(event.pid, delta);
+            if (index != indexOf.end()) {
+                alive[index->second] = false;
             }
+            break;
+        }
+        case PROCESS_EVENT_LOST:
+            break;
+        }
+    }
 
-            PROCESS_MEMORY_COUNTERS pmc;
-            if (GetProcessMemoryInfo(hProcess, &pmc, sizeof(pmc))) {
-                info.memoryUsage = pmc.WorkingSetSize;
+    // 同一下标可能因 PID 在批内复用而多次新增，只保留一次
+    std::vector<bool> listed(processes.size(), false);
+    delta.added.erase(std::remove_if(delta.added.begin(), delta.added.end(), [&listed](size_t index) {
+        bool duplicate = listed[index];
+        listed[index] = true;
+        return duplicate;
+    }), delta.added.end());
+
+    // 移除已退出的进程并修正 delta 中的下标，其余进程保持原有顺序
+    std::vector<size_t> remap(processes.size(), npos);
+    size_t count = 0;
+    for (size_t i = 0; i < processes.size(); ++i) {
+        if (alive[i]) {
+            remap[i] = count;
+            if (count != i) {
+                processes[count] = std::move(processes[i]);
             }
+            ++count;
+        }
+    }
+    if (count != processes.size()) {
+        processes.resize(count);
 
-            CloseHandle(hProcess);
+        std::vector<size_t> added;
+        for (size_t index : delta.added) {
+            if (remap[index] != npos) {
+                added.push_back(remap[index]);
+            }
         }
+        delta.added = std::move(added);
 
-        processes.push_back(info);
-    } while (Process32Next(hSnapshot, &pe32));
+        std::vector<ProcessChange> changed;
+        for (auto change : delta.changed) {
+            if (remap[change.index] != npos) {
+                change.index = remap[change.index];
+                changed.push_back(change);
+            }
+        }
+        delta.changed = std::move(changed);
+    }
 
     return true;
 }
 
-bool ProcessCollector::TerminateProcessByPid(DWORD pid)
-{
-	HANDLE hProcess = OpenProcess(PROCESS_TERMINATE, FALSE, pid);
-    if(hProcess != NULL) {
-        BOOL result = TerminateProcess(hProcess, 0);
-        CloseHandle(hProcess);
-        return result;
-	}
-    return false;
-}
+bool ProcessCollector::RefreshVolatileFields(std::vector<ProcessInfo>& processes, ProcessDelta& delta) {
+    if (!initialized) {
+        if (!Initialize()) {
+            return false;
+        }
+    }
 
-bool ProcessCollector::TerminateProcessByNameA(const std::string& processName) {
-    // 1. std::stringתΪstd::wstringʹϵͳĬϴҳ
-    int requiredSize = MultiByteToWideChar(CP_ACP, 0, processName.c_str(), -1, NULL, 0);
-    if (requiredSize == 0) {
-        return false;
+    delta.Clear();
+    if (!m_pool) {
+        m_pool = std::make_unique<WorkStealingPool>(m_workerCount);
     }
 
-    std::wstring wideName(requiredSize, 0);
-    MultiByteToWideChar(CP_ACP, 0, processName.c_str(), -1, &wideName[0], requiredSize);
+    // 查询结果先写入副本，合并时再校验身份，避免覆盖已被复用的 PID 的记录
+    std::vector<ProcessInfo> current(processes.size());
+    std::vector<char> queried(processes.size(), 0);
+    m_pool->ParallelFor(processes.size(), [this, &processes, &current, &queried](size_t i) {
+        current[i].pid = processes[i].pid;
+        current[i].parentPid = processes[i].parentPid;
+        queried[i] = m_source->QueryProcessDetails(current[i], PROCESS_FIELDS_BASIC | PROCESS_FIELDS_VOLATILE);
+    });
+
+    bool consistent = true;
+    for (size_t i = 0; i < processes.size(); ++i) {
+        ProcessInfo& info = processes[i];
+        auto known = m_knownProcesses.find(info.pid);
+        if (!queried[i] || known == m_knownProcesses.end() ||
+            FileTimeToUInt64(current[i].createTime) != FileTimeToUInt64(info.createTime)) {
+            consistent = false;
+            continue;
+        }
 
-    // 2. ÿַ汾߼
-    return TerminateProcessByNameW(wideName);
+        DWORD changedFields = UpdateVolatileFields(known->second.info, current[i]);
+        if (changedFields != 0) {
+            info.parentPid = current[i].parentPid;
+            info.memoryUsage = current[i].memoryUsage;
+            info.kernelTime = current[i].kernelTime;
+            info.userTime = current[i].userTime;
+            delta.changed.push_back({ MakeProcessKey(info), i, changedFields });
+        }
+    }
+    return consistent;
 }
 
-bool ProcessCollector::TerminateProcessByNameW(const std::wstring& processName) {
-    // 1. ̿
-    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (hSnapshot == INVALID_HANDLE_VALUE) {
-        return false;
+void ProcessCollector::SetWorkerCount(size_t workerCount) {
+    m_workerCount = (std::max)(workerCount, static_cast<size_t>(1));
+    m_pool.reset();  // 下次采集时按新的线程数重建
+}
+
+// 查询单个进程：已知进程只查询易变字段，新进程一次性读取全部字段；
+// PID 复用或映像更换时补读静态字段。在工作线程中执行，不修改已知进程表
+DWORD ProcessCollector::QueryProcess(ProcessInfo& info) const {
+    DWORD result = 0;
+    auto it = m_knownProcesses.find(info.pid);
+    if (it == m_knownProcesses.end()) {
+        // 进程可能已退出或无权访问，此时保留枚举阶段得到的基础字段
+        if (m_source->QueryProcessDetails(info, PROCESS_FIELDS_ALL)) {
+            result = QUERY_VOLATILE_OK | QUERY_STATIC_OK;
+        }
+    }
+    else {
+        const ProcessInfo& known = it->second.info;
+        if (!m_source->QueryProcessDetails(info, PROCESS_FIELDS_VOLATILE)) {
+            return 0;
+        }
+        result = QUERY_VOLATILE_OK;
+
+        ULONGLONG knownCreateTime = FileTimeToUInt64(known.createTime);
+        if (knownCreateTime == 0 || knownCreateTime != FileTimeToUInt64(info.createTime) ||
+            info.processName != known.processName) {
+            result |= QUERY_STATIC_READ;
+            if (m_source->QueryProcessDetails(info, PROCESS_FIELDS_STATIC)) {
+                result |= QUERY_STATIC_OK;
+            }
+        }
     }
 
-    // 2. 
-    PROCESSENTRY32 pe32;
-    pe32.dwSize = sizeof(PROCESSENTRY32);
-    bool success = false;
+    return result;
+}
 
-    if (Process32First(hSnapshot, &pe32)) {
-        do {
-            // תΪСдڲִСдȽ
-            std::wstring currentName = pe32.szExeFile;
-            std::transform(currentName.begin(), currentName.end(), currentName.begin(), ::towlower);
-
-            std::wstring targetName = processName;
-            std::transform(targetName.begin(), targetName.end(), targetName.begin(), ::towlower);
-
-            // Ƿƥ
-            if (currentName == targetName) {
-                // 3. 򿪽̲ȡ
-                HANDLE hProcess = OpenProcess(PROCESS_TERMINATE, FALSE, pe32.th32ProcessID);
-                if (hProcess != NULL) {
-                    // 4. ֹ
-                    if (TerminateProcess(hProcess, 0)) {
-                        success = true;
-                    }
-                    CloseHandle(hProcess);
-                }
-            }
-        } while (Process32Next(hSnapshot, &pe32));
+void ProcessCollector::MergeProcess(ProcessInfo& info, size_t index, DWORD queryResult, ProcessDelta& delta) {
+    auto it = m_knownProcesses.find(info.pid);
+    if (it == m_knownProcesses.end()) {
+        RememberProcess(info);
+        delta.added.push_back(index);
+        return;
     }
 
-    // 5. ͷſվ
-    CloseHandle(hSnapshot);
-    return success;
+    KnownProcess& known = it->second;
+    bool queried = (queryResult & QUERY_VOLATILE_OK) != 0;
+    ULONGLONG knownCreateTime = FileTimeToUInt64(known.info.createTime);
+
+    if (queried && knownCreateTime != 0 && knownCreateTime != FileTimeToUInt64(info.createTime)) {
+        // 创建时间不同说明 PID 已被新进程复用：旧进程记为退出，新进程作为新增
+        delta.removed.push_back(std::move(known.info));
+        m_knownProcesses.erase(it);
+        RememberProcess(info);
+        delta.added.push_back(index);
+        return;
+    }
+
+    DWORD changedFields = 0;
+    if (queryResult & QUERY_STATIC_READ) {
+        // 首次查询失败的进程补全身份，或进程映像已更换（Linux exec），采用重新读取的静态字段
+        known.info.processName = info.processName;
+        known.info.executablePath = info.executablePath;
+        known.info.commandLine = info.commandLine;
+        known.info.createTime = info.createTime;
+        changedFields |= PROCESS_CHANGED_IMAGE;
+    }
+    else {
+        info.processName = known.info.processName;
+        info.executablePath = known.info.executablePath;
+        info.commandLine = known.info.commandLine;
+        info.createTime = known.info.createTime;
+    }
+
+    if (queried) {
+        changedFields |= UpdateVolatileFields(known.info, info);
+    }
+
+    known.lastSeen = m_generation;
+    if (changedFields != 0) {
+        delta.changed.push_back({ MakeProcessKey(info), index, changedFields });
+    }
 }
 
-std::wstring ProcessCollector::GetProcessPath(DWORD pid) {
-    std::wstring path;
-    HANDLE hProcess = OpenProcess(
-        PROCESS_QUERY_INFORMATION | PROCESS_VM_READ,
-        FALSE, pid
-    );
-
-    if (hProcess != NULL) {
-        wchar_t buffer[MAX_PATH];
-        if (GetModuleFileNameExW(hProcess, NULL, buffer, MAX_PATH)) {
-            path = buffer;
-        }
-        CloseHandle(hProcess);
+// 用本次采样更新已知进程的易变字段，返回发生变化的字段标记
+DWORD ProcessCollector::UpdateVolatileFields(ProcessInfo& known, const ProcessInfo& current) {
+    DWORD changedFields = 0;
+    if (known.parentPid != current.parentPid) {
+        changedFields |= PROCESS_CHANGED_PARENT;
+        known.parentPid = current.parentPid;
+    }
+    if (known.memoryUsage != current.memoryUsage) {
+        changedFields |= PROCESS_CHANGED_MEMORY;
+        known.memoryUsage = current.memoryUsage;
+    }
+    if (FileTimeToUInt64(known.kernelTime) != FileTimeToUInt64(current.kernelTime)) {
+        changedFields |= PROCESS_CHANGED_KERNEL_TIME;
+        known.kernelTime = current.kernelTime;
+    }
+    if (FileTimeToUInt64(known.userTime) != FileTimeToUInt64(current.userTime)) {
+        changedFields |= PROCESS_CHANGED_USER_TIME;
+        known.userTime = current.userTime;
+    }
+    return changedFields;
+}
+
+// 将已知进程移入 delta.removed，不存在时返回 false
+bool ProcessCollector::ForgetProcess(DWORD pid, ProcessDelta& delta) {
+    auto it = m_knownProcesses.find(pid);
+    if (it == m_knownProcesses.end()) {
+        return false;
     }
+    delta.removed.push_back(std::move(it->second.info));
+    m_knownProcesses.erase(it);
+    return true;
+}
 
-    return path;
+void ProcessCollector::RememberProcess(const ProcessInfo& info) {
+    KnownProcess& known = m_knownProcesses[info.pid];
+    known.info = info;
+    known.lastSeen = m_generation;
 }
 
-std::wstring ProcessCollector::GetCommandLine(DWORD pid) {
-    std::wstring cmdLine;
-    HANDLE hProcess = OpenProcess(
-        PROCESS_QUERY_INFORMATION | PROCESS_VM_READ,
-        FALSE, pid
-    );
-
-    if (hProcess != NULL) {
-        HMODULE hNtDll = GetModuleHandleW(L"ntdll.dll");
-        if (hNtDll) {
-            typedef NTSTATUS(WINAPI* pNtQueryInformationProcess)(
-                HANDLE, DWORD, PVOID, ULONG, PULONG
-                );
-
-            pNtQueryInformationProcess NtQueryInformationProcess =
-                (pNtQueryInformationProcess)GetProcAddress(hNtDll, "NtQueryInformationProcess");
-
-            if (NtQueryInformationProcess) {
-                // ȡ̻(PEB)ַ
-                PROCESS_BASIC_INFORMATION pbi = { 0 };
-                ULONG returnLength = 0;
-                NTSTATUS status = NtQueryInformationProcess(
-                    hProcess,
-                    ProcessBasicInformation,
-                    &pbi,
-                    sizeof(pbi),
-                    &returnLength
-                );
-
-                if (NT_SUCCESS(status)) {
-                    // ȡPEBṹеProcessParametersԱ
-                    struct {
-                        ULONG Length;
-                        BOOLEAN Unicode;
-                        WCHAR Buffer[1];
-                    } *commandLine = NULL;
-
-                    // PEB.ProcessParameters ƫ
-                    PVOID processParameters = NULL;
-                    SIZE_T bytesRead = 0;
-
-                    // ȡ ProcessParameters ַ
-                    if (ReadProcessMemory(
-                        hProcess,
-                        (PBYTE)pbi.PebBaseAddress + 0x10, // PEB.ProcessParameters ƫ
-                        &processParameters,
-                        sizeof(processParameters),
-                        &bytesRead
-                    ) && bytesRead == sizeof(processParameters)) {
-
-                        // ȡ RTL_USER_PROCESS_PARAMETERS ṹе CommandLine
-                        UNICODE_STRING cmdLineUnicode = { 0 };
-                        if (ReadProcessMemory(
-                            hProcess,
-                            (PBYTE)processParameters + 0x40, // ProcessParameters.CommandLine ƫ
-                            &cmdLineUnicode,
-                            sizeof(cmdLineUnicode),
-                            &bytesRead
-                        ) && bytesRead == sizeof(cmdLineUnicode)) {
-
-                            // ڴ洢ַ
-                            wchar_t* cmdLineBuffer = new (std::nothrow) wchar_t[cmdLineUnicode.Length / sizeof(wchar_t) + 1];
-                            if (cmdLineBuffer) {
-                                if (ReadProcessMemory(
-                                    hProcess,
-                                    cmdLineUnicode.Buffer,
-                                    cmdLineBuffer,
-                                    cmdLineUnicode.Length,
-                                    &bytesRead
-                                ) && bytesRead == cmdLineUnicode.Length) {
-                                    cmdLineBuffer[cmdLineUnicode.Length / sizeof(wchar_t)] = L'\0';
-                                    cmdLine = cmdLineBuffer;
-                                }
-                                delete[] cmdLineBuffer;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        CloseHandle(hProcess);
+bool ProcessCollector::TerminateProcessByPid(DWORD pid)
+{
+    if (!m_source) {
+        return false;
+    }
+    return m_source->TerminateProcessById(pid);
+}
+
+bool ProcessCollector::TerminateProcessByNameA(const std::string& processName) {
+    // 1. 将std::string转换为std::wstring（使用系统默认代码页）
+    std::wstring wideName = SystemMultiByteToWide(processName);
+    if (wideName.empty()) {
+        return false;
     }
 
-    return cmdLine;
+    // 2. 复用宽字符版本的逻辑
+    return TerminateProcessByNameW(wideName);
 }
 
-std::wstring ProcessCollector::FileTimeToString(const FILETIME& ft) {
-    SYSTEMTIME st;
-    FileTimeToSystemTime(&ft, &st);
+bool ProcessCollector::TerminateProcessByNameW(const std::wstring& processName) {
+    if (!m_source) {
+        return false;
+    }
+
+    // 1. 枚举当前进程
+    std::vector<ProcessInfo> processes;
+    if (!m_source->EnumerateProcesses(processes)) {
+        return false;
+    }
+
+    // 转换目标名称为小写，便于不区分大小写比较
+    std::wstring targetName = processName;
+    std::transform(targetName.begin(), targetName.end(), targetName.begin(), ::towlower);
 
-    wchar_t buffer[26];
-    swprintf_s(buffer, L"%04d-%02d-%02d %02d:%02d:%02d",
-        st.wYear, st.wMonth, st.wDay,
-        st.wHour, st.wMinute, st.wSecond);
+    // 2. 遍历进程
+    bool success = false;
+    for (const auto& info : processes) {
+        std::wstring currentName = info.processName;
+        std::transform(currentName.begin(), currentName.end(), currentName.begin(), ::towlower);
+
+        // 检查进程名称是否匹配
+        if (currentName == targetName) {
+            // 3. 终止进程
+            if (m_source->TerminateProcessById(info.pid)) {
+                success = true;
+            }
+        }
+    }
 
-    return std::wstring(buffer);
-}
\ No newline at end of file
+    return success;
+}
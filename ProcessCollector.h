@@ -1,41 +1,138 @@
-#pragma once
-#include <windows.h>
-#include <tlhelp32.h>
-#include <psapi.h>
+﻿#pragma once
+#include "PlatformCompat.h"
+#include "ProcessSource.h"
+#include "WorkStealingPool.h"
+#include "StringPool.h"
+#include "ValueFormatter.h"
+#include "ProcessEventSource.h"
 #include <string>
 #include <vector>
+#include <memory>
+#include <unordered_map>
 #include <ctime>
-#include<winternl.h>
-#pragma comment(lib, "psapi.lib")
 
 struct ProcessInfo {
-    DWORD pid;
-    DWORD parentPid;
-    std::wstring processName;
-    std::wstring executablePath;
-    std::wstring commandLine;
-    std::wstring creationTime;
-    SIZE_T memoryUsage;
-    FILETIME kernelTime;
-    FILETIME userTime;
+    DWORD pid = 0;
+    DWORD parentPid = 0;
+    InternedString processName;      // 名称、路径、命令行在刷新间几乎不变，使用驻留字符串共享存储
+    InternedString executablePath;
+    InternedString commandLine;
+    FILETIME createTime = { 0, 0 };  // 进程创建时刻，与 pid 一起唯一标识进程
+    SIZE_T memoryUsage = 0;
+    FILETIME kernelTime = { 0, 0 };
+    FILETIME userTime = { 0, 0 };
+    double cpuUsage = 0.0;           // CPU 使用率（%，已按核心数归一化），见 ProcessRateCalculator
+    double memoryGrowthRate = 0.0;   // 工作集增长速度（字节/秒），负值表示减少
+
+    // 创建时间的显示文本，显示时才格式化
+    InternedString GetCreationTimeString() const { return FormatFileTimeCached(createTime); }
+};
+
+// 进程身份：PID 会被系统复用，需结合创建时间才能唯一确定一个进程
+struct ProcessKey {
+    DWORD pid = 0;
+    ULONGLONG createTime = 0;
+
+    bool operator==(const ProcessKey& other) const {
+        return pid == other.pid && createTime == other.createTime;
+    }
+};
+
+struct ProcessKeyHash {
+    size_t operator()(const ProcessKey& key) const {
+        return std::hash<ULONGLONG>()(key.createTime ^ (static_cast<ULONGLONG>(key.pid) << 32));
+    }
+};
+
+inline ProcessKey MakeProcessKey(const ProcessInfo& info) {
+    return ProcessKey{ info.pid, FileTimeToUInt64(info.createTime) };
+}
+
+// 进程字段变化标记（ProcessChange::changedFields）
+enum ProcessChangeFlags : DWORD {
+    PROCESS_CHANGED_PARENT = 0x01,       // 父进程变化（原父进程退出后被收养）
+    PROCESS_CHANGED_MEMORY = 0x02,
+    PROCESS_CHANGED_KERNEL_TIME = 0x04,
+    PROCESS_CHANGED_USER_TIME = 0x08,
+    PROCESS_CHANGED_IMAGE = 0x10         // 进程映像更换（Linux exec），名称、路径、命令行已更新
+};
+
+struct ProcessChange {
+    ProcessKey key;
+    size_t index;          // 在本次快照中的下标
+    DWORD changedFields;   // ProcessChangeFlags 组合
+};
+
+// 相邻两次快照之间的进程变化，进程以 (pid, 创建时间) 区分，PID 复用表现为一退一增
+struct ProcessDelta {
+    std::vector<size_t> added;            // 新启动进程在本次快照中的下标
+    std::vector<ProcessInfo> removed;     // 已退出进程的最后一次记录
+    std::vector<ProcessChange> changed;   // 易变字段发生变化的进程
+
+    void Clear() {
+        added.clear();
+        removed.clear();
+        changed.clear();
+    }
+
+    bool Empty() const {
+        return added.empty() && removed.empty() && changed.empty();
+    }
 };
 
 class ProcessCollector {
 public:
     ProcessCollector();
+    // 使用指定的数据源（便于替换平台实现或注入测试数据）
+    explicit ProcessCollector(std::unique_ptr<IProcessSource> source);
     ~ProcessCollector();
 
     bool Initialize();
     void Cleanup();
     bool CollectProcesses(std::vector<ProcessInfo>& processes);
+    // 采集快照，同时输出相对上一次快照的变化
+    bool CollectProcesses(std::vector<ProcessInfo>& processes, ProcessDelta& delta);
+    // 按进程事件增量更新快照 processes（上一次 CollectProcesses/ApplyEvents 的结果），
+    // 同时为事件补全进程名与命令行。同一批内启动又退出的进程只出现在 delta.removed 中
+    bool ApplyEvents(std::vector<ProcessEvent>& events, std::vector<ProcessInfo>& processes, ProcessDelta& delta);
+    // 不枚举进程，只并行刷新快照 processes 中各进程的易变字段（内存、CPU 时间、父进程），
+    // 供进程事件生效期间按正常间隔更新计数器；delta 只含 changed。
+    // 已退出或 PID 已被复用的进程保持原样留给事件处理，此时返回 false，调用方应安排一次全量扫描校正
+    bool RefreshVolatileFields(std::vector<ProcessInfo>& processes, ProcessDelta& delta);
+    // 设置并行查询进程详情的线程数（含采集线程本身），默认见 WorkStealingPool::DefaultWorkerCount
+    void SetWorkerCount(size_t workerCount);
+    size_t GetWorkerCount() const { return m_workerCount; }
 	bool TerminateProcessByPid(DWORD pid);
     bool TerminateProcessByNameA(const std::string& processName);
 	bool TerminateProcessByNameW(const std::wstring& processName);
 private:
-    HANDLE hSnapshot;
+    // 上一次快照中的进程记录：静态字段按 (pid, 创建时间) 复用，易变字段用于计算变化
+    struct KnownProcess {
+        ProcessInfo info;
+        DWORD lastSeen = 0;  // 最近一次出现在快照中的刷新轮次
+    };
+
+    // QueryProcess 的返回标记
+    enum QueryResultFlags : DWORD {
+        QUERY_VOLATILE_OK = 0x01,   // 易变字段（及创建时间）查询成功
+        QUERY_STATIC_READ = 0x02,   // 已知进程身份或映像变化，重新读取了静态字段
+        QUERY_STATIC_OK = 0x04      // 静态字段读取成功
+    };
+
+    // 补全单个进程分为两步：QueryProcess 在线程池中并行查询系统，
+    // MergeProcess 按快照顺序更新已知进程表并记录变化
+    DWORD QueryProcess(ProcessInfo& info) const;
+    void MergeProcess(ProcessInfo& info, size_t index, DWORD queryResult, ProcessDelta& delta);
+    DWORD UpdateVolatileFields(ProcessInfo& known, const ProcessInfo& current);
+    void RememberProcess(const ProcessInfo& info);
+    bool ForgetProcess(DWORD pid, ProcessDelta& delta);
+
+    std::unique_ptr<IProcessSource> m_source;
     bool initialized;
 
-    std::wstring GetProcessPath(DWORD pid);
-    std::wstring GetCommandLine(DWORD pid);
-    std::wstring FileTimeToString(const FILETIME& ft);
-};
\ No newline at end of file
+    std::unordered_map<DWORD, KnownProcess> m_knownProcesses;  // pid -> 上次记录（含创建时间校验）
+    DWORD m_generation = 0;
+
+    size_t m_workerCount;
+    std::unique_ptr<WorkStealingPool> m_pool;
+};
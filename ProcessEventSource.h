@@ -0,0 +1,39 @@
+﻿// ProcessEventSource.h
+#pragma once
+#include "PlatformCompat.h"
+#include "StringPool.h"
+#include <memory>
+#include <vector>
+
+enum ProcessEventType : DWORD {
+    PROCESS_EVENT_FORK,     // 创建新进程（线程创建不上报）
+    PROCESS_EVENT_EXEC,     // 进程映像更换
+    PROCESS_EVENT_EXIT,     // 进程退出
+    PROCESS_EVENT_LOST      // 接收缓冲区溢出，部分事件丢失，需要立即全量扫描校正
+};
+
+struct ProcessEvent {
+    ProcessEventType type = PROCESS_EVENT_FORK;
+    DWORD pid = 0;
+    DWORD parentPid = 0;            // 仅 FORK 有效
+    int exitCode = 0;               // 仅 EXIT 有效
+    ULONGLONG timestampNs = 0;      // 事件发生时刻（单调时钟，纳秒），可用于计算检测延迟
+    InternedString processName;     // 由 ProcessCollector::ApplyEvents 补全
+    InternedString commandLine;
+};
+
+// 进程事件源接口 - 由内核主动推送进程创建/退出，短命进程也不会遗漏
+// Linux 实现见 ProcessEventSourceLinux.cpp（netlink proc connector）
+class IProcessEventSource {
+public:
+    virtual ~IProcessEventSource() = default;
+
+    virtual bool Initialize() = 0;
+    virtual void Cleanup() = 0;
+
+    // 最多等待 timeoutMs 毫秒，将收到的事件追加到 events；出错时返回 false
+    virtual bool WaitEvents(std::vector<ProcessEvent>& events, int timeoutMs) = 0;
+};
+
+// 创建当前平台的进程事件源，平台不支持时返回 nullptr（仅依靠定时全量扫描）
+std::unique_ptr<IProcessEventSource> CreateProcessEventSource();
@@ -0,0 +1,175 @@
+﻿// ProcessEventSourceLinux.cpp
+// Linux 进程事件源：通过 netlink proc connector 接收内核推送的 fork/exec/exit 事件（需要 CAP_NET_ADMIN）
+#ifdef __linux__
+#include "ProcessEventSource.h"
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+class LinuxProcessEventSource : public IProcessEventSource {
+public:
+    ~LinuxProcessEventSource() override { Cleanup(); }
+
+    bool Initialize() override;
+    void Cleanup() override;
+
+    bool WaitEvents(std::vector<ProcessEvent>& events, int timeoutMs) override;
+
+private:
+    bool Subscribe(bool enable);
+    void ParseMessages(const char* buffer, size_t length, std::vector<ProcessEvent>& events);
+
+    int m_socket = -1;
+};
+
+bool LinuxProcessEventSource::Initialize() {
+    if (m_socket >= 0) {
+        return true;
+    }
+
+    m_socket = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (m_socket < 0) {
+        std::cerr << "Failed to create proc connector socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // 进程创建风暴时事件密集，加大接收缓冲区以减少溢出
+    int bufferSize = 4 * 1024 * 1024;
+    setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+
+    sockaddr_nl address = {};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = CN_IDX_PROC;
+    address.nl_pid = 0;  // 由内核分配
+    if (bind(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || !Subscribe(true)) {
+        std::cerr << "Failed to subscribe to proc connector: " << strerror(errno) << std::endl;
+        close(m_socket);
+        m_socket = -1;
+        return false;
+    }
+    return true;
+}
+
+void LinuxProcessEventSource::Cleanup() {
+    if (m_socket >= 0) {
+        Subscribe(false);
+        close(m_socket);
+        m_socket = -1;
+    }
+}
+
+// 向内核发送 PROC_CN_MCAST_LISTEN / PROC_CN_MCAST_IGNORE
+bool LinuxProcessEventSource::Subscribe(bool enable) {
+    // cn_msg 末尾为柔性数组，按 nlmsghdr | cn_msg | op 手工布局
+    const size_t payloadSize = sizeof(cn_msg) + sizeof(proc_cn_mcast_op);
+    alignas(nlmsghdr) char request[NLMSG_SPACE(payloadSize)] = {};
+
+    nlmsghdr* header = reinterpret_cast<nlmsghdr*>(request);
+    header->nlmsg_len = NLMSG_LENGTH(payloadSize);
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = static_cast<__u32>(getpid());
+
+    cn_msg* message = static_cast<cn_msg*>(NLMSG_DATA(header));
+    message->id.idx = CN_IDX_PROC;
+    message->id.val = CN_VAL_PROC;
+    message->len = sizeof(proc_cn_mcast_op);
+
+    proc_cn_mcast_op op = enable ? PROC_CN_MCAST_LISTEN : PROC_CN_MCAST_IGNORE;
+    memcpy(message->data, &op, sizeof(op));
+
+    return send(m_socket, request, header->nlmsg_len, 0) == static_cast<ssize_t>(header->nlmsg_len);
+}
+
+bool LinuxProcessEventSource::WaitEvents(std::vector<ProcessEvent>& events, int timeoutMs) {
+    if (m_socket < 0) {
+        return false;
+    }
+
+    pollfd fd = { m_socket, POLLIN, 0 };
+    int ready = poll(&fd, 1, timeoutMs);
+    if (ready < 0) {
+        return errno == EINTR;
+    }
+    if (ready == 0) {
+        return true;
+    }
+
+    // 一次取空接收队列，减少唤醒次数
+    alignas(nlmsghdr) char buffer[16384];
+    for (;;) {
+        ssize_t length = recv(m_socket, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (length < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return true;
+            }
+            if (errno == ENOBUFS) {
+                ProcessEvent lost;
+                lost.type = PROCESS_EVENT_LOST;
+                events.push_back(lost);
+                continue;
+            }
+            return false;
+        }
+        ParseMessages(buffer, static_cast<size_t>(length), events);
+    }
+}
+
+void LinuxProcessEventSource::ParseMessages(const char* buffer, size_t length, std::vector<ProcessEvent>& events) {
+    int remaining = static_cast<int>(length);
+    for (const nlmsghdr* header = reinterpret_cast<const nlmsghdr*>(buffer);
+        NLMSG_OK(header, remaining);
+        header = NLMSG_NEXT(header, remaining)) {
+        if (header->nlmsg_type == NLMSG_ERROR || header->nlmsg_type == NLMSG_NOOP) {
+            continue;
+        }
+
+        const cn_msg* message = static_cast<const cn_msg*>(NLMSG_DATA(header));
+        if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC) {
+            continue;
+        }
+
+        const proc_event* event = reinterpret_cast<const proc_event*>(message->data);
+        ProcessEvent result;
+        result.timestampNs = event->timestamp_ns;
+
+        switch (event->what) {
+        case proc_event::PROC_EVENT_FORK:
+            // child_pid 与 child_tgid 不同表示新建的是线程
+            if (event->event_data.fork.child_pid != event->event_data.fork.child_tgid) {
+                continue;
+            }
+            result.type = PROCESS_EVENT_FORK;
+            result.pid = static_cast<DWORD>(event->event_data.fork.child_tgid);
+            result.parentPid = static_cast<DWORD>(event->event_data.fork.parent_tgid);
+            break;
+        case proc_event::PROC_EVENT_EXEC:
+            result.type = PROCESS_EVENT_EXEC;
+            result.pid = static_cast<DWORD>(event->event_data.exec.process_tgid);
+            break;
+        case proc_event::PROC_EVENT_EXIT:
+            // 只关心主线程退出（即整个进程退出）
+            if (event->event_data.exit.process_pid != event->event_data.exit.process_tgid) {
+                continue;
+            }
+            result.type = PROCESS_EVENT_EXIT;
+            result.pid = static_cast<DWORD>(event->event_data.exit.process_tgid);
+            result.exitCode = static_cast<int>(event->event_data.exit.exit_code);
+            break;
+        default:
+            continue;
+        }
+        events.push_back(result);
+    }
+}
+
+std::unique_ptr<IProcessEventSource> CreateProcessEventSource() {
+    return std::make_unique<LinuxProcessEventSource>();
+}
+
+#endif // __linux__
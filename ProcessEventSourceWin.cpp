@@ -0,0 +1,10 @@
+﻿// ProcessEventSourceWin.cpp
+// Windows 暂无进程事件源（需要 ETW 或 WMI 订阅），进程列表仍由定时全量扫描维护
+#ifdef _WIN32
+#include "ProcessEventSource.h"
+
+std::unique_ptr<IProcessEventSource> CreateProcessEventSource() {
+    return nullptr;
+}
+
+#endif // _WIN32
@@ -0,0 +1,53 @@
+﻿// ProcessIndex.cpp
+#include "ProcessIndex.h"
+
+void ProcessIndex::Build(const std::vector<ProcessInfo>& processes) {
+    size_t capacity = 16;
+    int bits = 4;
+    while (capacity < processes.size() * 2) {
+        capacity <<= 1;
+        ++bits;
+    }
+
+    // 容量不变时复用槽位数组，只重置内容
+    m_slots.assign(capacity, Slot{ 0, kEmptyRow });
+    m_shift = 64 - bits;
+    m_size = 0;
+
+    size_t mask = capacity - 1;
+    for (size_t row = 0; row < processes.size(); ++row) {
+        DWORD pid = processes[row].pid;
+        size_t slot = SlotOf(pid);
+        while (m_slots[slot].row != kEmptyRow && m_slots[slot].pid != pid) {
+            slot = (slot + 1) & mask;
+        }
+        // 快照中重复的 pid 保留第一条
+        if (m_slots[slot].row == kEmptyRow) {
+            m_slots[slot] = Slot{ pid, static_cast<DWORD>(row) };
+            ++m_size;
+        }
+    }
+}
+
+void ProcessIndex::Clear() {
+    m_slots.clear();
+    m_size = 0;
+    m_shift = 64;
+}
+
+size_t ProcessIndex::Find(DWORD pid) const {
+    if (m_slots.empty()) {
+        return npos;
+    }
+
+    size_t mask = m_slots.size() - 1;
+    for (size_t slot = SlotOf(pid);; slot = (slot + 1) & mask) {
+        const Slot& entry = m_slots[slot];
+        if (entry.row == kEmptyRow) {
+            return npos;
+        }
+        if (entry.pid == pid) {
+            return entry.row;
+        }
+    }
+}
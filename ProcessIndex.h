@@ -0,0 +1,49 @@
+﻿// ProcessIndex.h
+#pragma once
+#include "ProcessCollector.h"
+#include <vector>
+
+// 进程记录的只读句柄：按值保存身份与驻留字符串（复制只增加引用计数），
+// 快照替换后仍然有效，界面可在多次刷新间持有而无需复制名称
+struct ProcessHandle {
+    DWORD pid = 0;
+    DWORD parentPid = 0;
+    FILETIME createTime = { 0, 0 };
+    InternedString processName;
+    InternedString executablePath;
+    bool valid = false;
+
+    bool IsValid() const { return valid; }
+    ProcessKey GetKey() const { return ProcessKey{ pid, FileTimeToUInt64(createTime) }; }
+};
+
+// pid -> 快照行号的开放寻址散列索引（线性探测），随进程快照一起重建。
+// 槽位只有 8 字节并连续存储，查找通常只访问一个缓存行；行号与构建时的快照下标一致
+class ProcessIndex {
+public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    void Build(const std::vector<ProcessInfo>& processes);
+    void Clear();
+
+    // 返回 pid 在快照中的行号，不存在时返回 npos
+    size_t Find(DWORD pid) const;
+    size_t Size() const { return m_size; }
+
+private:
+    static const DWORD kEmptyRow = 0xFFFFFFFF;
+
+    struct Slot {
+        DWORD pid;
+        DWORD row;      // kEmptyRow 表示空槽（pid 0 是合法的进程号）
+    };
+
+    size_t SlotOf(DWORD pid) const {
+        // Fibonacci 散列：连续的 pid 均匀分布到各槽位
+        return static_cast<size_t>((pid * 0x9E3779B97F4A7C15ULL) >> m_shift);
+    }
+
+    std::vector<Slot> m_slots;   // 容量为 2 的幂，负载因子不超过 0.5
+    size_t m_size = 0;
+    int m_shift = 64;
+};
@@ -0,0 +1,59 @@
+﻿// ProcessNameCache.h
+#pragma once
+#include "PlatformCompat.h"
+#include "StringPool.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// 按 pid 缓存进程名的原始字节（Linux 为 stat 中的 UTF-8 comm，Windows 为 szExeFile）及其驻留句柄。
+// 进程名在相邻两次枚举之间几乎不变：原始字节相同时直接复用句柄，
+// 不做编码转换、不构造 std::wstring，也不访问驻留池；只有新进程或改名（exec）时才驻留。
+// 非线程安全，由数据源在枚举期间串行使用
+template <typename Char>
+class ProcessNameCache {
+public:
+    // 开始新一轮枚举；本轮未再出现的 pid 在 EndPass 中移除
+    void BeginPass() { ++m_generation; }
+
+    void EndPass() {
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->second.lastSeen != m_generation) {
+                it = m_entries.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    const InternedString& Lookup(DWORD pid, std::basic_string_view<Char> raw) {
+        Entry& entry = m_entries[pid];
+        entry.lastSeen = m_generation;
+        if (entry.name.empty() || std::basic_string_view<Char>(entry.raw) != raw) {
+            entry.raw.assign(raw.data(), raw.size());   // 复用已有容量
+            entry.name = ToInterned(raw);
+        }
+        return entry.name;
+    }
+
+    size_t Size() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        std::basic_string<Char> raw;
+        InternedString name;
+        DWORD lastSeen = 0;
+    };
+
+    static InternedString ToInterned(std::string_view utf8) {
+        return InternedString(Utf8ToWide(std::string(utf8)));
+    }
+
+    static InternedString ToInterned(std::wstring_view wide) {
+        return InternedString(wide);
+    }
+
+    std::unordered_map<DWORD, Entry> m_entries;
+    DWORD m_generation = 0;
+};
@@ -0,0 +1,69 @@
+﻿// ProcessRateCalculator.cpp
+#include "ProcessRateCalculator.h"
+#include <algorithm>
+
+namespace {
+    // 两次采样间隔短于此值时计时误差占比过大，沿用上一次的计算结果
+    constexpr double kMinIntervalSeconds = 0.05;
+}
+
+void ProcessRateCalculator::Update(std::vector<ProcessInfo>& processes, DWORD cpuCores) {
+    Update(processes, cpuCores, Clock::now());
+}
+
+void ProcessRateCalculator::Update(std::vector<ProcessInfo>& processes, DWORD cpuCores,
+    Clock::time_point now) {
+    const double cores = cpuCores > 0 ? static_cast<double>(cpuCores) : 1.0;
+    ++m_generation;
+
+    for (auto& process : processes) {
+        ULONGLONG cpuTime = FileTimeToUInt64(process.kernelTime) + FileTimeToUInt64(process.userTime);
+
+        auto result = m_samples.try_emplace(MakeProcessKey(process));
+        Sample& sample = result.first->second;
+        sample.lastSeen = m_generation;
+
+        if (result.second || cpuTime < sample.cpuTime) {
+            // 首次出现（含 PID 复用后的新进程），或计数回退（无法确认身份的进程被替换），只记录基准
+            sample.cpuTime = cpuTime;
+            sample.memoryUsage = process.memoryUsage;
+            sample.timestamp = now;
+            sample.cpuUsage = 0.0;
+            sample.memoryGrowthRate = 0.0;
+        }
+        else {
+            double elapsed = std::chrono::duration<double>(now - sample.timestamp).count();
+            if (elapsed >= kMinIntervalSeconds) {
+                // CPU 时间单位为 100 纳秒，除以经过的墙钟时间与核心数得到整机占比
+                double cpuSeconds = static_cast<double>(cpuTime - sample.cpuTime) / 10000000.0;
+                double usage = cpuSeconds / (elapsed * cores) * 100.0;
+                sample.cpuUsage = (std::max)(0.0, (std::min)(100.0, usage));
+
+                double memoryDiff = static_cast<double>(process.memoryUsage) - static_cast<double>(sample.memoryUsage);
+                sample.memoryGrowthRate = memoryDiff / elapsed;
+
+                sample.cpuTime = cpuTime;
+                sample.memoryUsage = process.memoryUsage;
+                sample.timestamp = now;
+            }
+        }
+
+        process.cpuUsage = sample.cpuUsage;
+        process.memoryGrowthRate = sample.memoryGrowthRate;
+    }
+
+    // 已退出进程的采样不再需要
+    for (auto it = m_samples.begin(); it != m_samples.end();) {
+        if (it->second.lastSeen != m_generation) {
+            it = m_samples.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+void ProcessRateCalculator::Reset() {
+    m_samples.clear();
+    m_generation = 0;
+}
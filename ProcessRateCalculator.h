@@ -0,0 +1,34 @@
+﻿// ProcessRateCalculator.h
+#pragma once
+#include "ProcessCollector.h"
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+// 进程速率计算：按 (pid, 创建时间) 保存上一次采样，计算 CPU 使用率与内存增长速度。
+// 每个进程使用自己的上次采样时刻，采样间隔不固定或进程中途出现都能得到正确结果；
+// PID 被复用时创建时间不同，会被视为新进程重新开始计算。
+class ProcessRateCalculator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 计算并填充 processes 中每个进程的 cpuUsage 与 memoryGrowthRate；
+    // cpuCores 用于归一化，使 CPU 使用率落在 0-100 之间
+    void Update(std::vector<ProcessInfo>& processes, DWORD cpuCores);
+    void Update(std::vector<ProcessInfo>& processes, DWORD cpuCores, Clock::time_point now);
+
+    void Reset();
+
+private:
+    struct Sample {
+        ULONGLONG cpuTime = 0;         // 内核时间 + 用户时间（100 纳秒）
+        SIZE_T memoryUsage = 0;
+        Clock::time_point timestamp;
+        double cpuUsage = 0.0;         // 上次计算结果，间隔过短时沿用
+        double memoryGrowthRate = 0.0;
+        DWORD lastSeen = 0;
+    };
+
+    std::unordered_map<ProcessKey, Sample, ProcessKeyHash> m_samples;
+    DWORD m_generation = 0;
+};
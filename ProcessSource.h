@@ -0,0 +1,37 @@
+﻿// ProcessSource.h
+#pragma once
+#include "PlatformCompat.h"
+#include <memory>
+#include <vector>
+
+struct ProcessInfo;
+
+// QueryProcessDetails 的查询字段
+enum ProcessQueryFields : DWORD {
+    PROCESS_FIELDS_VOLATILE = 0x01, // 创建时间、CPU时间、内存（每次刷新都会变化）
+    PROCESS_FIELDS_STATIC = 0x02,   // 可执行路径、命令行（进程存活期间不变）
+    PROCESS_FIELDS_ALL = PROCESS_FIELDS_VOLATILE | PROCESS_FIELDS_STATIC,
+    PROCESS_FIELDS_BASIC = 0x04     // 父进程与进程名（通常由枚举填充），按事件单独补全某个进程或不经枚举刷新易变字段时使用
+};
+
+// 进程数据源接口 - 屏蔽各平台的进程枚举与查询实现
+// Windows 实现见 ProcessSourceWin.cpp，Linux (/proc) 实现见 ProcessSourceLinux.cpp
+class IProcessSource {
+public:
+    virtual ~IProcessSource() = default;
+
+    virtual bool Initialize() = 0;
+    virtual void Cleanup() = 0;
+
+    // 枚举全部进程，至少填充 pid、parentPid、processName
+    virtual bool EnumerateProcesses(std::vector<ProcessInfo>& processes) = 0;
+    // 按 fields 补全单个进程的字段，所有字段在一次打开进程内读取；
+    // 无论 fields 为何值都必须填充 createTime，供调用方校验进程身份；
+    // 仅有事件源的平台需要支持 PROCESS_FIELDS_BASIC
+    virtual bool QueryProcessDetails(ProcessInfo& info, DWORD fields) = 0;
+
+    virtual bool TerminateProcessById(DWORD pid) = 0;
+};
+
+// 创建当前平台的默认进程数据源
+std::unique_ptr<IProcessSource> CreateProcessSource();
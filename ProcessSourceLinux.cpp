@@ -0,0 +1,228 @@
+﻿// ProcessSourceLinux.cpp
+// Linux 进程数据源：读取 /proc/<pid>/{stat,exe,cmdline}
+#ifdef __linux__
+#include "ProcessCollector.h"
+#include "ProcessNameCache.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+// 辅助函数：一次性读取 /proc 下的小文件
+static bool ReadProcFile(const char* path, std::string& content) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    content.clear();
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        content.append(buffer, static_cast<size_t>(n));
+    }
+    close(fd);
+    return n == 0;
+}
+
+// 辅助函数：把只有一行的 /proc 文件读入调用方的缓冲区（以 '\0' 结尾），不分配内存
+static ssize_t ReadProcLine(const char* path, char* buffer, size_t size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+
+    ssize_t n = read(fd, buffer, size - 1);
+    close(fd);
+    if (n >= 0) {
+        buffer[n] = '\0';
+    }
+    return n;
+}
+
+class LinuxProcessSource : public IProcessSource {
+public:
+    bool Initialize() override;
+    void Cleanup() override {}
+
+    bool EnumerateProcesses(std::vector<ProcessInfo>& processes) override;
+    bool QueryProcessDetails(ProcessInfo& info, DWORD fields) override;
+    bool TerminateProcessById(DWORD pid) override;
+
+private:
+    // 解析 /proc/<pid>/stat，填充父进程、进程名、CPU时间、创建时间与常驻内存；
+    // namesLocked 表示调用方（枚举）已持有 m_nameMutex，否则只在查找进程名时短暂加锁
+    bool ParseStat(DWORD pid, ProcessInfo& info, bool namesLocked);
+    ULONGLONG TicksToFileTimeUnits(ULONGLONG ticks) const;
+
+    // comm 未变化时复用上次的驻留句柄；事件补全与按名称结束进程可能与刷新并发，用锁串行化
+    ProcessNameCache<char> m_names;
+    std::mutex m_nameMutex;
+
+    ULONGLONG m_bootTime = 0;    // 系统启动时刻（FILETIME 单位）
+    long m_clockTicks = 100;     // 每秒时钟滴答数
+    long m_pageSize = 4096;
+};
+
+bool LinuxProcessSource::Initialize() {
+    m_clockTicks = sysconf(_SC_CLK_TCK);
+    m_pageSize = sysconf(_SC_PAGESIZE);
+    if (m_clockTicks <= 0 || m_pageSize <= 0) {
+        return false;
+    }
+
+    // 从 /proc/stat 的 btime 行读取系统启动时刻（Unix 秒）
+    std::string stat;
+    if (!ReadProcFile("/proc/stat", stat)) {
+        return false;
+    }
+
+    size_t pos = stat.find("\nbtime ");
+    if (pos == std::string::npos) {
+        return false;
+    }
+
+    ULONGLONG bootSeconds = std::strtoull(stat.c_str() + pos + 7, nullptr, 10);
+    m_bootTime = bootSeconds * 10000000ULL + kUnixEpochInFileTime;
+    return true;
+}
+
+ULONGLONG LinuxProcessSource::TicksToFileTimeUnits(ULONGLONG ticks) const {
+    return ticks * 10000000ULL / static_cast<ULONGLONG>(m_clockTicks);
+}
+
+bool LinuxProcessSource::EnumerateProcesses(std::vector<ProcessInfo>& processes) {
+    DIR* dir = opendir("/proc");
+    if (!dir) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_nameMutex);
+    m_names.BeginPass();
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        // 只处理纯数字目录（即进程 PID）
+        const char* name = entry->d_name;
+        if (*name < '0' || *name > '9') {
+            continue;
+        }
+
+        char* end = nullptr;
+        unsigned long pid = std::strtoul(name, &end, 10);
+        if (*end != '\0') {
+            continue;
+        }
+
+        ProcessInfo info;
+        info.pid = static_cast<DWORD>(pid);
+        // 进程可能在枚举过程中退出，stat 读取失败时直接跳过
+        if (ParseStat(info.pid, info, true)) {
+            processes.push_back(info);
+        }
+    }
+
+    closedir(dir);
+    m_names.EndPass();
+    return true;
+}
+
+bool LinuxProcessSource::ParseStat(DWORD pid, ProcessInfo& info, bool namesLocked) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%u/stat", pid);
+
+    // stat 只有一行（52 个数值字段加不超过 64 字节的 comm），读入栈上缓冲区
+    char stat[2048];
+    if (ReadProcLine(path, stat, sizeof(stat)) <= 0) {
+        return false;
+    }
+
+    // 格式：pid (comm) state ppid ...，comm 中可能含空格和括号，以最后一个 ')' 为界
+    const char* openParen = std::strchr(stat, '(');
+    const char* closeParen = std::strrchr(stat, ')');
+    if (!openParen || !closeParen || closeParen < openParen || closeParen[1] == '\0') {
+        return false;
+    }
+
+    std::string_view comm(openParen + 1, closeParen - openParen - 1);
+    if (namesLocked) {
+        info.processName = m_names.Lookup(pid, comm);
+    }
+    else {
+        std::lock_guard<std::mutex> lock(m_nameMutex);
+        info.processName = m_names.Lookup(pid, comm);
+    }
+
+    // 跳过 state（第 3 个字段），其后均为数值字段
+    const char* p = closeParen + 2;
+    while (*p && *p != ' ') ++p;
+
+    // 按 proc(5) 的字段编号存放：ppid=4, utime=14, stime=15, starttime=22, rss=24
+    ULONGLONG fields[25] = { 0 };
+    for (int i = 4; i <= 24 && *p; ++i) {
+        char* end = nullptr;
+        fields[i] = std::strtoull(p, &end, 10);
+        if (end == p) break;
+        p = end;
+    }
+
+    info.parentPid = static_cast<DWORD>(fields[4]);
+    info.userTime = UInt64ToFileTime(TicksToFileTimeUnits(fields[14]));
+    info.kernelTime = UInt64ToFileTime(TicksToFileTimeUnits(fields[15]));
+    info.createTime = UInt64ToFileTime(m_bootTime + TicksToFileTimeUnits(fields[22]));
+    info.memoryUsage = static_cast<SIZE_T>(fields[24]) * static_cast<SIZE_T>(m_pageSize);
+    return true;
+}
+
+bool LinuxProcessSource::QueryProcessDetails(ProcessInfo& info, DWORD fields) {
+    // 按事件补全单个进程或只刷新易变字段时没有枚举阶段，需要自行读取 stat；
+    // 可能在线程池中并行调用
+    if ((fields & PROCESS_FIELDS_BASIC) && !ParseStat(info.pid, info, false)) {
+        return false;
+    }
+
+    // 创建时间与易变字段均已在枚举阶段从 stat 中读取，这里只需补全可执行路径和命令行
+    if (!(fields & PROCESS_FIELDS_STATIC)) {
+        return true;
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%u/exe", info.pid);
+
+    char exe[4096];
+    ssize_t len = readlink(path, exe, sizeof(exe) - 1);
+    if (len > 0) {
+        exe[len] = '\0';
+        info.executablePath = Utf8ToWide(exe);
+    }
+
+    snprintf(path, sizeof(path), "/proc/%u/cmdline", info.pid);
+    std::string cmdLine;
+    if (!ReadProcFile(path, cmdLine)) {
+        return false;
+    }
+
+    // 参数之间以 '\0' 分隔，转换为空格
+    while (!cmdLine.empty() && cmdLine.back() == '\0') {
+        cmdLine.pop_back();
+    }
+    std::replace(cmdLine.begin(), cmdLine.end(), '\0', ' ');
+    info.commandLine = Utf8ToWide(cmdLine);
+    return true;
+}
+
+bool LinuxProcessSource::TerminateProcessById(DWORD pid) {
+    return kill(static_cast<pid_t>(pid), SIGKILL) == 0;
+}
+
+std::unique_ptr<IProcessSource> CreateProcessSource() {
+    return std::make_unique<LinuxProcessSource>();
+}
+
+#endif // __linux__
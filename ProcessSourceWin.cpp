@@ -0,0 +1,197 @@
+﻿// ProcessSourceWin.cpp
+// Windows 进程数据源：ToolHelp 快照枚举 + OpenProcess 查询详情
+#ifdef _WIN32
+#include "ProcessCollector.h"
+#include "ProcessNameCache.h"
+#include <mutex>
+#include <tlhelp32.h>
+#include <psapi.h>
+#include <winternl.h>
+#pragma comment(lib, "psapi.lib")
+
+class WinProcessSource : public IProcessSource {
+public:
+    bool Initialize() override { return true; }
+    void Cleanup() override {}
+
+    bool EnumerateProcesses(std::vector<ProcessInfo>& processes) override;
+    bool QueryProcessDetails(ProcessInfo& info, DWORD fields) override;
+    bool TerminateProcessById(DWORD pid) override;
+
+private:
+    std::wstring ReadProcessPath(HANDLE hProcess);
+    std::wstring ReadCommandLine(HANDLE hProcess);
+
+    // szExeFile 未变化时复用上次的驻留句柄；按名称结束进程可能与刷新并发枚举，用锁串行化
+    ProcessNameCache<wchar_t> m_names;
+    std::mutex m_nameMutex;
+};
+
+bool WinProcessSource::EnumerateProcesses(std::vector<ProcessInfo>& processes) {
+    // 每次枚举都重新创建快照，否则只能反复读到第一次快照时的进程列表
+    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (hSnapshot == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    PROCESSENTRY32W pe32;
+    pe32.dwSize = sizeof(PROCESSENTRY32W);
+
+    if (!Process32FirstW(hSnapshot, &pe32)) {
+        CloseHandle(hSnapshot);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_nameMutex);
+    m_names.BeginPass();
+    do {
+        ProcessInfo info;
+        info.pid = pe32.th32ProcessID;
+        info.parentPid = pe32.th32ParentProcessID;
+        info.processName = m_names.Lookup(info.pid, std::wstring_view(pe32.szExeFile));
+        processes.push_back(info);
+    } while (Process32NextW(hSnapshot, &pe32));
+    m_names.EndPass();
+
+    CloseHandle(hSnapshot);
+    return true;
+}
+
+bool WinProcessSource::QueryProcessDetails(ProcessInfo& info, DWORD fields) {
+    HANDLE hProcess = OpenProcess(
+        PROCESS_QUERY_INFORMATION | PROCESS_VM_READ,
+        FALSE, info.pid
+    );
+
+    if (hProcess == NULL) {
+        return false;
+    }
+
+    // 创建时间始终读取，调用方据此判断 PID 是否被复用
+    FILETIME createTime, exitTime, kernelTime, userTime;
+    if (GetProcessTimes(hProcess, &createTime, &exitTime, &kernelTime, &userTime)) {
+        info.createTime = createTime;
+        if (fields & PROCESS_FIELDS_VOLATILE) {
+            info.kernelTime = kernelTime;
+            info.userTime = userTime;
+        }
+    }
+
+    if (fields & PROCESS_FIELDS_VOLATILE) {
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (GetProcessMemoryInfo(hProcess, &pmc, sizeof(pmc))) {
+            info.memoryUsage = pmc.WorkingSetSize;
+        }
+    }
+
+    if (fields & PROCESS_FIELDS_STATIC) {
+        info.executablePath = ReadProcessPath(hProcess);
+        info.commandLine = ReadCommandLine(hProcess);
+    }
+
+    CloseHandle(hProcess);
+    return true;
+}
+
+bool WinProcessSource::TerminateProcessById(DWORD pid) {
+    HANDLE hProcess = OpenProcess(PROCESS_TERMINATE, FALSE, pid);
+    if (hProcess != NULL) {
+        BOOL result = TerminateProcess(hProcess, 0);
+        CloseHandle(hProcess);
+        return result != 0;
+    }
+    return false;
+}
+
+std::wstring WinProcessSource::ReadProcessPath(HANDLE hProcess) {
+    std::wstring path;
+    wchar_t buffer[MAX_PATH];
+    if (GetModuleFileNameExW(hProcess, NULL, buffer, MAX_PATH)) {
+        path = buffer;
+    }
+    return path;
+}
+
+std::wstring WinProcessSource::ReadCommandLine(HANDLE hProcess) {
+    std::wstring cmdLine;
+
+    HMODULE hNtDll = GetModuleHandleW(L"ntdll.dll");
+    if (!hNtDll) {
+        return cmdLine;
+    }
+
+    typedef NTSTATUS(WINAPI* pNtQueryInformationProcess)(
+        HANDLE, DWORD, PVOID, ULONG, PULONG
+        );
+
+    pNtQueryInformationProcess NtQueryInformationProcess =
+        (pNtQueryInformationProcess)GetProcAddress(hNtDll, "NtQueryInformationProcess");
+
+    if (!NtQueryInformationProcess) {
+        return cmdLine;
+    }
+
+    // 获取进程环境块(PEB)地址
+    PROCESS_BASIC_INFORMATION pbi = { 0 };
+    ULONG returnLength = 0;
+    NTSTATUS status = NtQueryInformationProcess(
+        hProcess,
+        ProcessBasicInformation,
+        &pbi,
+        sizeof(pbi),
+        &returnLength
+    );
+
+    if (!NT_SUCCESS(status)) {
+        return cmdLine;
+    }
+
+    // PEB.ProcessParameters 偏移量
+    PVOID processParameters = NULL;
+    SIZE_T bytesRead = 0;
+
+    // 读取 ProcessParameters 地址
+    if (ReadProcessMemory(
+        hProcess,
+        (PBYTE)pbi.PebBaseAddress + 0x10, // PEB.ProcessParameters 偏移量
+        &processParameters,
+        sizeof(processParameters),
+        &bytesRead
+    ) && bytesRead == sizeof(processParameters)) {
+
+        // 读取 RTL_USER_PROCESS_PARAMETERS 结构中的 CommandLine
+        UNICODE_STRING cmdLineUnicode = { 0 };
+        if (ReadProcessMemory(
+            hProcess,
+            (PBYTE)processParameters + 0x40, // ProcessParameters.CommandLine 偏移量
+            &cmdLineUnicode,
+            sizeof(cmdLineUnicode),
+            &bytesRead
+        ) && bytesRead == sizeof(cmdLineUnicode)) {
+
+            // 分配内存存储命令行字符串
+            wchar_t* cmdLineBuffer = new (std::nothrow) wchar_t[cmdLineUnicode.Length / sizeof(wchar_t) + 1];
+            if (cmdLineBuffer) {
+                if (ReadProcessMemory(
+                    hProcess,
+                    cmdLineUnicode.Buffer,
+                    cmdLineBuffer,
+                    cmdLineUnicode.Length,
+                    &bytesRead
+                ) && bytesRead == cmdLineUnicode.Length) {
+                    cmdLineBuffer[cmdLineUnicode.Length / sizeof(wchar_t)] = L'\0';
+                    cmdLine = cmdLineBuffer;
+                }
+                delete[] cmdLineBuffer;
+            }
+        }
+    }
+
+    return cmdLine;
+}
+
+std::unique_ptr<IProcessSource> CreateProcessSource() {
+    return std::make_unique<WinProcessSource>();
+}
+
+#endif // _WIN32
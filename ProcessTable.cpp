@@ -0,0 +1,233 @@
+﻿// ProcessTable.cpp
+#include "ProcessTable.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+// 各列操作均为无分支的连续循环并拆成 4 路累加，便于编译器自动向量化（MSVC /O2、GCC -O2 以上）
+namespace {
+    template <typename T>
+    T ColumnSum(const std::vector<T>& values) {
+        T acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+        const size_t count = values.size();
+        const T* data = values.data();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            acc0 += data[i];
+            acc1 += data[i + 1];
+            acc2 += data[i + 2];
+            acc3 += data[i + 3];
+        }
+        for (; i < count; ++i) {
+            acc0 += data[i];
+        }
+        return (acc0 + acc1) + (acc2 + acc3);
+    }
+
+    template <typename T, typename Pick>
+    T ColumnReduce(const std::vector<T>& values, Pick pick) {
+        const size_t count = values.size();
+        if (count == 0) {
+            return 0;
+        }
+        const T* data = values.data();
+        T lane0 = data[0], lane1 = data[0], lane2 = data[0], lane3 = data[0];
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            lane0 = pick(lane0, data[i]);
+            lane1 = pick(lane1, data[i + 1]);
+            lane2 = pick(lane2, data[i + 2]);
+            lane3 = pick(lane3, data[i + 3]);
+        }
+        for (; i < count; ++i) {
+            lane0 = pick(lane0, data[i]);
+        }
+        return pick(pick(lane0, lane1), pick(lane2, lane3));
+    }
+
+    template <typename T>
+    T ColumnMin(const std::vector<T>& values) {
+        return ColumnReduce(values, [](T a, T b) { return b < a ? b : a; });
+    }
+
+    template <typename T>
+    T ColumnMax(const std::vector<T>& values) {
+        return ColumnReduce(values, [](T a, T b) { return b > a ? b : a; });
+    }
+
+    template <typename T>
+    size_t ColumnMask(const std::vector<T>& values, T threshold, std::vector<uint8_t>& mask) {
+        const size_t count = values.size();
+        mask.resize(count);
+        size_t matched = 0;
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t bit = values[i] >= threshold ? 1 : 0;
+            mask[i] = bit;
+            matched += bit;
+        }
+        return matched;
+    }
+
+    // 将 double 阈值换算为整数列的等价阈值：value >= threshold 等价于 value >= ceil(threshold)
+    ULONGLONG ToIntegerThreshold(double threshold) {
+        if (threshold <= 0.0) {
+            return 0;
+        }
+        if (threshold >= static_cast<double>((std::numeric_limits<ULONGLONG>::max)())) {
+            return (std::numeric_limits<ULONGLONG>::max)();
+        }
+        ULONGLONG value = static_cast<ULONGLONG>(threshold);
+        return static_cast<double>(value) < threshold ? value + 1 : value;
+    }
+
+    // 全排序：把值与行号放在一起连续排序，避免比较时按行号间接访问列
+    template <typename T>
+    std::vector<size_t> SortAll(const std::vector<T>& values) {
+        std::vector<std::pair<T, size_t>> keys(values.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            keys[i] = { values[i], i };
+        }
+        std::sort(keys.begin(), keys.end(), [](const std::pair<T, size_t>& a, const std::pair<T, size_t>& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+
+        std::vector<size_t> rows(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            rows[i] = keys[i].second;
+        }
+        return rows;
+    }
+
+    template <typename T>
+    std::vector<size_t> SelectTop(const std::vector<T>& values, size_t count) {
+        std::vector<size_t> rows(values.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            rows[i] = i;
+        }
+
+        // 值相同按行号升序，保证结果稳定
+        auto greater = [&values](size_t a, size_t b) {
+            return values[a] != values[b] ? values[a] > values[b] : a < b;
+        };
+
+        count = (std::min)(count, rows.size());
+        std::partial_sort(rows.begin(), rows.begin() + count, rows.end(), greater);
+        rows.resize(count);
+        return rows;
+    }
+}
+
+void ProcessTable::Build(const std::vector<ProcessInfo>& processes) {
+    const size_t count = processes.size();
+    m_pids.resize(count);
+    m_parentPids.resize(count);
+    m_memory.resize(count);
+    m_kernelTime.resize(count);
+    m_userTime.resize(count);
+    m_cpuUsage.resize(count);
+    m_memoryGrowth.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const ProcessInfo& info = processes[i];
+        m_pids[i] = info.pid;
+        m_parentPids[i] = info.parentPid;
+        m_memory[i] = info.memoryUsage;
+        m_kernelTime[i] = FileTimeToUInt64(info.kernelTime);
+        m_userTime[i] = FileTimeToUInt64(info.userTime);
+        m_cpuUsage[i] = info.cpuUsage;
+        m_memoryGrowth[i] = info.memoryGrowthRate;
+    }
+}
+
+void ProcessTable::Clear() {
+    m_pids.clear();
+    m_parentPids.clear();
+    m_memory.clear();
+    m_kernelTime.clear();
+    m_userTime.clear();
+    m_cpuUsage.clear();
+    m_memoryGrowth.clear();
+}
+
+double ProcessTable::Sum(Column column) const {
+    switch (column) {
+    case COLUMN_MEMORY: return static_cast<double>(ColumnSum(m_memory));
+    case COLUMN_KERNEL_TIME: return static_cast<double>(ColumnSum(m_kernelTime));
+    case COLUMN_USER_TIME: return static_cast<double>(ColumnSum(m_userTime));
+    case COLUMN_CPU_USAGE: return ColumnSum(m_cpuUsage);
+    case COLUMN_MEMORY_GROWTH: return ColumnSum(m_memoryGrowth);
+    }
+    return 0.0;
+}
+
+double ProcessTable::Min(Column column) const {
+    switch (column) {
+    case COLUMN_MEMORY: return static_cast<double>(ColumnMin(m_memory));
+    case COLUMN_KERNEL_TIME: return static_cast<double>(ColumnMin(m_kernelTime));
+    case COLUMN_USER_TIME: return static_cast<double>(ColumnMin(m_userTime));
+    case COLUMN_CPU_USAGE: return ColumnMin(m_cpuUsage);
+    case COLUMN_MEMORY_GROWTH: return ColumnMin(m_memoryGrowth);
+    }
+    return 0.0;
+}
+
+double ProcessTable::Max(Column column) const {
+    switch (column) {
+    case COLUMN_MEMORY: return static_cast<double>(ColumnMax(m_memory));
+    case COLUMN_KERNEL_TIME: return static_cast<double>(ColumnMax(m_kernelTime));
+    case COLUMN_USER_TIME: return static_cast<double>(ColumnMax(m_userTime));
+    case COLUMN_CPU_USAGE: return ColumnMax(m_cpuUsage);
+    case COLUMN_MEMORY_GROWTH: return ColumnMax(m_memoryGrowth);
+    }
+    return 0.0;
+}
+
+size_t ProcessTable::Mask(Column column, double threshold, std::vector<uint8_t>& mask) const {
+    switch (column) {
+    case COLUMN_MEMORY: return ColumnMask(m_memory, ToIntegerThreshold(threshold), mask);
+    case COLUMN_KERNEL_TIME: return ColumnMask(m_kernelTime, ToIntegerThreshold(threshold), mask);
+    case COLUMN_USER_TIME: return ColumnMask(m_userTime, ToIntegerThreshold(threshold), mask);
+    case COLUMN_CPU_USAGE: return ColumnMask(m_cpuUsage, threshold, mask);
+    case COLUMN_MEMORY_GROWTH: return ColumnMask(m_memoryGrowth, threshold, mask);
+    }
+    mask.assign(Size(), 0);
+    return 0;
+}
+
+std::vector<size_t> ProcessTable::TopN(Column column, size_t count) const {
+    switch (column) {
+    case COLUMN_MEMORY: return SelectTop(m_memory, count);
+    case COLUMN_KERNEL_TIME: return SelectTop(m_kernelTime, count);
+    case COLUMN_USER_TIME: return SelectTop(m_userTime, count);
+    case COLUMN_CPU_USAGE: return SelectTop(m_cpuUsage, count);
+    case COLUMN_MEMORY_GROWTH: return SelectTop(m_memoryGrowth, count);
+    }
+    return {};
+}
+
+std::vector<size_t> ProcessTable::SortedRows(Column column, bool descending) const {
+    std::vector<size_t> rows;
+    switch (column) {
+    case COLUMN_MEMORY: rows = SortAll(m_memory); break;
+    case COLUMN_KERNEL_TIME: rows = SortAll(m_kernelTime); break;
+    case COLUMN_USER_TIME: rows = SortAll(m_userTime); break;
+    case COLUMN_CPU_USAGE: rows = SortAll(m_cpuUsage); break;
+    case COLUMN_MEMORY_GROWTH: rows = SortAll(m_memoryGrowth); break;
+    }
+    if (!descending) {
+        std::reverse(rows.begin(), rows.end());
+    }
+    return rows;
+}
+
+ProcessSummary ProcessTable::Summarize() const {
+    ProcessSummary summary;
+    summary.processCount = Size();
+    summary.totalMemory = ColumnSum(m_memory);
+    summary.maxMemory = ColumnMax(m_memory);
+    summary.totalKernelTime = ColumnSum(m_kernelTime);
+    summary.totalUserTime = ColumnSum(m_userTime);
+    summary.totalCpuUsage = ColumnSum(m_cpuUsage);
+    summary.maxCpuUsage = ColumnMax(m_cpuUsage);
+    return summary;
+}
@@ -0,0 +1,59 @@
+﻿// ProcessTable.h
+#pragma once
+#include "ProcessCollector.h"
+#include <cstdint>
+#include <vector>
+
+// 进程快照汇总
+struct ProcessSummary {
+    size_t processCount = 0;
+    ULONGLONG totalMemory = 0;
+    ULONGLONG maxMemory = 0;
+    ULONGLONG totalKernelTime = 0;   // 100 纳秒
+    ULONGLONG totalUserTime = 0;
+    double totalCpuUsage = 0.0;      // 各进程 CPU 使用率之和（%）
+    double maxCpuUsage = 0.0;
+};
+
+// 进程数值字段的列式副本（按列连续存储），汇总、筛选与排序只访问所需的列，
+// 不必遍历带有多个字符串的 ProcessInfo。行号与构建时的快照下标一致。
+class ProcessTable {
+public:
+    enum Column {
+        COLUMN_MEMORY,          // 工作集（字节）
+        COLUMN_KERNEL_TIME,     // 内核时间（100 纳秒）
+        COLUMN_USER_TIME,       // 用户时间（100 纳秒）
+        COLUMN_CPU_USAGE,       // CPU 使用率（%）
+        COLUMN_MEMORY_GROWTH    // 内存增长速度（字节/秒）
+    };
+
+    void Build(const std::vector<ProcessInfo>& processes);
+    void Clear();
+    size_t Size() const { return m_pids.size(); }
+
+    DWORD GetPid(size_t row) const { return m_pids[row]; }
+    DWORD GetParentPid(size_t row) const { return m_parentPids[row]; }
+
+    double Sum(Column column) const;
+    double Min(Column column) const;
+    double Max(Column column) const;
+
+    // 阈值掩码：值 >= threshold 的行置 1，其余置 0，返回满足条件的行数
+    size_t Mask(Column column, double threshold, std::vector<uint8_t>& mask) const;
+
+    // 按列取值最大的前 count 行（降序），只对前 count 行排序
+    std::vector<size_t> TopN(Column column, size_t count) const;
+    // 按列排序后的全部行号
+    std::vector<size_t> SortedRows(Column column, bool descending) const;
+
+    ProcessSummary Summarize() const;
+
+private:
+    std::vector<DWORD> m_pids;
+    std::vector<DWORD> m_parentPids;
+    std::vector<ULONGLONG> m_memory;
+    std::vector<ULONGLONG> m_kernelTime;
+    std::vector<ULONGLONG> m_userTime;
+    std::vector<double> m_cpuUsage;
+    std::vector<double> m_memoryGrowth;
+};
@@ -0,0 +1,177 @@
+﻿// ProcessTree.cpp
+#include "ProcessTree.h"
+#include <algorithm>
+
+namespace {
+    ULONGLONG GetCpuTime(const ProcessInfo& info) {
+        return FileTimeToUInt64(info.kernelTime) + FileTimeToUInt64(info.userTime);
+    }
+}
+
+void ProcessTree::Apply(const std::vector<ProcessInfo>& processes, const ProcessDelta& delta) {
+    // 先删除退出的进程，PID 复用时旧节点需先于新节点处理
+    for (const auto& info : delta.removed) {
+        RemoveNode(info);
+    }
+
+    // 新进程先全部插入再建立父子关系：同一批中子进程可能排在父进程之前
+    for (size_t index : delta.added) {
+        InsertNode(processes[index]);
+    }
+    for (size_t index : delta.added) {
+        Link(processes[index].pid);
+    }
+
+    for (const auto& change : delta.changed) {
+        UpdateNode(processes[change.index], change.changedFields);
+    }
+}
+
+void ProcessTree::Clear() {
+    m_nodes.clear();
+}
+
+const ProcessTreeNode* ProcessTree::FindNode(DWORD pid) const {
+    auto it = m_nodes.find(pid);
+    return it != m_nodes.end() ? &it->second : nullptr;
+}
+
+std::vector<DWORD> ProcessTree::GetRoots() const {
+    std::vector<DWORD> roots;
+    for (const auto& entry : m_nodes) {
+        if (!entry.second.linked) {
+            roots.push_back(entry.first);
+        }
+    }
+    std::sort(roots.begin(), roots.end());
+    return roots;
+}
+
+void ProcessTree::InsertNode(const ProcessInfo& info) {
+    ProcessTreeNode& node = m_nodes[info.pid];
+    node = ProcessTreeNode();
+    node.key = MakeProcessKey(info);
+    node.parentPid = info.parentPid;
+    node.processName = info.processName;
+    node.memoryUsage = info.memoryUsage;
+    node.cpuTime = GetCpuTime(info);
+    node.subtreeMemory = node.memoryUsage;
+    node.subtreeCpuTime = node.cpuTime;
+}
+
+void ProcessTree::RemoveNode(const ProcessInfo& info) {
+    auto it = m_nodes.find(info.pid);
+    if (it == m_nodes.end() || !(it->second.key == MakeProcessKey(info))) {
+        return;
+    }
+
+    Unlink(info.pid);
+
+    // 子进程成为孤儿，各自的子树保持不变
+    for (DWORD childPid : it->second.children) {
+        auto child = m_nodes.find(childPid);
+        if (child != m_nodes.end()) {
+            child->second.linked = false;
+        }
+    }
+    m_nodes.erase(it);
+}
+
+void ProcessTree::UpdateNode(const ProcessInfo& info, DWORD changedFields) {
+    auto it = m_nodes.find(info.pid);
+    if (it == m_nodes.end()) {
+        return;
+    }
+
+    ProcessTreeNode& node = it->second;
+    if (changedFields & PROCESS_CHANGED_IMAGE) {
+        node.key = MakeProcessKey(info);
+        node.processName = info.processName;
+    }
+
+    ULONGLONG memory = info.memoryUsage;
+    ULONGLONG cpuTime = GetCpuTime(info);
+    if (memory != node.memoryUsage || cpuTime != node.cpuTime) {
+        ULONGLONG memoryDelta = memory - node.memoryUsage;
+        ULONGLONG cpuDelta = cpuTime - node.cpuTime;
+        node.memoryUsage = memory;
+        node.cpuTime = cpuTime;
+        PropagateUp(info.pid, memoryDelta, cpuDelta, 0);
+    }
+
+    if ((changedFields & PROCESS_CHANGED_PARENT) && info.parentPid != node.parentPid) {
+        // 父进程退出后被收养（Linux 上由 init 或 subreaper 接管），整棵子树迁移到新父节点下
+        Unlink(info.pid);
+        m_nodes[info.pid].parentPid = info.parentPid;
+        Link(info.pid);
+    }
+}
+
+void ProcessTree::Link(DWORD pid) {
+    ProcessTreeNode& node = m_nodes[pid];
+    if (node.linked || !CanAdopt(node.parentPid, pid)) {
+        return;
+    }
+
+    ProcessTreeNode& parent = m_nodes[node.parentPid];
+    parent.children.push_back(pid);
+    node.linked = true;
+    PropagateUp(node.parentPid, node.subtreeMemory, node.subtreeCpuTime, node.descendantCount + 1);
+}
+
+void ProcessTree::Unlink(DWORD pid) {
+    ProcessTreeNode& node = m_nodes[pid];
+    if (!node.linked) {
+        return;
+    }
+
+    auto parent = m_nodes.find(node.parentPid);
+    if (parent != m_nodes.end()) {
+        auto& siblings = parent->second.children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), pid), siblings.end());
+        PropagateUp(node.parentPid, 0 - node.subtreeMemory, 0 - node.subtreeCpuTime,
+            0 - (node.descendantCount + 1));
+    }
+    node.linked = false;
+}
+
+bool ProcessTree::CanAdopt(DWORD parentPid, DWORD childPid) const {
+    if (parentPid == childPid) {
+        return false;  // 如 Windows 的 System Idle Process，父 PID 即自身
+    }
+
+    auto parent = m_nodes.find(parentPid);
+    auto child = m_nodes.find(childPid);
+    if (parent == m_nodes.end() || child == m_nodes.end()) {
+        return false;
+    }
+
+    // 父进程晚于子进程创建，说明父 PID 已被复用；创建时间未知（无权访问）时不做判断
+    ULONGLONG parentCreateTime = parent->second.key.createTime;
+    ULONGLONG childCreateTime = child->second.key.createTime;
+    if (parentCreateTime != 0 && childCreateTime != 0 && parentCreateTime > childCreateTime) {
+        return false;
+    }
+
+    // 创建时间未知时仍可能成环，沿祖先链确认子进程不是父进程的祖先
+    for (auto it = parent; it != m_nodes.end() && it->second.linked; it = m_nodes.find(it->second.parentPid)) {
+        if (it->second.parentPid == childPid) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ProcessTree::PropagateUp(DWORD pid, ULONGLONG memoryDelta, ULONGLONG cpuDelta, DWORD countDelta) {
+    auto it = m_nodes.find(pid);
+    while (it != m_nodes.end()) {
+        ProcessTreeNode& node = it->second;
+        node.subtreeMemory += memoryDelta;
+        node.subtreeCpuTime += cpuDelta;
+        node.descendantCount += countDelta;
+        if (!node.linked) {
+            break;
+        }
+        it = m_nodes.find(node.parentPid);
+    }
+}
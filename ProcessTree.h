@@ -0,0 +1,49 @@
+﻿// ProcessTree.h
+#pragma once
+#include "ProcessCollector.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 进程树节点，子树统计值均包含节点自身
+struct ProcessTreeNode {
+    ProcessKey key;
+    DWORD parentPid = 0;            // 进程报告的父 PID
+    bool linked = false;            // 是否挂在父节点下；父进程已退出或身份不符时为根节点（孤儿）
+    InternedString processName;
+    std::vector<DWORD> children;
+
+    ULONGLONG memoryUsage = 0;
+    ULONGLONG cpuTime = 0;          // 内核时间 + 用户时间（100 纳秒）
+    ULONGLONG subtreeMemory = 0;
+    ULONGLONG subtreeCpuTime = 0;
+    DWORD descendantCount = 0;      // 子孙进程数（不含自身）
+};
+
+// 进程树索引：根据每次刷新的 ProcessDelta 增量维护父子关系与子树统计，
+// 单个进程变化只沿祖先链更新，代价为 O(深度)，无需每次全量重建。
+// 父进程必须早于子进程创建才会建立父子关系，避免把复用了父 PID 的新进程误认作父进程。
+class ProcessTree {
+public:
+    // processes 为本次快照，delta 为 ProcessCollector 输出的对应变化
+    void Apply(const std::vector<ProcessInfo>& processes, const ProcessDelta& delta);
+    void Clear();
+
+    const ProcessTreeNode* FindNode(DWORD pid) const;
+    // 根节点（无父进程或孤儿进程）的 PID，按 PID 升序
+    std::vector<DWORD> GetRoots() const;
+    size_t GetNodeCount() const { return m_nodes.size(); }
+
+private:
+    void InsertNode(const ProcessInfo& info);
+    void RemoveNode(const ProcessInfo& info);
+    void UpdateNode(const ProcessInfo& info, DWORD changedFields);
+
+    void Link(DWORD pid);
+    void Unlink(DWORD pid);
+    bool CanAdopt(DWORD parentPid, DWORD childPid) const;
+    // 从 pid 起沿祖先链累加子树统计（无符号回绕，可表示减少）
+    void PropagateUp(DWORD pid, ULONGLONG memoryDelta, ULONGLONG cpuDelta, DWORD countDelta);
+
+    std::unordered_map<DWORD, ProcessTreeNode> m_nodes;
+};
@@ -0,0 +1,296 @@
+﻿// SampleRing.h
+#pragma once
+#include "PlatformCompat.h"
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// 单生产者多读者的无锁环形缓冲区，保存最近 capacity 个定长样本。
+// 写入方从不等待读者：写满后覆盖最旧的样本。每个槽位带序号（奇数表示正在写入），
+// 读者复制样本前后各读一次序号，不一致说明读取期间被覆盖，丢弃后重试。
+// 样本按 8 字节分块存放在原子变量中，读写都不存在数据竞争。
+// 每个读者持有自己的 Cursor，互不影响；读者落后超过一圈时跳到仍然有效的最旧样本并累计丢弃数
+template <typename T>
+class SampleRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SampleRing 只能保存可平凡复制的样本");
+
+public:
+    // 读者位置：next 为下一个要读取的样本序号（从 0 开始单调递增）
+    struct Cursor {
+        ULONGLONG next = 0;
+        ULONGLONG dropped = 0;   // 因落后被覆盖而错过的样本数
+    };
+
+    // capacity 向上取整为 2 的幂
+    explicit SampleRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_slots.reset(new Slot[size]);
+    }
+
+    SampleRing(const SampleRing&) = delete;
+    SampleRing& operator=(const SampleRing&) = delete;
+
+    size_t GetCapacity() const { return m_mask + 1; }
+    // 已写入的样本总数（含已被覆盖的）
+    ULONGLONG GetWriteCount() const { return m_head.load(std::memory_order_acquire); }
+
+    // 仅限唯一的生产者线程调用
+    void Push(const T& sample) {
+        ULONGLONG index = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[index & m_mask];
+
+        WordBuffer words;
+        std::memcpy(words.data, &sample, sizeof(T));
+
+        slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            slot.words[i].store(words.data[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store(index * 2 + 2, std::memory_order_release);
+        m_head.store(index + 1, std::memory_order_release);
+    }
+
+    // 从最新的样本之后开始读取（只关心此后的新样本）
+    Cursor CreateCursor() const {
+        Cursor cursor;
+        cursor.next = GetWriteCount();
+        return cursor;
+    }
+
+    // 从仍然保留的最旧样本开始读取
+    Cursor CreateCursorAtOldest() const {
+        Cursor cursor;
+        ULONGLONG head = GetWriteCount();
+        cursor.next = head > GetCapacity() ? head - GetCapacity() : 0;
+        return cursor;
+    }
+
+    // 读取 cursor 处的样本并前进；没有新样本时返回 false
+    bool Read(Cursor& cursor, T& sample) const {
+        for (;;) {
+            ULONGLONG head = m_head.load(std::memory_order_acquire);
+            if (cursor.next >= head) {
+                return false;
+            }
+            if (head - cursor.next > GetCapacity()) {
+                ULONGLONG oldest = head - GetCapacity();
+                cursor.dropped += oldest - cursor.next;
+                cursor.next = oldest;
+            }
+            if (TryLoad(cursor.next, sample)) {
+                ++cursor.next;
+                return true;
+            }
+            // 读取期间被覆盖：该样本已丢失，重新按最新的 head 定位
+            ++cursor.dropped;
+            ++cursor.next;
+        }
+    }
+
+    // 读取最新的样本，不影响任何读者
+    bool ReadLatest(T& sample) const {
+        for (;;) {
+            ULONGLONG head = m_head.load(std::memory_order_acquire);
+            if (head == 0) {
+                return false;
+            }
+            if (TryLoad(head - 1, sample)) {
+                return true;
+            }
+        }
+    }
+
+    // 按时间顺序取最近至多 count 个样本（覆盖 samples 原有内容，复用其容量），返回取到的个数
+    size_t ReadRecent(size_t count, std::vector<T>& samples) const {
+        samples.clear();
+        Cursor cursor = CreateCursorAtOldest();
+        ULONGLONG head = GetWriteCount();
+        if (count < head - cursor.next) {
+            cursor.next = head - count;
+        }
+        T sample;
+        while (cursor.next < head && Read(cursor, sample)) {
+            samples.push_back(sample);
+        }
+        return samples.size();
+    }
+
+private:
+    static const size_t kWords = (sizeof(T) + sizeof(ULONGLONG) - 1) / sizeof(ULONGLONG);
+
+    struct WordBuffer {
+        ULONGLONG data[kWords] = {};
+    };
+
+    struct Slot {
+        std::atomic<ULONGLONG> sequence{ 0 };   // 2 * 序号 + 2 表示写入完成，奇数表示正在写入
+        std::atomic<ULONGLONG> words[kWords] = {};
+    };
+
+    // 序号为 index 的样本仍完整保存在槽位中时复制出来
+    bool TryLoad(ULONGLONG index, T& sample) const {
+        const Slot& slot = m_slots[index & m_mask];
+        ULONGLONG expected = index * 2 + 2;
+        if (slot.sequence.load(std::memory_order_acquire) != expected) {
+            return false;
+        }
+        WordBuffer words;
+        for (size_t i = 0; i < kWords; ++i) {
+            words.data[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+            return false;
+        }
+        std::memcpy(&sample, words.data, sizeof(T));
+        return true;
+    }
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<ULONGLONG> m_head{ 0 };   // 下一个写入的样本序号
+};
+
+// 与 SampleRing 相同的单生产者多读者环形缓冲区，但每个样本是一个带时间戳的 T 数组，
+// 数组长度（如逻辑处理器数）在运行时才知道。每个槽位按 stride 个元素分配，stride 由生产者在
+// Reserve 或 Push 时按需要扩大；扩大时换用新的存储区（已保存的样本随之丢弃），
+// 读者通过 shared_ptr 持有自己读取时的存储区，不会读到已释放的内存。
+template <typename T>
+class SampleArrayRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SampleArrayRing 只能保存可平凡复制的元素");
+
+public:
+    struct Sample {
+        ULONGLONG timestamp = 0;
+        std::vector<T> items;
+    };
+
+    // capacity 向上取整为 2 的幂；stride 为 0 时在第一次写入时按样本长度分配
+    explicit SampleArrayRing(size_t capacity, size_t stride = 0) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        if (stride > 0) {
+            Reserve(stride);
+        }
+    }
+
+    SampleArrayRing(const SampleArrayRing&) = delete;
+    SampleArrayRing& operator=(const SampleArrayRing&) = delete;
+
+    size_t GetCapacity() const { return m_mask + 1; }
+    // 当前每个样本最多能保存的元素数
+    size_t GetStride() const {
+        std::shared_ptr<const Storage> storage = std::atomic_load(&m_storage);
+        return storage ? storage->stride : 0;
+    }
+    ULONGLONG GetWriteCount() const { return m_head.load(std::memory_order_acquire); }
+
+    // 仅限生产者线程调用：保证每个槽位至少能保存 stride 个元素
+    void Reserve(size_t stride) {
+        std::shared_ptr<const Storage> storage = std::atomic_load(&m_storage);
+        if (storage && storage->stride >= stride) {
+            return;
+        }
+        auto replacement = std::make_shared<Storage>();
+        replacement->stride = stride;
+        replacement->slotWords = 2 + stride * kItemWords;
+        replacement->sequences.reset(new std::atomic<ULONGLONG>[GetCapacity()]());
+        replacement->words.reset(new std::atomic<ULONGLONG>[GetCapacity() * replacement->slotWords]());
+        std::atomic_store(&m_storage, std::shared_ptr<const Storage>(std::move(replacement)));
+    }
+
+    // 仅限唯一的生产者线程调用；count 超过当前 stride 时先扩大（不会截断样本）
+    void Push(ULONGLONG timestamp, const T* items, size_t count) {
+        Reserve(count);
+        std::shared_ptr<const Storage> storage = std::atomic_load(&m_storage);
+        ULONGLONG index = m_head.load(std::memory_order_relaxed);
+        std::atomic<ULONGLONG>& sequence = storage->sequences[index & m_mask];
+        std::atomic<ULONGLONG>* words = &storage->words[(index & m_mask) * storage->slotWords];
+
+        sequence.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        words[0].store(count, std::memory_order_relaxed);
+        words[1].store(timestamp, std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            ItemWords buffer;
+            std::memcpy(buffer.data, &items[i], sizeof(T));
+            for (size_t w = 0; w < kItemWords; ++w) {
+                words[2 + i * kItemWords + w].store(buffer.data[w], std::memory_order_relaxed);
+            }
+        }
+        sequence.store(index * 2 + 2, std::memory_order_release);
+        m_head.store(index + 1, std::memory_order_release);
+    }
+
+    // 按时间顺序取最近至多 count 个样本（覆盖 samples 原有内容，复用各样本数组的容量），返回取到的个数
+    size_t ReadRecent(size_t count, std::vector<Sample>& samples) const {
+        std::shared_ptr<const Storage> storage = std::atomic_load(&m_storage);
+        ULONGLONG head = GetWriteCount();
+        ULONGLONG first = head > GetCapacity() ? head - GetCapacity() : 0;
+        if (count < head - first) {
+            first = head - count;
+        }
+        samples.resize(storage ? static_cast<size_t>(head - first) : 0);
+        size_t read = 0;
+        for (ULONGLONG index = first; storage && index < head; ++index) {
+            // 读取期间被覆盖（或存储区已更换）的样本直接跳过
+            read += TryLoad(*storage, index, samples[read]);
+        }
+        samples.resize(read);
+        return read;
+    }
+
+private:
+    static const size_t kItemWords = (sizeof(T) + sizeof(ULONGLONG) - 1) / sizeof(ULONGLONG);
+
+    struct ItemWords {
+        ULONGLONG data[kItemWords] = {};
+    };
+
+    // 槽位布局：元素数、时间戳、stride 个元素（各占 kItemWords 个字）
+    struct Storage {
+        size_t stride = 0;
+        size_t slotWords = 0;
+        std::unique_ptr<std::atomic<ULONGLONG>[]> sequences;   // 含义同 SampleRing::Slot::sequence
+        std::unique_ptr<std::atomic<ULONGLONG>[]> words;
+    };
+
+    bool TryLoad(const Storage& storage, ULONGLONG index, Sample& sample) const {
+        const std::atomic<ULONGLONG>& sequence = storage.sequences[index & m_mask];
+        const std::atomic<ULONGLONG>* words = &storage.words[(index & m_mask) * storage.slotWords];
+        ULONGLONG expected = index * 2 + 2;
+        if (sequence.load(std::memory_order_acquire) != expected) {
+            return false;
+        }
+        ULONGLONG count = words[0].load(std::memory_order_relaxed);
+        if (count > storage.stride) {
+            return false;
+        }
+        sample.timestamp = words[1].load(std::memory_order_relaxed);
+        sample.items.resize(static_cast<size_t>(count));
+        for (size_t i = 0; i < count; ++i) {
+            ItemWords buffer;
+            for (size_t w = 0; w < kItemWords; ++w) {
+                buffer.data[w] = words[2 + i * kItemWords + w].load(std::memory_order_relaxed);
+            }
+            std::memcpy(&sample.items[i], buffer.data, sizeof(T));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) == expected;
+    }
+
+    std::shared_ptr<const Storage> m_storage;   // 只由生产者替换，读写都经 std::atomic_load/atomic_store
+    size_t m_mask = 0;
+    alignas(64) std::atomic<ULONGLONG> m_head{ 0 };
+};
@@ -2,8 +2,15 @@
 #include "ServiceCollector.h"
 #include <iostream>
 #include <string>
+#include <chrono>
 
-ServiceCollector::ServiceCollector() : m_scmHandle(NULL) {}
+ServiceCollector::ServiceCollector()
+    : m_source(CreateServiceSource()), m_initialized(false),
+    m_generation(0), m_configReconcileInterval(300), m_lastConfigQueryCount(0) {}
+
+ServiceCollector::ServiceCollector(std::unique_ptr<IServiceSource> source)
+    : m_source(std::move(source)), m_initialized(false),
+    m_generation(0), m_configReconcileInterval(300), m_lastConfigQueryCount(0) {}
 
 ServiceCollector::~ServiceCollector() {
     Cleanup();
@@ -24,165 +31,150 @@ std::wstring ServiceCollector::StartTypeToString(DWORD startType) {
 }
 
 bool ServiceCollector::Initialize() {
-    m_scmHandle = OpenSCManager(NULL, NULL, SC_MANAGER_ENUMERATE_SERVICE);
-    return m_scmHandle != NULL;
+    m_initialized = m_source && m_source->Initialize();
+    if (m_initialized && !m_controller) {
+        m_controller = std::make_unique<ServiceController>(*m_source);
+    }
+    return m_initialized;
 }
 
 void ServiceCollector::Cleanup() {
-    if (m_scmHandle) {
-        CloseServiceHandle(m_scmHandle);
-        m_scmHandle = NULL;
+    // 先结束控制器中未完成的操作，再释放数据源
+    m_controller.reset();
+    if (m_source) {
+        m_source->Cleanup();
     }
+    m_initialized = false;
 }
 
 bool ServiceCollector::CollectServices(std::vector<ServiceInfo>& services) {
-    if (!m_scmHandle) {
+    std::vector<ServiceConfigChange> changes;
+    return CollectServices(services, changes);
+}
+
+bool ServiceCollector::CollectServices(std::vector<ServiceInfo>& services, std::vector<ServiceConfigChange>& changes) {
+    if (!m_initialized) {
         return false;
     }
 
     services.clear();
 
-    // 获取服务数量和大小
-    DWORD bytesNeeded = 0;
-    DWORD servicesReturned = 0;
-    DWORD resumeHandle = 0;
-
-    if (!EnumServicesStatusExW(
-        m_scmHandle,
-        SC_ENUM_PROCESS_INFO,
-        SERVICE_WIN32 | SERVICE_DRIVER,
-        SERVICE_STATE_ALL,
-        NULL,
-        0,
-        &bytesNeeded,
-        &servicesReturned,
-        &resumeHandle,
-        NULL
-    )) {
-        if (GetLastError() != ERROR_MORE_DATA) {
-            return false;
-        }
+    if (!m_source->EnumerateServices(services)) {
+        return false;
     }
 
-    // 分配内存并再次调用获取服务信息
-    std::vector<unsigned char> buffer(bytesNeeded);
-    if (!EnumServicesStatusExW(
-        m_scmHandle,
-        SC_ENUM_PROCESS_INFO,
-        SERVICE_WIN32 | SERVICE_DRIVER,
-        SERVICE_STATE_ALL,
-        buffer.data(),
-        bytesNeeded,
-        &bytesNeeded,
-        &servicesReturned,
-        &resumeHandle,
-        NULL
-    )) {
-        return false;
+    ++m_generation;
+    auto now = std::chrono::steady_clock::now();
+    bool reconcile = now - m_lastConfigReconcile >= std::chrono::seconds(m_configReconcileInterval);
+    if (reconcile) {
+        m_lastConfigReconcile = now;
     }
 
-    // 处理每个服务
-    ENUM_SERVICE_STATUS_PROCESSW* servicesBuffer =
-        reinterpret_cast<ENUM_SERVICE_STATUS_PROCESSW*>(buffer.data());
-
-    for (DWORD i = 0; i < servicesReturned; ++i) {
-        ServiceInfo service;
-        service.serviceName = servicesBuffer[i].lpServiceName;
-        service.displayName = servicesBuffer[i].lpDisplayName;
-        service.status = servicesBuffer[i].ServiceStatusProcess.dwCurrentState;
-
-        // 获取服务启动类型和二进制路径
-        SC_HANDLE serviceHandle = OpenServiceW(
-            m_scmHandle,
-            servicesBuffer[i].lpServiceName,
-            SERVICE_QUERY_CONFIG
-        );
-
-        if (serviceHandle) {
-            // 获取服务配置信息
-            DWORD configBytesNeeded = 0;
-            QueryServiceConfigW(serviceHandle, NULL, 0, &configBytesNeeded);
-
-            std::vector<unsigned char> configBuffer(configBytesNeeded);
-            LPQUERY_SERVICE_CONFIGW config =
-                reinterpret_cast<LPQUERY_SERVICE_CONFIGW>(configBuffer.data());
-
-            if (QueryServiceConfigW(serviceHandle, config, configBytesNeeded, &configBytesNeeded)) {
-                service.startType = config->dwStartType;
-                service.binaryPath = config->lpBinaryPathName;
-
-                // 新增：设置启动类型字符串
-                service.startTypeStr = StartTypeToString(config->dwStartType);
+    size_t queryCount = 0;
+    std::wstring binaryPath;
+    std::vector<std::wstring> dependencies;
+    for (auto& service : services) {
+        auto result = m_configCache.try_emplace(service.serviceName);
+        CachedConfig& cached = result.first->second;
+        cached.lastSeen = m_generation;
+
+        // 状态变化（如服务重启）或配置版本号变化时配置可能已被修改
+        bool needQuery = result.second || reconcile ||
+            cached.status != service.status || cached.configGeneration != service.configGeneration;
+        cached.status = service.status;
+        cached.configGeneration = service.configGeneration;
+
+        if (needQuery) {
+            ++queryCount;
+            DWORD startType = SERVICE_TYPE_UNKNOWN;
+            binaryPath.clear();
+            dependencies.clear();
+            if (m_source->QueryServiceConfigByName(service.serviceName, startType, binaryPath, dependencies)) {
+                InternedString newBinaryPath(binaryPath);
+                std::vector<InternedString> newDependencies(dependencies.begin(), dependencies.end());
+                if (cached.valid) {
+                    ServiceConfigChange change;
+                    if (startType != cached.startType) {
+                        change.changedFields |= SERVICE_CONFIG_CHANGED_START_TYPE;
+                    }
+                    if (newBinaryPath != cached.binaryPath) {
+                        change.changedFields |= SERVICE_CONFIG_CHANGED_BINARY_PATH;
+                    }
+                    if (newDependencies != cached.dependencies) {
+                        change.changedFields |= SERVICE_CONFIG_CHANGED_DEPENDENCIES;
+                    }
+                    if (change.changedFields) {
+                        change.serviceName = service.serviceName;
+                        change.oldStartType = cached.startType;
+                        change.newStartType = startType;
+                        change.oldBinaryPath = cached.binaryPath;
+                        change.newBinaryPath = newBinaryPath;
+                        changes.push_back(std::move(change));
+                    }
+                }
+                cached.startType = startType;
+                cached.binaryPath = newBinaryPath;
+                cached.dependencies = std::move(newDependencies);
+                cached.valid = true;
             }
-            else {
-                // 如果获取配置失败，设置为未知类型
-                service.startType = SERVICE_TYPE_UNKNOWN;
-                service.startTypeStr = L"未知";
+            else if (!cached.valid) {
+                // 查询失败时保留上次成功的配置，等待下次状态变化或校正时重试
+                cached.startType = SERVICE_TYPE_UNKNOWN;
+                cached.binaryPath = InternedString();
+                cached.dependencies.clear();
             }
+        }
 
-            CloseServiceHandle(serviceHandle);
+        service.startType = cached.startType;
+        service.binaryPath = cached.binaryPath;
+        service.dependencies = cached.dependencies;
+        service.startTypeStr = StartTypeToString(service.startType);
+    }
+
+    // 移除已卸载的服务
+    for (auto it = m_configCache.begin(); it != m_configCache.end();) {
+        if (it->second.lastSeen != m_generation) {
+            it = m_configCache.erase(it);
         }
         else {
-            // 如果无法获取服务句柄，设置默认值
-            service.startType = SERVICE_TYPE_UNKNOWN;
-            service.startTypeStr = L"未知";
-            service.binaryPath = L"";
+            ++it;
         }
-
-        services.push_back(service);
     }
 
+    m_lastConfigQueryCount = queryCount;
+    m_dependencyGraph.Build(services);
     return true;
 }
 
-bool ServiceCollector::StartService(const std::wstring& serviceName) {
-    if (!m_scmHandle) {
-        return false;
-    }
-
-    SC_HANDLE serviceHandle = OpenServiceW(
-        m_scmHandle,
-        serviceName.c_str(),
-        SERVICE_START
-    );
+void ServiceCollector::SetConfigReconcileInterval(int seconds) {
+    m_configReconcileInterval = seconds > 0 ? seconds : 1;
+}
 
-    if (!serviceHandle) {
+// 同步控制统一走控制器，失败原因输出到 std::cerr
+static bool WaitForOperation(ServiceController* controller, const std::wstring& serviceName, ServiceOperationType type) {
+    if (!controller) {
         return false;
     }
+    ServiceOperationOutcome outcome = controller->Submit(serviceName, type).get();
+    if (outcome.result == SERVICE_OPERATION_TIMED_OUT) {
+        std::cerr << "Service control timed out: " << WideToUtf8(serviceName)
+            << " (status " << outcome.finalStatus << ")" << std::endl;
+    }
+    else if (outcome.result == SERVICE_OPERATION_FAILED) {
+        std::cerr << "Service control failed: " << WideToUtf8(serviceName) << std::endl;
+    }
+    return outcome.Succeeded();
+}
 
-    bool result = ::StartServiceW(serviceHandle, 0, NULL) != 0;
-    CloseServiceHandle(serviceHandle);
-    return result;
+bool ServiceCollector::StartService(const std::wstring& serviceName) {
+    return m_initialized && WaitForOperation(m_controller.get(), serviceName, SERVICE_OPERATION_START);
 }
 
 bool ServiceCollector::StopService(const std::wstring& serviceName) {
-    if (!m_scmHandle) {
-        return false;
-    }
-
-    SC_HANDLE serviceHandle = OpenServiceW(
-        m_scmHandle,
-        serviceName.c_str(),
-        SERVICE_STOP | SERVICE_QUERY_STATUS
-    );
-
-    if (!serviceHandle) {
-        return false;
-    }
-
-    SERVICE_STATUS serviceStatus;
-    bool result = ControlService(serviceHandle, SERVICE_CONTROL_STOP, &serviceStatus) != 0;
-    CloseServiceHandle(serviceHandle);
-    return result;
+    return m_initialized && WaitForOperation(m_controller.get(), serviceName, SERVICE_OPERATION_STOP);
 }
 
+// 停止并确认到达 STOPPED 后再启动
 bool ServiceCollector::RestartService(const std::wstring& serviceName) {
-    if (!StopService(serviceName)) {
-        return false;
-    }
-
-    // 等待服务停止
-    Sleep(1000);
-
-    return StartService(serviceName);
-}
\ No newline at end of file
+    return m_initialized && WaitForOperation(m_controller.get(), serviceName, SERVICE_OPERATION_RESTART);
+}
@@ -2,10 +2,35 @@
 #ifndef SERVICECOLLECTOR_H
 #define SERVICECOLLECTOR_H
 
-#include <windows.h>
-#include <winsvc.h>
+#include "PlatformCompat.h"
+#include "ServiceSource.h"
+#include "ServiceController.h"
+#include "ServiceDependencyGraph.h"
+#include "StringPool.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <unordered_map>
+#include <chrono>
+
+#ifdef _WIN32
+#include <winsvc.h>
+#else
+// 非 Windows 平台沿用 SCM 的状态与启动类型取值，界面层无需区分平台
+#define SERVICE_STOPPED                0x00000001
+#define SERVICE_START_PENDING          0x00000002
+#define SERVICE_STOP_PENDING           0x00000003
+#define SERVICE_RUNNING                0x00000004
+#define SERVICE_CONTINUE_PENDING       0x00000005
+#define SERVICE_PAUSE_PENDING          0x00000006
+#define SERVICE_PAUSED                 0x00000007
+
+#define SERVICE_BOOT_START             0x00000000
+#define SERVICE_SYSTEM_START           0x00000001
+#define SERVICE_AUTO_START             0x00000002
+#define SERVICE_DEMAND_START           0x00000003
+#define SERVICE_DISABLED               0x00000004
+#endif
 // 安全检查：仅在未定义时添加
 #ifndef SERVICE_AUTO_START_DELAYED
 #define SERVICE_AUTO_START_DELAYED 0x00000020
@@ -15,36 +40,86 @@
 #define SERVICE_TYPE_UNKNOWN 0xFFFFFFFF
 #endif
 
-#pragma comment(lib, "advapi32.lib")
-
 
 
 struct ServiceInfo {
     std::wstring serviceName;
-    std::wstring displayName;
-    DWORD status;
-    DWORD startType;
+    InternedString displayName;
+    DWORD status = 0;
+    DWORD startType = SERVICE_TYPE_UNKNOWN;
     std::wstring startTypeStr;
-    std::wstring binaryPath;
+    InternedString binaryPath;
+    std::vector<InternedString> dependencies;   // 启动前必须运行的服务
+    DWORD configGeneration = 0;   // 数据源提供的配置版本号，配置被修改时递增；不支持时为 0
 
 };
 
+// 服务配置变化标记（ServiceConfigChange::changedFields）
+enum ServiceConfigChangeFlags : DWORD {
+    SERVICE_CONFIG_CHANGED_START_TYPE = 0x01,
+    SERVICE_CONFIG_CHANGED_BINARY_PATH = 0x02,   // 二进制路径被修改，常见的持久化手法，需要重点关注
+    SERVICE_CONFIG_CHANGED_DEPENDENCIES = 0x04
+};
+
+struct ServiceConfigChange {
+    std::wstring serviceName;
+    DWORD changedFields = 0;      // ServiceConfigChangeFlags 组合
+    DWORD oldStartType = SERVICE_TYPE_UNKNOWN;
+    DWORD newStartType = SERVICE_TYPE_UNKNOWN;
+    InternedString oldBinaryPath;
+    InternedString newBinaryPath;
+};
+
 class ServiceCollector {
 public:
     ServiceCollector();
+    // 使用指定的数据源（便于替换平台实现或注入测试数据）
+    explicit ServiceCollector(std::unique_ptr<IServiceSource> source);
     ~ServiceCollector();
-    std::wstring StartTypeToString(DWORD startType);
+    static std::wstring StartTypeToString(DWORD startType);
     bool Initialize();
     void Cleanup();
     
     bool CollectServices(std::vector<ServiceInfo>& services);
+    // 采集服务列表，同时输出相对缓存检测到的配置变化。
+    // 启动类型与二进制路径缓存在多次采集间复用，只有新服务、状态或配置版本号变化的服务，
+    // 以及每隔 SetConfigReconcileInterval 秒的全量校正时才重新查询配置
+    bool CollectServices(std::vector<ServiceInfo>& services, std::vector<ServiceConfigChange>& changes);
+    void SetConfigReconcileInterval(int seconds);
+    // 最近一次采集中实际查询配置的服务数
+    size_t GetLastConfigQueryCount() const { return m_lastConfigQueryCount; }
+    // 依赖图，随每次采集重建（包含建图时的服务状态）
+    const ServiceDependencyGraph& GetDependencyGraph() const { return m_dependencyGraph; }
     
+    // 同步控制：提交到控制器并等待结果，确认到达目标状态才返回 true。会阻塞调用线程，界面线程应使用 GetController()
     bool StartService(const std::wstring& serviceName);
     bool StopService(const std::wstring& serviceName);
     bool RestartService(const std::wstring& serviceName);
+    // 异步控制器，未初始化时返回 nullptr
+    ServiceController* GetController() const { return m_controller.get(); }
     
 private:
-    SC_HANDLE m_scmHandle;
+    // 缓存的服务配置及查询时的状态
+    struct CachedConfig {
+        DWORD status = 0;
+        DWORD configGeneration = 0;
+        DWORD startType = SERVICE_TYPE_UNKNOWN;
+        InternedString binaryPath;
+        std::vector<InternedString> dependencies;
+        bool valid = false;       // 配置查询成功
+        DWORD lastSeen = 0;       // 最近一次出现在枚举结果中的采集轮次
+    };
+
+    std::unique_ptr<IServiceSource> m_source;
+    std::unique_ptr<ServiceController> m_controller;   // 与采集共用 m_source
+    bool m_initialized;
+
+    std::unordered_map<std::wstring, CachedConfig> m_configCache;   // 服务名 -> 配置
+    DWORD m_generation;
+    int m_configReconcileInterval;
+    std::chrono::steady_clock::time_point m_lastConfigReconcile;
+    size_t m_lastConfigQueryCount;
+    ServiceDependencyGraph m_dependencyGraph;
 };
 
 #endif // SERVICECOLLECTOR_H    
\ No newline at end of file
@@ -0,0 +1,394 @@
+﻿// ServiceController.cpp
+#include "ServiceController.h"
+#include "ServiceCollector.h"
+#include <algorithm>
+
+namespace {
+    // 最小堆比较：nextAction 越早越靠前
+    struct LaterAction {
+        template <typename Ptr>
+        bool operator()(const Ptr& a, const Ptr& b) const { return a->nextAction > b->nextAction; }
+    };
+}
+
+ServiceController::ServiceController(IServiceSource& source, size_t workerCount)
+    : m_source(source),
+    m_pendingCount(0),
+    m_stop(false),
+    m_timeout(30000),
+    m_initialPollInterval(50),
+    m_maxPollInterval(1000) {
+    if (workerCount == 0) {
+        workerCount = 1;
+    }
+    m_threads.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_threads.emplace_back(&ServiceController::WorkerLoop, this);
+    }
+}
+
+ServiceController::~ServiceController() {
+    Shutdown();
+}
+
+std::future<ServiceOperationOutcome> ServiceController::Submit(const std::wstring& serviceName,
+    ServiceOperationType type, ServiceOperationCallback callback) {
+    OperationPtr operation = std::make_unique<Operation>();
+    operation->outcome.serviceName = serviceName;
+    operation->outcome.type = type;
+    operation->callback = std::move(callback);
+    operation->phase = type == SERVICE_OPERATION_START ? PHASE_ISSUE_START : PHASE_ISSUE_STOP;
+    operation->submitted = std::chrono::steady_clock::now();
+    operation->nextAction = operation->submitted;
+    std::future<ServiceOperationOutcome> future = operation->promise.get_future();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_stop) {
+        lock.unlock();
+        Finish(*operation, SERVICE_OPERATION_CANCELLED);
+        return future;
+    }
+
+    ++m_pendingCount;
+    auto result = m_serviceQueues.try_emplace(serviceName);
+    if (!result.second) {
+        // 同一服务上已有操作在执行，排在其后
+        result.first->second.push_back(std::move(operation));
+        return future;
+    }
+    ScheduleLocked(std::move(operation));
+    return future;
+}
+
+std::vector<std::future<ServiceOperationOutcome>> ServiceController::SubmitBatch(
+    const std::vector<std::wstring>& serviceNames, ServiceOperationType type, ServiceOperationCallback callback) {
+    std::vector<std::future<ServiceOperationOutcome>> futures;
+    futures.reserve(serviceNames.size());
+    for (const auto& serviceName : serviceNames) {
+        futures.push_back(Submit(serviceName, type, callback));
+    }
+    return futures;
+}
+
+// 计划的执行状态，由各步骤的完成回调共享
+struct ServiceController::PlanExecution {
+    std::mutex mutex;
+    ServiceOperationPlan plan;
+    ServiceOperationCallback stepCallback;
+    std::vector<std::vector<size_t>> successors;
+    std::vector<size_t> remaining;          // 尚未成功完成的前置步骤数
+    std::vector<char> skipped;
+    size_t unfinished = 0;
+    ServicePlanOutcome outcome;
+    std::promise<ServicePlanOutcome> promise;
+    std::chrono::steady_clock::time_point started;
+};
+
+std::future<ServicePlanOutcome> ServiceController::SubmitPlan(const ServiceOperationPlan& plan,
+    ServiceOperationCallback stepCallback) {
+    auto execution = std::make_shared<PlanExecution>();
+    execution->plan = plan;
+    execution->stepCallback = std::move(stepCallback);
+    execution->started = std::chrono::steady_clock::now();
+
+    size_t stepCount = plan.steps.size();
+    execution->successors.resize(stepCount);
+    execution->remaining.resize(stepCount);
+    execution->skipped.assign(stepCount, 0);
+    execution->unfinished = stepCount;
+    execution->outcome.steps.resize(stepCount);
+
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < stepCount; ++i) {
+        const auto& step = plan.steps[i];
+        execution->outcome.steps[i].serviceName = step.serviceName;
+        execution->outcome.steps[i].type = step.type;
+        execution->remaining[i] = step.prerequisites.size();
+        for (size_t prerequisite : step.prerequisites) {
+            execution->successors[prerequisite].push_back(i);
+        }
+        if (step.prerequisites.empty()) {
+            roots.push_back(i);
+        }
+    }
+
+    std::future<ServicePlanOutcome> future = execution->promise.get_future();
+    if (stepCount == 0) {
+        execution->promise.set_value(execution->outcome);
+        return future;
+    }
+
+    // 依赖关系全部建立后再提交，避免根步骤提前完成时后续步骤的计数尚未就绪
+    for (size_t root : roots) {
+        SubmitPlanStep(execution, root);
+    }
+    return future;
+}
+
+void ServiceController::SubmitPlanStep(const std::shared_ptr<PlanExecution>& execution, size_t index) {
+    const auto& step = execution->plan.steps[index];
+    Submit(step.serviceName, step.type,
+        [this, execution, index](const ServiceOperationOutcome& outcome) {
+            OnPlanStepFinished(execution, index, outcome);
+        });
+}
+
+void ServiceController::OnPlanStepFinished(const std::shared_ptr<PlanExecution>& execution, size_t index,
+    const ServiceOperationOutcome& outcome) {
+    std::vector<size_t> ready;
+    std::vector<size_t> skipped;
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> lock(execution->mutex);
+        execution->outcome.steps[index] = outcome;
+        --execution->unfinished;
+
+        if (outcome.Succeeded()) {
+            ++execution->outcome.succeededCount;
+            for (size_t successor : execution->successors[index]) {
+                if (--execution->remaining[successor] == 0 && !execution->skipped[successor]) {
+                    ready.push_back(successor);
+                }
+            }
+        }
+        else {
+            ++execution->outcome.failedCount;
+            // 跳过全部传递后续步骤
+            std::vector<size_t> pending(execution->successors[index]);
+            while (!pending.empty()) {
+                size_t successor = pending.back();
+                pending.pop_back();
+                if (execution->skipped[successor]) {
+                    continue;
+                }
+                execution->skipped[successor] = 1;
+                execution->outcome.steps[successor].result = SERVICE_OPERATION_SKIPPED;
+                ++execution->outcome.skippedCount;
+                --execution->unfinished;
+                skipped.push_back(successor);
+                pending.insert(pending.end(),
+                    execution->successors[successor].begin(), execution->successors[successor].end());
+            }
+        }
+
+        done = execution->unfinished == 0;
+        if (done) {
+            execution->outcome.elapsedMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - execution->started).count();
+        }
+    }
+
+    if (execution->stepCallback) {
+        execution->stepCallback(outcome);
+        for (size_t successor : skipped) {
+            execution->stepCallback(execution->outcome.steps[successor]);
+        }
+    }
+    for (size_t successor : ready) {
+        SubmitPlanStep(execution, successor);
+    }
+    if (done) {
+        execution->promise.set_value(execution->outcome);
+    }
+}
+
+void ServiceController::SetTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_timeout = timeout;
+}
+
+void ServiceController::SetPollInterval(std::chrono::milliseconds initial, std::chrono::milliseconds maximum) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_initialPollInterval = std::max(initial, std::chrono::milliseconds(1));
+    m_maxPollInterval = std::max(maximum, m_initialPollInterval);
+}
+
+size_t ServiceController::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pendingCount;
+}
+
+void ServiceController::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop && m_threads.empty()) {
+            return;
+        }
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_threads.clear();
+
+    // 工作线程已全部退出，剩余操作不再有并发访问
+    std::vector<OperationPtr> remaining;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        remaining = std::move(m_scheduled);
+        m_scheduled.clear();
+        for (auto& pair : m_serviceQueues) {
+            for (auto& operation : pair.second) {
+                remaining.push_back(std::move(operation));
+            }
+        }
+        m_serviceQueues.clear();
+        m_pendingCount = 0;
+    }
+    for (auto& operation : remaining) {
+        Finish(*operation, SERVICE_OPERATION_CANCELLED);
+    }
+}
+
+void ServiceController::ScheduleLocked(OperationPtr operation) {
+    m_scheduled.push_back(std::move(operation));
+    std::push_heap(m_scheduled.begin(), m_scheduled.end(), LaterAction());
+    m_condition.notify_one();
+}
+
+void ServiceController::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+        if (m_scheduled.empty()) {
+            m_condition.wait(lock);
+            continue;
+        }
+        auto due = m_scheduled.front()->nextAction;
+        if (due > std::chrono::steady_clock::now()) {
+            m_condition.wait_until(lock, due);
+            continue;
+        }
+
+        std::pop_heap(m_scheduled.begin(), m_scheduled.end(), LaterAction());
+        OperationPtr operation = std::move(m_scheduled.back());
+        m_scheduled.pop_back();
+
+        // 控制请求与状态查询可能阻塞，执行期间不持有锁
+        lock.unlock();
+        bool done = Step(*operation);
+        lock.lock();
+
+        if (!done) {
+            ScheduleLocked(std::move(operation));
+            continue;
+        }
+
+        // 启动同一服务上排队的下一个操作
+        auto queueIt = m_serviceQueues.find(operation->outcome.serviceName);
+        if (queueIt != m_serviceQueues.end()) {
+            if (queueIt->second.empty()) {
+                m_serviceQueues.erase(queueIt);
+            }
+            else {
+                OperationPtr next = std::move(queueIt->second.front());
+                queueIt->second.pop_front();
+                next->nextAction = std::chrono::steady_clock::now();
+                ScheduleLocked(std::move(next));
+            }
+        }
+        --m_pendingCount;
+
+        lock.unlock();
+        Finish(*operation, operation->outcome.result);
+        lock.lock();
+    }
+}
+
+bool ServiceController::Step(Operation& operation) {
+    auto now = std::chrono::steady_clock::now();
+    switch (operation.phase) {
+    case PHASE_ISSUE_STOP:
+        if (!m_source.StopServiceByName(operation.outcome.serviceName)) {
+            operation.outcome.result = SERVICE_OPERATION_FAILED;
+            return true;
+        }
+        BeginWait(operation, PHASE_WAIT_STOPPED, now);
+        return Poll(operation, now);
+
+    case PHASE_ISSUE_START:
+        if (!m_source.StartServiceByName(operation.outcome.serviceName)) {
+            operation.outcome.result = SERVICE_OPERATION_FAILED;
+            return true;
+        }
+        BeginWait(operation, PHASE_WAIT_RUNNING, now);
+        return Poll(operation, now);
+
+    default:
+        return Poll(operation, now);
+    }
+}
+
+void ServiceController::BeginWait(Operation& operation, Phase phase, std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    operation.phase = phase;
+    operation.phaseDeadline = now + m_timeout;
+    operation.pollInterval = m_initialPollInterval;
+}
+
+// 查询一次状态；未到达目标状态时按退避间隔安排下一次查询
+bool ServiceController::Poll(Operation& operation, std::chrono::steady_clock::time_point now) {
+    DWORD status = 0;
+    DWORD waitHintMs = 0;
+    ++operation.outcome.pollCount;
+    if (!m_source.QueryServiceStatusByName(operation.outcome.serviceName, status, waitHintMs)) {
+        operation.outcome.result = SERVICE_OPERATION_FAILED;
+        return true;
+    }
+    operation.outcome.finalStatus = status;
+
+    if (operation.phase == PHASE_WAIT_STOPPED && status == SERVICE_STOPPED) {
+        if (operation.outcome.type != SERVICE_OPERATION_RESTART) {
+            operation.outcome.result = SERVICE_OPERATION_SUCCEEDED;
+            return true;
+        }
+        // 重启：已确认停止，下一步立即发出启动请求
+        operation.phase = PHASE_ISSUE_START;
+        operation.nextAction = now;
+        return false;
+    }
+    if (operation.phase == PHASE_WAIT_RUNNING) {
+        if (status == SERVICE_RUNNING) {
+            operation.outcome.result = SERVICE_OPERATION_SUCCEEDED;
+            return true;
+        }
+        // 启动请求已被接受后又回到 STOPPED，说明服务启动失败
+        if (status == SERVICE_STOPPED) {
+            operation.outcome.result = SERVICE_OPERATION_FAILED;
+            return true;
+        }
+    }
+
+    if (now >= operation.phaseDeadline) {
+        operation.outcome.result = SERVICE_OPERATION_TIMED_OUT;
+        return true;
+    }
+
+    std::chrono::milliseconds interval;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (waitHintMs > 0) {
+            // 与 SCM 文档的建议一致：按等待提示的 1/10 轮询
+            interval = std::chrono::milliseconds(waitHintMs / 10);
+            interval = std::min(std::max(interval, m_initialPollInterval), m_maxPollInterval);
+        }
+        else {
+            interval = operation.pollInterval;
+            operation.pollInterval = std::min(operation.pollInterval * 2, m_maxPollInterval);
+        }
+    }
+    operation.nextAction = std::min(now + interval, operation.phaseDeadline);
+    return false;
+}
+
+void ServiceController::Finish(Operation& operation, ServiceOperationResult result) {
+    operation.outcome.result = result;
+    operation.outcome.elapsedMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - operation.submitted).count();
+    if (operation.callback) {
+        operation.callback(operation.outcome);
+    }
+    operation.promise.set_value(operation.outcome);
+}
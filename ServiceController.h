@@ -0,0 +1,150 @@
+﻿// ServiceController.h
+#pragma once
+#include "ServiceSource.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum ServiceOperationType : BYTE {
+    SERVICE_OPERATION_START,
+    SERVICE_OPERATION_STOP,
+    SERVICE_OPERATION_RESTART      // 停止并确认到达 STOPPED 后再启动
+};
+
+enum ServiceOperationResult : BYTE {
+    SERVICE_OPERATION_SUCCEEDED,
+    SERVICE_OPERATION_FAILED,      // 控制请求被拒绝、状态查询失败，或启动过程中服务又回到 STOPPED
+    SERVICE_OPERATION_TIMED_OUT,   // 超时仍未到达目标状态
+    SERVICE_OPERATION_CANCELLED,   // 控制器关闭时尚未完成
+    SERVICE_OPERATION_SKIPPED      // 计划中的前置操作未成功，本操作未执行
+};
+
+struct ServiceOperationOutcome {
+    std::wstring serviceName;
+    ServiceOperationType type = SERVICE_OPERATION_START;
+    ServiceOperationResult result = SERVICE_OPERATION_CANCELLED;
+    DWORD finalStatus = 0;         // 最后一次查询到的状态，未查询过时为 0
+    DWORD pollCount = 0;           // 状态查询次数
+    double elapsedMs = 0.0;        // 从提交到完成，含等待同一服务上前一个操作的时间
+
+    bool Succeeded() const { return result == SERVICE_OPERATION_SUCCEEDED; }
+};
+
+// 在执行操作的工作线程上调用，不应长时间阻塞
+using ServiceOperationCallback = std::function<void(const ServiceOperationOutcome&)>;
+
+// 带先后约束的一组服务操作，通常由 ServiceDependencyGraph 按依赖关系生成
+struct ServiceOperationPlan {
+    struct Step {
+        std::wstring serviceName;
+        ServiceOperationType type = SERVICE_OPERATION_START;
+        std::vector<size_t> prerequisites;   // 必须先成功完成的步骤下标（均小于本步骤下标）
+        DWORD wave = 0;                      // 拓扑层次：0 表示没有前置步骤，否则比所有前置步骤大
+    };
+
+    std::vector<Step> steps;                 // 按拓扑顺序排列
+    DWORD waveCount = 0;
+};
+
+struct ServicePlanOutcome {
+    std::vector<ServiceOperationOutcome> steps;   // 与 plan.steps 下标对应
+    size_t succeededCount = 0;
+    size_t failedCount = 0;                       // 失败、超时或取消
+    size_t skippedCount = 0;                      // 因前置步骤未成功而未执行
+    double elapsedMs = 0.0;
+
+    bool Succeeded() const { return failedCount == 0 && skippedCount == 0; }
+};
+
+// 异步服务控制：发出启动/停止请求后按退避间隔轮询状态，直到到达目标状态或超时。
+// 所有操作共用数据源中的同一个服务管理器连接；等待中的操作按下一次轮询时刻排在最小堆中，
+// 少量工作线程即可同时推进大量操作，某个控制调用阻塞时只占用一个线程。
+// 不同服务上的操作并发执行，同一服务上的操作按提交顺序串行执行
+class ServiceController {
+public:
+    explicit ServiceController(IServiceSource& source, size_t workerCount = 4);
+    ~ServiceController();
+
+    ServiceController(const ServiceController&) = delete;
+    ServiceController& operator=(const ServiceController&) = delete;
+
+    // 提交操作，完成时先调用 callback（如有），再使 future 就绪
+    std::future<ServiceOperationOutcome> Submit(const std::wstring& serviceName, ServiceOperationType type,
+        ServiceOperationCallback callback = nullptr);
+    // 批量提交，每个服务各自完成、各自回调
+    std::vector<std::future<ServiceOperationOutcome>> SubmitBatch(const std::vector<std::wstring>& serviceNames,
+        ServiceOperationType type, ServiceOperationCallback callback = nullptr);
+    // 按计划执行：每个步骤在其全部前置步骤成功后立即提交，互不依赖的分支并发执行，
+    // 不必等待同一层次的其他步骤；前置步骤未成功时其后续步骤全部跳过。
+    // stepCallback 在每个步骤完成或被跳过时调用
+    std::future<ServicePlanOutcome> SubmitPlan(const ServiceOperationPlan& plan,
+        ServiceOperationCallback stepCallback = nullptr);
+
+    // 每个阶段（停止、启动）等待目标状态的最长时间
+    void SetTimeout(std::chrono::milliseconds timeout);
+    // 轮询间隔从 initial 开始逐次加倍，不超过 maximum；服务提供等待提示时按提示的 1/10 取值
+    void SetPollInterval(std::chrono::milliseconds initial, std::chrono::milliseconds maximum);
+
+    // 排队与执行中的操作数
+    size_t GetPendingCount() const;
+
+    // 停止工作线程，未完成的操作以 CANCELLED 结束；之后提交的操作立即取消
+    void Shutdown();
+
+private:
+    enum Phase : BYTE {
+        PHASE_ISSUE_STOP,
+        PHASE_WAIT_STOPPED,
+        PHASE_ISSUE_START,
+        PHASE_WAIT_RUNNING
+    };
+
+    struct Operation {
+        ServiceOperationOutcome outcome;
+        ServiceOperationCallback callback;
+        std::promise<ServiceOperationOutcome> promise;
+        Phase phase = PHASE_ISSUE_START;
+        std::chrono::steady_clock::time_point submitted;
+        std::chrono::steady_clock::time_point nextAction;     // 下一次执行 Step 的时刻
+        std::chrono::steady_clock::time_point phaseDeadline;
+        std::chrono::milliseconds pollInterval{ 0 };
+    };
+    using OperationPtr = std::unique_ptr<Operation>;
+
+    struct PlanExecution;
+    void SubmitPlanStep(const std::shared_ptr<PlanExecution>& execution, size_t index);
+    void OnPlanStepFinished(const std::shared_ptr<PlanExecution>& execution, size_t index,
+        const ServiceOperationOutcome& outcome);
+
+    // 推进一步；返回 true 表示操作已结束（outcome.result 已确定）
+    bool Step(Operation& operation);
+    bool Poll(Operation& operation, std::chrono::steady_clock::time_point now);
+    void BeginWait(Operation& operation, Phase phase, std::chrono::steady_clock::time_point now);
+
+    void WorkerLoop();
+    void ScheduleLocked(OperationPtr operation);
+    void Finish(Operation& operation, ServiceOperationResult result);
+
+    IServiceSource& m_source;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<OperationPtr> m_scheduled;     // 按 nextAction 排序的最小堆
+    // 服务名 -> 等待前一个操作完成的后续操作；存在该键表示此服务已有操作在执行
+    std::unordered_map<std::wstring, std::deque<OperationPtr>> m_serviceQueues;
+    size_t m_pendingCount;
+    bool m_stop;
+
+    std::chrono::milliseconds m_timeout;
+    std::chrono::milliseconds m_initialPollInterval;
+    std::chrono::milliseconds m_maxPollInterval;
+
+    std::vector<std::thread> m_threads;
+};
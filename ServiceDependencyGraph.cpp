@@ -0,0 +1,203 @@
+﻿// ServiceDependencyGraph.cpp
+#include "ServiceDependencyGraph.h"
+#include "ServiceCollector.h"
+#include <algorithm>
+#include <cstdint>
+#include <cwctype>
+
+std::wstring ServiceDependencyGraph::MakeKey(const std::wstring& serviceName) {
+    std::wstring key(serviceName);
+    std::transform(key.begin(), key.end(), key.begin(), ::towlower);
+    return key;
+}
+
+size_t ServiceDependencyGraph::Find(const std::wstring& serviceName) const {
+    auto it = m_index.find(MakeKey(serviceName));
+    return it != m_index.end() ? it->second : m_nodes.size();
+}
+
+void ServiceDependencyGraph::Clear() {
+    m_nodes.clear();
+    m_topologicalOrder.clear();
+    m_index.clear();
+    m_cycleServices.clear();
+}
+
+void ServiceDependencyGraph::Build(const std::vector<ServiceInfo>& services) {
+    Clear();
+    m_nodes.resize(services.size());
+    m_index.reserve(services.size());
+    for (size_t i = 0; i < services.size(); ++i) {
+        m_nodes[i].name = services[i].serviceName;
+        m_nodes[i].status = services[i].status;
+        m_index.emplace(MakeKey(services[i].serviceName), i);
+    }
+
+    for (size_t i = 0; i < services.size(); ++i) {
+        for (const auto& dependency : services[i].dependencies) {
+            size_t target = Find(dependency);
+            if (target == m_nodes.size() || target == i) {
+                continue;
+            }
+            auto& dependencies = m_nodes[i].dependencies;
+            if (std::find(dependencies.begin(), dependencies.end(), target) == dependencies.end()) {
+                dependencies.push_back(target);
+                m_nodes[target].dependents.push_back(i);
+            }
+        }
+    }
+
+    // Kahn 算法求拓扑序：依赖全部就绪的服务依次出队，最终未出队的即处于环中或环的下游
+    std::vector<size_t> pendingDependencies(m_nodes.size());
+    m_topologicalOrder.reserve(m_nodes.size());
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        pendingDependencies[i] = m_nodes[i].dependencies.size();
+        if (pendingDependencies[i] == 0) {
+            m_topologicalOrder.push_back(i);
+        }
+    }
+    for (size_t head = 0; head < m_topologicalOrder.size(); ++head) {
+        size_t current = m_topologicalOrder[head];
+        for (size_t dependent : m_nodes[current].dependents) {
+            if (--pendingDependencies[dependent] == 0) {
+                m_topologicalOrder.push_back(dependent);
+            }
+        }
+    }
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (pendingDependencies[i] != 0) {
+            m_nodes[i].inCycle = true;
+            m_cycleServices.push_back(m_nodes[i].name);
+        }
+    }
+}
+
+std::vector<std::wstring> ServiceDependencyGraph::GetDependencies(const std::wstring& serviceName) const {
+    std::vector<std::wstring> names;
+    size_t index = Find(serviceName);
+    if (index < m_nodes.size()) {
+        for (size_t dependency : m_nodes[index].dependencies) {
+            names.push_back(m_nodes[dependency].name);
+        }
+    }
+    return names;
+}
+
+std::vector<std::wstring> ServiceDependencyGraph::GetDependents(const std::wstring& serviceName) const {
+    std::vector<std::wstring> names;
+    size_t index = Find(serviceName);
+    if (index < m_nodes.size()) {
+        for (size_t dependent : m_nodes[index].dependents) {
+            names.push_back(m_nodes[dependent].name);
+        }
+    }
+    return names;
+}
+
+bool ServiceDependencyGraph::ResolveSeeds(const std::vector<std::wstring>& serviceNames, std::vector<size_t>& seeds) const {
+    seeds.clear();
+    for (const auto& serviceName : serviceNames) {
+        size_t index = Find(serviceName);
+        if (index == m_nodes.size()) {
+            return false;
+        }
+        seeds.push_back(index);
+    }
+    return true;
+}
+
+void ServiceDependencyGraph::Expand(const std::vector<size_t>& seeds, bool followDependencies, DWORD skipStatus,
+    std::vector<char>& selected) const {
+    selected.assign(m_nodes.size(), 0);
+    std::vector<size_t> pending(seeds);
+    for (size_t seed : seeds) {
+        selected[seed] = 1;
+    }
+    while (!pending.empty()) {
+        size_t current = pending.back();
+        pending.pop_back();
+        const auto& next = followDependencies ? m_nodes[current].dependencies : m_nodes[current].dependents;
+        for (size_t neighbor : next) {
+            if (!selected[neighbor] && m_nodes[neighbor].status != skipStatus) {
+                selected[neighbor] = 1;
+                pending.push_back(neighbor);
+            }
+        }
+    }
+}
+
+void ServiceDependencyGraph::AppendSteps(const std::vector<char>& selected, ServiceOperationType type, bool reverse,
+    ServiceOperationPlan& plan, std::vector<size_t>& stepOf) const {
+    stepOf.assign(m_nodes.size(), SIZE_MAX);
+    for (size_t position = 0; position < m_topologicalOrder.size(); ++position) {
+        size_t index = m_topologicalOrder[reverse ? m_topologicalOrder.size() - 1 - position : position];
+        if (!selected[index]) {
+            continue;
+        }
+
+        ServiceOperationPlan::Step step;
+        step.serviceName = m_nodes[index].name;
+        step.type = type;
+        // 启动等待依赖，停止等待依赖方；按拓扑序追加，前置步骤总是已经存在
+        const auto& prerequisites = reverse ? m_nodes[index].dependents : m_nodes[index].dependencies;
+        for (size_t prerequisite : prerequisites) {
+            if (stepOf[prerequisite] != SIZE_MAX) {
+                step.prerequisites.push_back(stepOf[prerequisite]);
+            }
+        }
+        stepOf[index] = plan.steps.size();
+        plan.steps.push_back(std::move(step));
+    }
+}
+
+bool ServiceDependencyGraph::Plan(const std::vector<std::wstring>& serviceNames, ServiceOperationType type,
+    ServiceOperationPlan& plan) const {
+    plan = ServiceOperationPlan();
+
+    std::vector<size_t> seeds;
+    if (!ResolveSeeds(serviceNames, seeds)) {
+        return false;
+    }
+
+    // 启动只需经过未运行的依赖（已运行服务的依赖必然也在运行）；停止只需经过未停止的依赖方
+    std::vector<char> selected;
+    if (type == SERVICE_OPERATION_START) {
+        Expand(seeds, true, SERVICE_RUNNING, selected);
+    }
+    else {
+        Expand(seeds, false, SERVICE_STOPPED, selected);
+    }
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (selected[i] && m_nodes[i].inCycle) {
+            return false;
+        }
+    }
+
+    std::vector<size_t> stepOf;
+    if (type == SERVICE_OPERATION_START) {
+        AppendSteps(selected, SERVICE_OPERATION_START, false, plan, stepOf);
+    }
+    else {
+        AppendSteps(selected, SERVICE_OPERATION_STOP, true, plan, stepOf);
+        if (type == SERVICE_OPERATION_RESTART) {
+            // 每个服务的启动还要等待它自己的停止步骤
+            std::vector<size_t> stopStepOf(std::move(stepOf));
+            AppendSteps(selected, SERVICE_OPERATION_START, false, plan, stepOf);
+            for (size_t i = 0; i < m_nodes.size(); ++i) {
+                if (selected[i]) {
+                    plan.steps[stepOf[i]].prerequisites.push_back(stopStepOf[i]);
+                }
+            }
+        }
+    }
+
+    // 层次 = 前置步骤的最大层次 + 1
+    for (auto& step : plan.steps) {
+        step.wave = 0;
+        for (size_t prerequisite : step.prerequisites) {
+            step.wave = std::max(step.wave, plan.steps[prerequisite].wave + 1);
+        }
+        plan.waveCount = std::max(plan.waveCount, step.wave + 1);
+    }
+    return true;
+}
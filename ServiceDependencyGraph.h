@@ -0,0 +1,57 @@
+﻿// ServiceDependencyGraph.h
+#pragma once
+#include "PlatformCompat.h"
+#include "ServiceController.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ServiceInfo;
+
+// 服务依赖图（有向无环图）：边从依赖方指向其依赖。
+// 根据依赖关系把一组服务的启动、停止、重启展开为 ServiceOperationPlan：
+// 启动时依赖先于依赖方，停止时依赖方先于依赖，交由 ServiceController 并发执行互不依赖的分支。
+// 服务名不区分大小写（与 SCM 一致）
+class ServiceDependencyGraph {
+public:
+    // 按服务列表重建；指向不存在服务的依赖被忽略
+    void Build(const std::vector<ServiceInfo>& services);
+    void Clear();
+
+    size_t GetServiceCount() const { return m_nodes.size(); }
+    // 直接依赖与直接依赖方
+    std::vector<std::wstring> GetDependencies(const std::wstring& serviceName) const;
+    std::vector<std::wstring> GetDependents(const std::wstring& serviceName) const;
+    // 处于依赖环中或依赖环下游的服务，为空表示图无环
+    const std::vector<std::wstring>& GetCycleServices() const { return m_cycleServices; }
+
+    // 生成操作计划；服务不存在或涉及依赖环时返回 false。
+    // START：连同尚未运行的传递依赖一起启动；
+    // STOP：连同未停止的传递依赖方一起停止；
+    // RESTART：按 STOP 的范围停止后，再按依赖顺序启动同一批服务
+    bool Plan(const std::vector<std::wstring>& serviceNames, ServiceOperationType type, ServiceOperationPlan& plan) const;
+
+private:
+    struct Node {
+        std::wstring name;
+        DWORD status = 0;                    // 建图时的服务状态，用于裁剪计划范围
+        std::vector<size_t> dependencies;
+        std::vector<size_t> dependents;
+        bool inCycle = false;
+    };
+
+    static std::wstring MakeKey(const std::wstring& serviceName);
+    size_t Find(const std::wstring& serviceName) const;
+    bool ResolveSeeds(const std::vector<std::wstring>& serviceNames, std::vector<size_t>& seeds) const;
+    // 从 seeds 出发沿依赖（followDependencies）或依赖方方向展开，只经过 status 不等于 skipStatus 的服务
+    void Expand(const std::vector<size_t>& seeds, bool followDependencies, DWORD skipStatus,
+        std::vector<char>& selected) const;
+    // 按拓扑序（reverse 时逆序）追加 selected 中每个服务的步骤，返回服务下标 -> 步骤下标
+    void AppendSteps(const std::vector<char>& selected, ServiceOperationType type, bool reverse,
+        ServiceOperationPlan& plan, std::vector<size_t>& stepOf) const;
+
+    std::vector<Node> m_nodes;
+    std::vector<size_t> m_topologicalOrder;              // 依赖在前，仅含无环部分
+    std::unordered_map<std::wstring, size_t> m_index;    // 小写服务名 -> 下标
+    std::vector<std::wstring> m_cycleServices;
+};
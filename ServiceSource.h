@@ -0,0 +1,37 @@
+﻿// ServiceSource.h
+#pragma once
+#include "PlatformCompat.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+struct ServiceInfo;
+
+// 服务数据源接口 - 屏蔽各平台的服务管理器实现
+// Windows 实现见 ServiceSourceWin.cpp（SCM），Linux 实现见 ServiceSourceLinux.cpp；
+// 内存中的模拟实现见 ServiceSourceSimulated.h，可注入 ServiceCollector 在任意平台上验证缓存与控制逻辑
+class IServiceSource {
+public:
+    virtual ~IServiceSource() = default;
+
+    virtual bool Initialize() = 0;
+    virtual void Cleanup() = 0;
+
+    // 枚举全部服务：只需填充名称、显示名称、状态与配置版本号（如有），
+    // 启动类型、二进制路径与依赖由 QueryServiceConfigByName 按需查询
+    virtual bool EnumerateServices(std::vector<ServiceInfo>& services) = 0;
+    // 查询单个服务的静态配置；dependencies 为该服务启动前必须运行的服务名
+    virtual bool QueryServiceConfigByName(const std::wstring& serviceName, DWORD& startType, std::wstring& binaryPath,
+        std::vector<std::wstring>& dependencies) = 0;
+
+    // 查询单个服务的当前状态；waitHintMs 为服务声明的下一次状态推进预计耗时（毫秒），未知时为 0
+    virtual bool QueryServiceStatusByName(const std::wstring& serviceName, DWORD& status, DWORD& waitHintMs) = 0;
+
+    // 只负责发出控制请求，不等待状态到达，等待由 ServiceController 轮询完成。
+    // 服务已处于目标状态时同样视为成功；实现需允许在多个线程上并发调用
+    virtual bool StartServiceByName(const std::wstring& serviceName) = 0;
+    virtual bool StopServiceByName(const std::wstring& serviceName) = 0;
+};
+
+// 创建当前平台的默认服务数据源
+std::unique_ptr<IServiceSource> CreateServiceSource();
@@ -0,0 +1,27 @@
+﻿// ServiceSourceLinux.cpp
+// Linux 服务数据源：尚未接入 systemd，枚举结果为空，控制操作返回失败
+#ifdef __linux__
+#include "ServiceCollector.h"
+
+class LinuxServiceSource : public IServiceSource {
+public:
+    bool Initialize() override { return true; }
+    void Cleanup() override {}
+
+    bool EnumerateServices(std::vector<ServiceInfo>& services) override {
+        services.clear();
+        return true;
+    }
+
+    bool QueryServiceConfigByName(const std::wstring&, DWORD&, std::wstring&, std::vector<std::wstring>&) override { return false; }
+    bool QueryServiceStatusByName(const std::wstring&, DWORD&, DWORD&) override { return false; }
+
+    bool StartServiceByName(const std::wstring&) override { return false; }
+    bool StopServiceByName(const std::wstring&) override { return false; }
+};
+
+std::unique_ptr<IServiceSource> CreateServiceSource() {
+    return std::make_unique<LinuxServiceSource>();
+}
+
+#endif // __linux__
@@ -0,0 +1,237 @@
+﻿// ServiceSourceSimulated.cpp
+#include "ServiceSourceSimulated.h"
+#include <algorithm>
+#include <thread>
+
+void SimulatedServiceSource::AdvanceLocked(SimulatedService& service, std::chrono::steady_clock::time_point now) {
+    if (service.pendingStatus != 0 && now >= service.pendingUntil) {
+        service.status = service.pendingStatus;
+        service.pendingStatus = 0;
+    }
+}
+
+void SimulatedServiceSource::BeginTransitionLocked(SimulatedService& service, DWORD pendingStatus, DWORD finalStatus) {
+    if (m_transitionDelay.count() == 0) {
+        service.status = finalStatus;
+        service.pendingStatus = 0;
+        return;
+    }
+    service.status = pendingStatus;
+    service.pendingStatus = finalStatus;
+    service.pendingUntil = std::chrono::steady_clock::now() + m_transitionDelay;
+}
+
+bool SimulatedServiceSource::EnumerateServices(std::vector<ServiceInfo>& services) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto now = std::chrono::steady_clock::now();
+    services.reserve(m_services.size());
+    for (auto& pair : m_services) {
+        AdvanceLocked(pair.second, now);
+        ServiceInfo service;
+        service.serviceName = pair.first;
+        service.displayName = pair.second.displayName;
+        service.status = pair.second.status;
+        service.configGeneration = pair.second.configGeneration;
+        services.push_back(std::move(service));
+    }
+    return true;
+}
+
+bool SimulatedServiceSource::QueryServiceConfigByName(const std::wstring& serviceName, DWORD& startType, std::wstring& binaryPath,
+    std::vector<std::wstring>& dependencies) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ++m_configQueryCount;
+    auto it = m_services.find(serviceName);
+    if (it == m_services.end()) {
+        return false;
+    }
+    startType = it->second.startType;
+    binaryPath = it->second.binaryPath;
+    dependencies = it->second.dependencies;
+    return true;
+}
+
+bool SimulatedServiceSource::QueryServiceStatusByName(const std::wstring& serviceName, DWORD& status, DWORD& waitHintMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ++m_statusQueryCount;
+    auto it = m_services.find(serviceName);
+    if (it == m_services.end()) {
+        return false;
+    }
+    auto now = std::chrono::steady_clock::now();
+    AdvanceLocked(it->second, now);
+    status = it->second.status;
+    waitHintMs = it->second.pendingStatus != 0 ? static_cast<DWORD>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(it->second.pendingUntil - now).count()) : 0;
+    return true;
+}
+
+// 与 SCM 一致：已在运行或正在启动时视为成功，正在停止时拒绝。
+// 为了能检验调度顺序，依赖未处于运行状态时直接拒绝，而不像 SCM 那样自动启动依赖
+bool SimulatedServiceSource::StartServiceByName(const std::wstring& serviceName) {
+    std::chrono::milliseconds latency;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        latency = m_controlLatency;
+    }
+    if (latency.count() > 0) {
+        std::this_thread::sleep_for(latency);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_services.find(serviceName);
+    if (it == m_services.end() || it->second.startType == SERVICE_DISABLED) {
+        return false;
+    }
+    SimulatedService& service = it->second;
+    auto now = std::chrono::steady_clock::now();
+    AdvanceLocked(service, now);
+    if (service.status == SERVICE_RUNNING || service.status == SERVICE_START_PENDING) {
+        return true;
+    }
+    if (service.status != SERVICE_STOPPED) {
+        return false;
+    }
+    for (const auto& dependency : service.dependencies) {
+        auto dependencyIt = m_services.find(dependency);
+        if (dependencyIt != m_services.end()) {
+            AdvanceLocked(dependencyIt->second, now);
+            if (dependencyIt->second.status != SERVICE_RUNNING) {
+                return false;
+            }
+        }
+    }
+    BeginTransitionLocked(service, SERVICE_START_PENDING, service.failStart ? SERVICE_STOPPED : SERVICE_RUNNING);
+    return true;
+}
+
+// 已停止或正在停止时视为成功，正在启动或仍有未停止的依赖方时拒绝（对应 ERROR_DEPENDENT_SERVICES_RUNNING）
+bool SimulatedServiceSource::StopServiceByName(const std::wstring& serviceName) {
+    std::chrono::milliseconds latency;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        latency = m_controlLatency;
+    }
+    if (latency.count() > 0) {
+        std::this_thread::sleep_for(latency);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_services.find(serviceName);
+    if (it == m_services.end()) {
+        return false;
+    }
+    SimulatedService& service = it->second;
+    auto now = std::chrono::steady_clock::now();
+    AdvanceLocked(service, now);
+    if (service.status == SERVICE_STOPPED || service.status == SERVICE_STOP_PENDING) {
+        return true;
+    }
+    if (service.status == SERVICE_START_PENDING) {
+        return false;
+    }
+    for (auto& pair : m_services) {
+        const auto& dependencies = pair.second.dependencies;
+        if (std::find(dependencies.begin(), dependencies.end(), serviceName) != dependencies.end()) {
+            AdvanceLocked(pair.second, now);
+            if (pair.second.status != SERVICE_STOPPED) {
+                return false;
+            }
+        }
+    }
+    BeginTransitionLocked(service, SERVICE_STOP_PENDING, SERVICE_STOPPED);
+    return true;
+}
+
+void SimulatedServiceSource::AddService(const std::wstring& serviceName, const std::wstring& displayName,
+    DWORD status, DWORD startType, const std::wstring& binaryPath) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    SimulatedService& service = m_services[serviceName];
+    service.displayName = displayName;
+    service.status = status;
+    service.startType = startType;
+    service.binaryPath = binaryPath;
+}
+
+void SimulatedServiceSource::RemoveService(const std::wstring& serviceName) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_services.erase(serviceName);
+}
+
+bool SimulatedServiceSource::SetStatus(const std::wstring& serviceName, DWORD status) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_services.find(serviceName);
+    if (it == m_services.end()) {
+        return false;
+    }
+    it->second.status = status;
+    it->second.pendingStatus = 0;
+    return true;
+}
+
+bool SimulatedServiceSource::SetConfig(const std::wstring& serviceName, DWORD startType, const std::wstring& binaryPath, bool bumpGeneration) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_services.find(serviceName);
+    if (it == m_services.end()) {
+        return false;
+    }
+    it->second.startType = startType;
+    it->second.binaryPath = binaryPath;
+    if (bumpGeneration) {
+        ++it->second.configGeneration;
+    }
+    return true;
+}
+
+bool SimulatedServiceSource::SetDependencies(const std::wstring& serviceName, const std::vector<std::wstring>& dependencies, bool bumpGeneration) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_services.find(serviceName);
+    if (it == m_services.end()) {
+        return false;
+    }
+    it->second.dependencies = dependencies;
+    if (bumpGeneration) {
+        ++it->second.configGeneration;
+    }
+    return true;
+}
+
+void SimulatedServiceSource::SetTransitionDelay(std::chrono::milliseconds delay) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_transitionDelay = delay;
+}
+
+void SimulatedServiceSource::SetControlLatency(std::chrono::milliseconds latency) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_controlLatency = latency;
+}
+
+bool SimulatedServiceSource::SetStartFailure(const std::wstring& serviceName, bool fail) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_services.find(serviceName);
+    if (it == m_services.end()) {
+        return false;
+    }
+    it->second.failStart = fail;
+    return true;
+}
+
+size_t SimulatedServiceSource::GetConfigQueryCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_configQueryCount;
+}
+
+size_t SimulatedServiceSource::GetStatusQueryCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statusQueryCount;
+}
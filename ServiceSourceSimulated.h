@@ -0,0 +1,70 @@
+﻿// ServiceSourceSimulated.h
+#pragma once
+#include "ServiceCollector.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+
+// 内存中的模拟服务管理器，不依赖任何系统服务，可在任意平台注入 ServiceCollector，
+// 用于验证配置缓存、变化检测等逻辑，或在没有服务管理器的平台上演示界面。
+// 修改配置时递增该服务的配置版本号，与真实数据源的行为一致。
+// 设置转换耗时后，启动/停止请求先进入 START_PENDING/STOP_PENDING，到期后再推进到目标状态，
+// 用于验证 ServiceController 的状态等待、超时与并发逻辑
+class SimulatedServiceSource : public IServiceSource {
+public:
+    bool Initialize() override { return true; }
+    void Cleanup() override {}
+
+    bool EnumerateServices(std::vector<ServiceInfo>& services) override;
+    bool QueryServiceConfigByName(const std::wstring& serviceName, DWORD& startType, std::wstring& binaryPath,
+        std::vector<std::wstring>& dependencies) override;
+    bool QueryServiceStatusByName(const std::wstring& serviceName, DWORD& status, DWORD& waitHintMs) override;
+    bool StartServiceByName(const std::wstring& serviceName) override;
+    bool StopServiceByName(const std::wstring& serviceName) override;
+
+    // 以下方法用于构造和修改模拟数据
+    void AddService(const std::wstring& serviceName, const std::wstring& displayName,
+        DWORD status, DWORD startType, const std::wstring& binaryPath);
+    void RemoveService(const std::wstring& serviceName);
+    bool SetStatus(const std::wstring& serviceName, DWORD status);
+    // bumpGeneration 为 false 时模拟不提供版本号的数据源（只能靠状态变化或定期校正发现修改）
+    bool SetConfig(const std::wstring& serviceName, DWORD startType, const std::wstring& binaryPath, bool bumpGeneration = true);
+    // 设置服务依赖（启动前必须运行的服务），用于构造依赖图
+    bool SetDependencies(const std::wstring& serviceName, const std::vector<std::wstring>& dependencies, bool bumpGeneration = true);
+
+    // 启动/停止的挂起时长，0 表示立即到达目标状态
+    void SetTransitionDelay(std::chrono::milliseconds delay);
+    // 每次控制请求本身的耗时（模拟阻塞的控制调用）
+    void SetControlLatency(std::chrono::milliseconds latency);
+    // 启动失败：START_PENDING 到期后回到 STOPPED
+    bool SetStartFailure(const std::wstring& serviceName, bool fail);
+
+    // 累计的配置查询次数
+    size_t GetConfigQueryCount() const;
+    // 累计的状态查询次数
+    size_t GetStatusQueryCount() const;
+
+private:
+    struct SimulatedService {
+        std::wstring displayName;
+        DWORD status = SERVICE_STOPPED;
+        DWORD startType = SERVICE_DEMAND_START;
+        std::wstring binaryPath;
+        std::vector<std::wstring> dependencies;
+        DWORD configGeneration = 1;
+        DWORD pendingStatus = 0;        // 挂起转换到期后的状态，0 表示没有挂起的转换
+        std::chrono::steady_clock::time_point pendingUntil;
+        bool failStart = false;
+    };
+
+    // 推进已到期的挂起转换（调用方持有 m_mutex）
+    static void AdvanceLocked(SimulatedService& service, std::chrono::steady_clock::time_point now);
+    void BeginTransitionLocked(SimulatedService& service, DWORD pendingStatus, DWORD finalStatus);
+
+    mutable std::mutex m_mutex;
+    std::map<std::wstring, SimulatedService> m_services;
+    std::chrono::milliseconds m_transitionDelay{ 0 };
+    std::chrono::milliseconds m_controlLatency{ 0 };
+    size_t m_configQueryCount = 0;
+    size_t m_statusQueryCount = 0;
+};
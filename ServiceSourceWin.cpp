@@ -0,0 +1,227 @@
+﻿// ServiceSourceWin.cpp
+// Windows 服务数据源：通过服务控制管理器(SCM)枚举与控制服务
+#ifdef _WIN32
+#include "ServiceCollector.h"
+#include <iostream>
+
+#pragma comment(lib, "advapi32.lib")
+
+class WinServiceSource : public IServiceSource {
+public:
+    WinServiceSource() : m_scmHandle(NULL) {}
+    ~WinServiceSource() override { Cleanup(); }
+
+    bool Initialize() override;
+    void Cleanup() override;
+
+    bool EnumerateServices(std::vector<ServiceInfo>& services) override;
+    bool QueryServiceConfigByName(const std::wstring& serviceName, DWORD& startType, std::wstring& binaryPath,
+        std::vector<std::wstring>& dependencies) override;
+    bool QueryServiceStatusByName(const std::wstring& serviceName, DWORD& status, DWORD& waitHintMs) override;
+    bool StartServiceByName(const std::wstring& serviceName) override;
+    bool StopServiceByName(const std::wstring& serviceName) override;
+
+private:
+    SC_HANDLE m_scmHandle;               // 整个生命周期只打开一次，SCM 句柄可在多个线程上同时使用
+    std::vector<unsigned char> m_enumBuffer;     // 枚举缓冲区，在多次刷新间复用
+    std::vector<unsigned char> m_configBuffer;   // QUERY_SERVICE_CONFIGW 缓冲区
+};
+
+bool WinServiceSource::Initialize() {
+    if (m_scmHandle) {
+        return true;
+    }
+    // 枚举与按名打开服务只需要 CONNECT 和 ENUMERATE 权限，启动/停止所需权限在打开服务时单独申请
+    m_scmHandle = OpenSCManagerW(NULL, NULL, SC_MANAGER_CONNECT | SC_MANAGER_ENUMERATE_SERVICE);
+    if (!m_scmHandle) {
+        std::cerr << "OpenSCManagerW failed. Error: " << GetLastError() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void WinServiceSource::Cleanup() {
+    if (m_scmHandle) {
+        CloseServiceHandle(m_scmHandle);
+        m_scmHandle = NULL;
+    }
+}
+
+// 枚举缓冲区在多次刷新间复用：通常一次调用即可完成，服务数增长时才扩容重试
+bool WinServiceSource::EnumerateServices(std::vector<ServiceInfo>& services) {
+    if (!m_scmHandle) {
+        return false;
+    }
+
+    DWORD bytesNeeded = 0;
+    DWORD servicesReturned = 0;
+    BOOL result = FALSE;
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        DWORD resumeHandle = 0;
+        result = EnumServicesStatusExW(
+            m_scmHandle,
+            SC_ENUM_PROCESS_INFO,
+            SERVICE_WIN32 | SERVICE_DRIVER,
+            SERVICE_STATE_ALL,
+            m_enumBuffer.empty() ? NULL : m_enumBuffer.data(),
+            static_cast<DWORD>(m_enumBuffer.size()),
+            &bytesNeeded,
+            &servicesReturned,
+            &resumeHandle,
+            NULL
+        );
+        if (result || GetLastError() != ERROR_MORE_DATA) {
+            break;
+        }
+        // bytesNeeded 为剩余部分所需大小，多留余量避免两次调用之间新增服务
+        m_enumBuffer.resize(m_enumBuffer.size() + bytesNeeded + bytesNeeded / 4);
+    }
+    if (!result) {
+        std::cerr << "EnumServicesStatusExW failed. Error: " << GetLastError() << std::endl;
+        return false;
+    }
+
+    // 只填充状态信息，启动类型与二进制路径由 ServiceCollector 按需查询
+    const ENUM_SERVICE_STATUS_PROCESSW* servicesBuffer =
+        reinterpret_cast<const ENUM_SERVICE_STATUS_PROCESSW*>(m_enumBuffer.data());
+    services.reserve(servicesReturned);
+    for (DWORD i = 0; i < servicesReturned; ++i) {
+        ServiceInfo service;
+        service.serviceName = servicesBuffer[i].lpServiceName;
+        service.displayName = servicesBuffer[i].lpDisplayName;
+        service.status = servicesBuffer[i].ServiceStatusProcess.dwCurrentState;
+        services.push_back(std::move(service));
+    }
+
+    return true;
+}
+
+// 配置缓冲区同样复用，只有配置较大的服务才需要扩容
+bool WinServiceSource::QueryServiceConfigByName(const std::wstring& serviceName, DWORD& startType, std::wstring& binaryPath,
+    std::vector<std::wstring>& dependencies) {
+    if (!m_scmHandle) {
+        return false;
+    }
+
+    SC_HANDLE serviceHandle = OpenServiceW(m_scmHandle, serviceName.c_str(), SERVICE_QUERY_CONFIG);
+    if (!serviceHandle) {
+        return false;
+    }
+
+    if (m_configBuffer.empty()) {
+        m_configBuffer.resize(8192);
+    }
+    DWORD bytesNeeded = 0;
+    BOOL result = QueryServiceConfigW(serviceHandle,
+        reinterpret_cast<LPQUERY_SERVICE_CONFIGW>(m_configBuffer.data()),
+        static_cast<DWORD>(m_configBuffer.size()), &bytesNeeded);
+    if (!result && GetLastError() == ERROR_INSUFFICIENT_BUFFER) {
+        m_configBuffer.resize(bytesNeeded);
+        result = QueryServiceConfigW(serviceHandle,
+            reinterpret_cast<LPQUERY_SERVICE_CONFIGW>(m_configBuffer.data()),
+            static_cast<DWORD>(m_configBuffer.size()), &bytesNeeded);
+    }
+    CloseServiceHandle(serviceHandle);
+
+    if (!result) {
+        return false;
+    }
+
+    const QUERY_SERVICE_CONFIGW* config = reinterpret_cast<const QUERY_SERVICE_CONFIGW*>(m_configBuffer.data());
+    startType = config->dwStartType;
+    binaryPath = config->lpBinaryPathName ? config->lpBinaryPathName : L"";
+
+    // lpDependencies 为以双 '\0' 结尾的名称列表；以 SC_GROUP_IDENTIFIER 开头的是加载顺序组，
+    // 组成员无法从 SCM 直接得到，不计入依赖
+    dependencies.clear();
+    for (const wchar_t* name = config->lpDependencies; name && *name; name += wcslen(name) + 1) {
+        if (*name != SC_GROUP_IDENTIFIERW) {
+            dependencies.emplace_back(name);
+        }
+    }
+    return true;
+}
+
+bool WinServiceSource::QueryServiceStatusByName(const std::wstring& serviceName, DWORD& status, DWORD& waitHintMs) {
+    if (!m_scmHandle) {
+        return false;
+    }
+
+    SC_HANDLE serviceHandle = OpenServiceW(m_scmHandle, serviceName.c_str(), SERVICE_QUERY_STATUS);
+    if (!serviceHandle) {
+        return false;
+    }
+
+    SERVICE_STATUS_PROCESS statusProcess = { 0 };
+    DWORD bytesNeeded = 0;
+    BOOL result = QueryServiceStatusEx(serviceHandle, SC_STATUS_PROCESS_INFO,
+        reinterpret_cast<LPBYTE>(&statusProcess), sizeof(statusProcess), &bytesNeeded);
+    CloseServiceHandle(serviceHandle);
+
+    if (!result) {
+        return false;
+    }
+    status = statusProcess.dwCurrentState;
+    waitHintMs = statusProcess.dwWaitHint;
+    return true;
+}
+
+bool WinServiceSource::StartServiceByName(const std::wstring& serviceName) {
+    if (!m_scmHandle) {
+        return false;
+    }
+
+    SC_HANDLE serviceHandle = OpenServiceW(
+        m_scmHandle,
+        serviceName.c_str(),
+        SERVICE_START
+    );
+
+    if (!serviceHandle) {
+        std::cerr << "OpenServiceW failed for service: " << WideToUtf8(serviceName) << std::endl;
+        return false;
+    }
+
+    BOOL result = ::StartServiceW(serviceHandle, 0, NULL);
+    if (!result && GetLastError() == ERROR_SERVICE_ALREADY_RUNNING) {
+        std::wcout << L"Service " << serviceName << L" is already running." << std::endl;
+        result = TRUE;
+    }
+
+    CloseServiceHandle(serviceHandle);
+    return result != 0;
+}
+
+bool WinServiceSource::StopServiceByName(const std::wstring& serviceName) {
+    if (!m_scmHandle) {
+        return false;
+    }
+
+    SC_HANDLE serviceHandle = OpenServiceW(
+        m_scmHandle,
+        serviceName.c_str(),
+        SERVICE_STOP | SERVICE_QUERY_STATUS
+    );
+
+    if (!serviceHandle) {
+        std::cerr << "OpenServiceW failed for service: " << WideToUtf8(serviceName) << std::endl;
+        return false;
+    }
+
+    SERVICE_STATUS serviceStatus = { 0 };
+    BOOL result = ControlService(serviceHandle, SERVICE_CONTROL_STOP, &serviceStatus);
+    if (!result && GetLastError() == ERROR_SERVICE_NOT_ACTIVE) {
+        // 若服务已经停止，视为成功
+        std::wcout << L"Service " << serviceName << L" is already stopped." << std::endl;
+        result = TRUE;
+    }
+
+    CloseServiceHandle(serviceHandle);
+    return result != 0;
+}
+
+std::unique_ptr<IServiceSource> CreateServiceSource() {
+    return std::make_unique<WinServiceSource>();
+}
+
+#endif // _WIN32
@@ -1,25 +1,50 @@
-// SessionCollector.h
+﻿// SessionCollector.h
 #ifndef SESSIONCOLLECTOR_H
 #define SESSIONCOLLECTOR_H
 
-#include <windows.h>
-#include <wtsapi32.h>
+#include "PlatformCompat.h"
+#include "SessionSource.h"
+#include "ValueFormatter.h"
 #include <vector>
 #include <string>
+#include <memory>
 
-#pragma comment(lib, "wtsapi32.lib")
+#ifdef _WIN32
+#include <wtsapi32.h>
+#else
+// 非 Windows 平台沿用 WTS 的会话状态取值，界面层无需区分平台
+typedef enum _WTS_CONNECTSTATE_CLASS {
+    WTSActive,
+    WTSConnected,
+    WTSConnectQuery,
+    WTSShadow,
+    WTSDisconnected,
+    WTSIdle,
+    WTSListen,
+    WTSReset,
+    WTSDown,
+    WTSInit
+} WTS_CONNECTSTATE_CLASS;
+#endif
 
 struct SessionInfo {
     DWORD sessionId;
     std::wstring userName;
     std::wstring domain;
-    std::wstring loginTime;
+    FILETIME loginTime = { 0, 0 };   // 登录时刻，未知时为 0
     WTS_CONNECTSTATE_CLASS state;
+
+    // 登录时间的显示文本，显示时才格式化
+    std::wstring GetLoginTimeString() const {
+        return FileTimeToUInt64(loginTime) != 0 ? FormatFileTimeCached(loginTime).str() : L"unknown";
+    }
 };
 
 class SessionCollector {
 public:
     SessionCollector();
+    // 使用指定的数据源（便于替换平台实现或注入测试数据）
+    explicit SessionCollector(std::unique_ptr<ISessionSource> source);
     ~SessionCollector();
 
     bool Initialize();
@@ -28,7 +53,8 @@ public:
     bool CollectSessions(std::vector<SessionInfo>& sessions);
 
 private:
+    std::unique_ptr<ISessionSource> m_source;
     bool m_initialized;
 };
 
-#endif // SESSIONCOLLECTOR_H    
\ No newline at end of file
+#endif // SESSIONCOLLECTOR_H
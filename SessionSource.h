@@ -0,0 +1,23 @@
+﻿// SessionSource.h
+#pragma once
+#include "PlatformCompat.h"
+#include <memory>
+#include <vector>
+
+struct SessionInfo;
+
+// 登录会话数据源接口 - 屏蔽各平台的会话枚举实现
+// Windows 实现见 SessionSourceWin.cpp（WTS），Linux 实现见 SessionSourceLinux.cpp（utmp）
+class ISessionSource {
+public:
+    virtual ~ISessionSource() = default;
+
+    virtual bool Initialize() = 0;
+    virtual void Cleanup() = 0;
+
+    // 枚举当前全部登录会话
+    virtual bool EnumerateSessions(std::vector<SessionInfo>& sessions) = 0;
+};
+
+// 创建当前平台的默认会话数据源
+std::unique_ptr<ISessionSource> CreateSessionSource();
@@ -0,0 +1,54 @@
+﻿// SessionSourceLinux.cpp
+// Linux 会话数据源：读取 utmp 中的 USER_PROCESS 记录
+#ifdef __linux__
+#include "SessionCollector.h"
+#include <utmpx.h>
+#include <cstring>
+#include <string>
+
+class LinuxSessionSource : public ISessionSource {
+public:
+    bool Initialize() override { return true; }
+    void Cleanup() override {}
+
+    bool EnumerateSessions(std::vector<SessionInfo>& sessions) override;
+};
+
+bool LinuxSessionSource::EnumerateSessions(std::vector<SessionInfo>& sessions) {
+    setutxent();
+
+    struct utmpx* entry;
+    while ((entry = getutxent()) != nullptr) {
+        if (entry->ut_type != USER_PROCESS) {
+            continue;
+        }
+
+        SessionInfo info;
+        // utmp 没有会话号，使用登录进程 PID 作为会话标识
+        info.sessionId = static_cast<DWORD>(entry->ut_pid);
+        info.userName = Utf8ToWide(std::string(entry->ut_user, strnlen(entry->ut_user, sizeof(entry->ut_user))));
+
+        // 远程登录记录来源主机，本地登录记录终端名
+        std::string host(entry->ut_host, strnlen(entry->ut_host, sizeof(entry->ut_host)));
+        if (host.empty()) {
+            host.assign(entry->ut_line, strnlen(entry->ut_line, sizeof(entry->ut_line)));
+        }
+        info.domain = host.empty() ? L"unknown" : Utf8ToWide(host);
+
+        ULONGLONG loginTime = static_cast<ULONGLONG>(entry->ut_tv.tv_sec) * 10000000ULL
+            + static_cast<ULONGLONG>(entry->ut_tv.tv_usec) * 10ULL + kUnixEpochInFileTime;
+        info.loginTime = UInt64ToFileTime(loginTime);
+        info.state = WTSActive;
+
+        sessions.push_back(info);
+    }
+
+    endutxent();
+    return true;
+}
+
+std::unique_ptr<ISessionSource> CreateSessionSource() {
+    return std::make_unique<LinuxSessionSource>();
+}
+
+#endif // __linux__
@@ -0,0 +1,99 @@
+﻿// SessionSourceWin.cpp
+// Windows 会话数据源：通过 WTS API 枚举登录会话
+#ifdef _WIN32
+#include "SessionCollector.h"
+
+#pragma comment(lib, "wtsapi32.lib")
+
+class WinSessionSource : public ISessionSource {
+public:
+    bool Initialize() override { return true; }
+    void Cleanup() override {}
+
+    bool EnumerateSessions(std::vector<SessionInfo>& sessions) override;
+};
+
+bool WinSessionSource::EnumerateSessions(std::vector<SessionInfo>& sessions) {
+    // 枚举会话
+    DWORD sessionCount = 0;
+    PWTS_SESSION_INFOW sessionInfo = NULL;
+
+    if (!WTSEnumerateSessionsW(WTS_CURRENT_SERVER_HANDLE, 0, 1, &sessionInfo, &sessionCount)) {
+        return false;
+    }
+
+    // 处理每个会话
+    for (DWORD i = 0; i < sessionCount; ++i) {
+        SessionInfo info;
+        info.sessionId = sessionInfo[i].SessionId;
+        info.state = sessionInfo[i].State;
+
+        // 获取用户名
+        LPWSTR userName = NULL;
+        DWORD userNameSize = 0; // 新增变量用于存储数据大小
+        if (WTSQuerySessionInformationW(
+            WTS_CURRENT_SERVER_HANDLE,
+            info.sessionId,
+            WTSUserName,
+            &userName,
+            &userNameSize // 传递变量地址而非NULL
+        )) {
+            info.userName = userName ? userName : L"unknown";
+            if (userName) WTSFreeMemory(userName);
+        }
+        else {
+            info.userName = L"unknown";
+        }
+
+        // 获取域名
+        LPWSTR domainName = NULL;
+        DWORD domainNameSize = 0; // 新增变量用于存储数据大小
+        if (WTSQuerySessionInformationW(
+            WTS_CURRENT_SERVER_HANDLE,
+            info.sessionId,
+            WTSDomainName,
+            &domainName,
+            &domainNameSize // 传递变量地址而非NULL
+        )) {
+            info.domain = domainName ? domainName : L"unknown";
+            if (domainName) WTSFreeMemory(domainName);
+        }
+        else {
+            info.domain = L"unknown";
+        }
+
+        // 获取登录时间 (兼容旧SDK版本)
+
+        // 尝试使用WTSQuerySessionInformation获取登录时间
+        DWORD timeType = 0;
+        LPWSTR timeStr = NULL;
+        if (WTSQuerySessionInformationW(
+            WTS_CURRENT_SERVER_HANDLE,
+            info.sessionId,
+            (WTS_INFO_CLASS)14, // 对应WTSConnectTime的值(如果SDK中未定义)
+            &timeStr,
+            &timeType // 这里已经正确传递了变量地址
+        )) {
+            if (timeType == sizeof(FILETIME)) {
+                FILETIME* pTime = reinterpret_cast<FILETIME*>(timeStr);
+                info.loginTime = *pTime;
+            }
+            if (timeStr) WTSFreeMemory(timeStr);
+        }
+
+        sessions.push_back(info);
+    }
+
+    // 释放会话信息内存
+    if (sessionInfo) {
+        WTSFreeMemory(sessionInfo);
+    }
+
+    return true;
+}
+
+std::unique_ptr<ISessionSource> CreateSessionSource() {
+    return std::make_unique<WinSessionSource>();
+}
+
+#endif // _WIN32
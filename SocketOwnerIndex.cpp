@@ -0,0 +1,230 @@
+﻿// SocketOwnerIndex.cpp
+// 仅 Linux 使用：Windows 的连接表直接提供所属 PID
+#ifdef __linux__
+#include "SocketOwnerIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+SocketOwnerIndex::SocketOwnerIndex(size_t workerCount)
+    : m_generation(0), m_fullRescanInterval(30), m_workerCount(workerCount ? workerCount : 1) {}
+
+SocketOwnerIndex::~SocketOwnerIndex() = default;
+
+void SocketOwnerIndex::Refresh() {
+    auto start = std::chrono::steady_clock::now();
+    ++m_generation;
+    bool fullRescan = m_fullRescanInterval != 0 && m_generation % m_fullRescanInterval == 0;
+
+    DIR* procDir = opendir("/proc");
+    if (!procDir) {
+        return;
+    }
+
+    // 1. 枚举进程并检查打开文件数，记录需要重新扫描的进程
+    size_t processCount = 0;
+    size_t scanCount = 0;
+    while (dirent* procEntry = readdir(procDir)) {
+        char* end = nullptr;
+        unsigned long value = strtoul(procEntry->d_name, &end, 10);
+        DWORD pid = static_cast<DWORD>(value);
+        DWORD fdCount = 0;
+        if (*end != '\0' || pid == 0 || !CountFds(pid, fdCount)) {
+            continue;  // 非进程目录、进程已退出或无权限
+        }
+
+        ++processCount;
+        ProcessEntry& entry = m_processes[pid];
+        entry.lastSeen = m_generation;
+        if (!entry.stale && !fullRescan && entry.fdCount == fdCount) {
+            continue;
+        }
+
+        if (scanCount == m_results.size()) {
+            m_results.emplace_back();
+        }
+        ScanResult& result = m_results[scanCount++];
+        result.pid = pid;
+        result.fdCount = fdCount;
+    }
+    closedir(procDir);
+
+    // 2. 并行读取待扫描进程的 fd 符号链接
+    if (!m_pool) {
+        m_pool = std::make_unique<WorkStealingPool>(m_workerCount);
+    }
+    m_pool->ParallelFor(scanCount, [this](size_t i) {
+        ReadSocketInodes(m_results[i]);
+    });
+
+    // 3. 按进程顺序合并；读取失败的进程保持待扫描状态
+    for (size_t i = 0; i < scanCount; ++i) {
+        ScanResult& result = m_results[i];
+        if (!result.ok) {
+            continue;
+        }
+
+        ProcessEntry& entry = m_processes[result.pid];
+        UpdateHolders(result.pid, entry.inodes, result.inodes);
+        entry.inodes.swap(result.inodes);
+        entry.fdCount = result.fdCount;
+        entry.stale = false;
+    }
+
+    // 4. 移除已退出的进程
+    for (auto it = m_processes.begin(); it != m_processes.end();) {
+        if (it->second.lastSeen != m_generation) {
+            for (ULONGLONG inode : it->second.inodes) {
+                RemoveHolder(inode, it->first);
+            }
+            it = m_processes.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    m_stats.processCount = processCount;
+    m_stats.scannedCount = scanCount;
+    m_stats.socketCount = m_owners.size();
+    m_stats.fullRescan = fullRescan;
+    m_stats.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 打开文件数优先取 fd 目录的 st_size（Linux 6.2 起为打开文件数），旧内核退回逐项计数
+bool SocketOwnerIndex::CountFds(DWORD pid, DWORD& fdCount) {
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%u/fd", pid);
+
+    struct stat fdStat;
+    if (stat(path, &fdStat) != 0) {
+        return false;
+    }
+    if (fdStat.st_size > 0) {
+        fdCount = static_cast<DWORD>(fdStat.st_size);
+        return true;
+    }
+
+    DIR* fdDir = opendir(path);
+    if (!fdDir) {
+        return false;
+    }
+    fdCount = 0;
+    while (dirent* fdEntry = readdir(fdDir)) {
+        if (fdEntry->d_name[0] != '.') {
+            ++fdCount;
+        }
+    }
+    closedir(fdDir);
+    return true;
+}
+
+// 读取进程的全部 fd 符号链接，记录 "socket:[inode]" 形式的目标
+void SocketOwnerIndex::ReadSocketInodes(ScanResult& result) {
+    result.inodes.clear();
+
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%u/fd", result.pid);
+    DIR* fdDir = opendir(path);
+    result.ok = fdDir != nullptr;
+    if (!fdDir) {
+        return;
+    }
+
+    int fdDirHandle = dirfd(fdDir);
+    char target[64];
+    while (dirent* fdEntry = readdir(fdDir)) {
+        if (fdEntry->d_name[0] == '.') {
+            continue;
+        }
+        ssize_t length = readlinkat(fdDirHandle, fdEntry->d_name, target, sizeof(target) - 1);
+        if (length <= 8 || memcmp(target, "socket:[", 8) != 0) {
+            continue;
+        }
+        target[length] = '\0';
+        result.inodes.push_back(strtoull(target + 8, nullptr, 10));
+    }
+    closedir(fdDir);
+
+    // 同一套接字可能被 dup 到多个 fd
+    std::sort(result.inodes.begin(), result.inodes.end());
+    result.inodes.erase(std::unique(result.inodes.begin(), result.inodes.end()), result.inodes.end());
+}
+
+void SocketOwnerIndex::AddHolder(ULONGLONG inode, DWORD pid) {
+    auto [it, inserted] = m_owners.try_emplace(inode);
+    OwnerEntry& entry = it->second;
+    if (inserted) {
+        entry.owner = pid;
+    }
+    else if (entry.owner != pid && std::find(entry.others.begin(), entry.others.end(), pid) == entry.others.end()) {
+        entry.others.push_back(pid);
+    }
+}
+
+// 所属进程不再持有时由最早加入的其余持有进程接替，没有其余持有进程时删除记录
+void SocketOwnerIndex::RemoveHolder(ULONGLONG inode, DWORD pid) {
+    auto it = m_owners.find(inode);
+    if (it == m_owners.end()) {
+        return;
+    }
+
+    OwnerEntry& entry = it->second;
+    if (entry.owner == pid) {
+        if (entry.others.empty()) {
+            m_owners.erase(it);
+            return;
+        }
+        entry.owner = entry.others.front();
+        entry.others.erase(entry.others.begin());
+    }
+    else {
+        auto holder = std::find(entry.others.begin(), entry.others.end(), pid);
+        if (holder != entry.others.end()) {
+            entry.others.erase(holder);
+        }
+    }
+}
+
+void SocketOwnerIndex::UpdateHolders(DWORD pid, const std::vector<ULONGLONG>& oldInodes, const std::vector<ULONGLONG>& newInodes) {
+    auto oldIt = oldInodes.begin();
+    auto newIt = newInodes.begin();
+    while (oldIt != oldInodes.end() || newIt != newInodes.end()) {
+        if (newIt == newInodes.end() || (oldIt != oldInodes.end() && *oldIt < *newIt)) {
+            RemoveHolder(*oldIt++, pid);
+        }
+        else if (oldIt == oldInodes.end() || *newIt < *oldIt) {
+            AddHolder(*newIt++, pid);
+        }
+        else {
+            ++oldIt;
+            ++newIt;
+        }
+    }
+}
+
+void SocketOwnerIndex::Invalidate(DWORD pid) {
+    auto it = m_processes.find(pid);
+    if (it != m_processes.end()) {
+        it->second.stale = true;
+    }
+}
+
+DWORD SocketOwnerIndex::FindOwner(ULONGLONG inode) const {
+    auto it = m_owners.find(inode);
+    return it != m_owners.end() ? it->second.owner : 0;
+}
+
+void SocketOwnerIndex::Clear() {
+    m_processes.clear();
+    m_owners.clear();
+    m_generation = 0;
+    m_stats = Stats();
+}
+
+#endif // __linux__
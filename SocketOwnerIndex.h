@@ -0,0 +1,84 @@
+﻿// SocketOwnerIndex.h
+#pragma once
+#include "PlatformCompat.h"
+#include "WorkStealingPool.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// 套接字 inode -> 所属进程的持久索引（Linux）。
+// 套接字表只提供 inode，关联进程需要读取 /proc/<pid>/fd 下的每个符号链接，
+// 这是连接采集中开销最大的部分。索引在多次刷新间保留，每次只重新扫描
+// 新出现的进程、打开文件数变化的进程以及被 Invalidate 标记的进程。
+// 打开文件数的检查开销很小，串行进行；待扫描进程在线程池中并行读取，合并按进程顺序串行进行。
+// 打开文件数不变但套接字被替换的情况由定期全量扫描校正。
+// 套接字可被多个进程共享（fork 继承、SCM_RIGHTS 传递），索引记录全部持有进程：
+// 报告的所属进程在仍持有期间保持不变，退出或关闭后改由其余持有进程之一接替。
+class SocketOwnerIndex {
+public:
+    // 最近一次 Refresh 的统计
+    struct Stats {
+        size_t processCount = 0;     // /proc 中的进程数
+        size_t scannedCount = 0;     // 重新读取 fd 目录的进程数
+        size_t socketCount = 0;      // 索引中的套接字数
+        bool fullRescan = false;     // 是否为全量扫描
+        double elapsedMs = 0.0;
+    };
+
+    explicit SocketOwnerIndex(size_t workerCount = WorkStealingPool::DefaultWorkerCount());
+    ~SocketOwnerIndex();
+
+    // 与 /proc 同步索引
+    void Refresh();
+    // 标记进程需要重新扫描（进程启动、退出或更换映像时由进程变化驱动）
+    void Invalidate(DWORD pid);
+    // 所属进程，未知时返回 0
+    DWORD FindOwner(ULONGLONG inode) const;
+
+    // 每隔多少次 Refresh 全量扫描一次，0 表示从不
+    void SetFullRescanInterval(DWORD refreshes) { m_fullRescanInterval = refreshes; }
+    const Stats& GetLastStats() const { return m_stats; }
+
+    void Clear();
+
+private:
+    struct ProcessEntry {
+        std::vector<ULONGLONG> inodes;   // 上次扫描到的套接字（有序、去重）
+        DWORD fdCount = 0;               // 上次扫描时的打开文件数
+        DWORD lastSeen = 0;              // 最近一次出现在 /proc 中的刷新轮次
+        bool stale = true;               // 需要重新扫描
+    };
+
+    // 单个待扫描进程的并行读取结果
+    struct ScanResult {
+        DWORD pid = 0;
+        DWORD fdCount = 0;
+        std::vector<ULONGLONG> inodes;   // 有序、去重
+        bool ok = false;                 // fd 目录可读（进程未退出且有权限）
+    };
+
+    // 单个套接字的持有进程；绝大多数套接字只有一个持有者，others 为空时不分配内存
+    struct OwnerEntry {
+        DWORD owner = 0;                 // 报告的所属进程
+        std::vector<DWORD> others;       // 其余持有进程，按加入顺序
+    };
+
+    static bool CountFds(DWORD pid, DWORD& fdCount);
+    static void ReadSocketInodes(ScanResult& result);
+    void AddHolder(ULONGLONG inode, DWORD pid);
+    void RemoveHolder(ULONGLONG inode, DWORD pid);
+    // 按新旧两份有序列表的差异更新持有关系，两边都有的套接字保持不动
+    void UpdateHolders(DWORD pid, const std::vector<ULONGLONG>& oldInodes, const std::vector<ULONGLONG>& newInodes);
+
+    std::unordered_map<DWORD, ProcessEntry> m_processes;
+    std::unordered_map<ULONGLONG, OwnerEntry> m_owners;
+    DWORD m_generation;
+    DWORD m_fullRescanInterval;
+
+    // 在多次刷新间复用
+    std::vector<ScanResult> m_results;
+
+    size_t m_workerCount;
+    std::unique_ptr<WorkStealingPool> m_pool;
+    Stats m_stats;
+};
@@ -0,0 +1,82 @@
+﻿// StringPool.cpp
+#include "StringPool.h"
+
+// 驻留池有意不析构：其他静态对象（如 DataManager 单例）析构时仍可能释放句柄
+StringPool& StringPool::Instance() {
+    static StringPool* instance = new StringPool();
+    return *instance;
+}
+
+StringPool::Entry* StringPool::Intern(std::wstring_view value) {
+    // 取哈希的高位选分片，与分片内哈希表使用的低位错开
+    size_t hash = std::hash<std::wstring_view>()(value);
+    Shard& shard = m_shards[(hash >> (sizeof(size_t) * 8 - 4)) % kShardCount];
+    shard.internCalls.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(value);
+        if (it != shard.entries.end()) {
+            // 命中时可能恰好是引用计数为零、等待回收的条目；回收需要独占锁，
+            // 在共享锁内加引用即可使其复活
+            it->second->refs.fetch_add(1, std::memory_order_relaxed);
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    // 释放共享锁后其他线程可能已插入同一字符串
+    auto it = shard.entries.find(value);
+    if (it != shard.entries.end()) {
+        it->second->refs.fetch_add(1, std::memory_order_relaxed);
+        return it->second;
+    }
+
+    Entry* entry = new Entry();
+    entry->value.assign(value.data(), value.size());
+    entry->refs.store(1, std::memory_order_relaxed);
+    shard.entries.emplace(std::wstring_view(entry->value), entry);
+
+    ++shard.allocations;
+    shard.bytes += entry->value.capacity() * sizeof(wchar_t);
+    return entry;
+}
+
+size_t StringPool::Reclaim() {
+    size_t total = 0;
+    for (Shard& shard : m_shards) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+        // 引用计数为零后只能在分片锁内通过 Intern 复活，因此持有独占锁时判断为零即可安全释放
+        size_t count = 0;
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            Entry* entry = it->second;
+            if (entry->refs.load(std::memory_order_acquire) == 0) {
+                shard.bytes -= entry->value.capacity() * sizeof(wchar_t);
+                it = shard.entries.erase(it);
+                delete entry;
+                ++count;
+            }
+            else {
+                ++it;
+            }
+        }
+
+        shard.reclaimed += count;
+        total += count;
+    }
+    return total;
+}
+
+StringPool::Stats StringPool::GetStats() const {
+    Stats stats;
+    for (const Shard& shard : m_shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        stats.entries += shard.entries.size();
+        stats.bytes += shard.bytes;
+        stats.internCalls += shard.internCalls.load(std::memory_order_relaxed);
+        stats.allocations += shard.allocations;
+        stats.reclaimed += shard.reclaimed;
+    }
+    return stats;
+}
@@ -0,0 +1,127 @@
+﻿// StringPool.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// 全局字符串驻留池：相同内容的字符串只保存一份，InternedString 以指针形式引用。
+// 进程名、路径等字段在相邻两次刷新之间几乎不变，驻留后复制快照只需增加引用计数。
+// 引用计数归零的条目不会立即释放，而是在 Reclaim()（每次刷新结束时调用）中统一回收，
+// 这样减引用无需加锁，也不会与并发的 Intern 发生释放竞争。
+// 条目按哈希分布到多个分片，命中只取分片的共享锁，并行补全进程时各线程互不阻塞。
+class StringPool {
+public:
+    struct Entry {
+        std::wstring value;
+        std::atomic<uint32_t> refs{ 0 };
+    };
+
+    struct Stats {
+        size_t entries = 0;           // 当前条目数
+        size_t bytes = 0;             // 条目字符串占用的字节数
+        uint64_t internCalls = 0;     // 累计驻留请求次数
+        uint64_t allocations = 0;     // 其中新建条目（发生分配）的次数
+        uint64_t reclaimed = 0;       // 累计回收的条目数
+    };
+
+    static StringPool& Instance();
+
+    // 返回已增加引用计数的条目
+    Entry* Intern(std::wstring_view value);
+    // 回收引用计数为零的条目，返回回收数量
+    size_t Reclaim();
+
+    Stats GetStats() const;
+
+private:
+    StringPool() = default;
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    static const size_t kShardCount = 16;
+
+    // 各分片独占缓存行，避免相邻分片的锁互相干扰
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;   // 命中取共享锁；新建与回收取独占锁
+        std::unordered_map<std::wstring_view, Entry*> entries;  // 键指向条目自身的字符串
+        std::atomic<uint64_t> internCalls{ 0 };
+        uint64_t allocations = 0;          // 以下字段只在独占锁内修改
+        uint64_t reclaimed = 0;
+        size_t bytes = 0;
+    };
+
+    Shard m_shards[kShardCount];
+};
+
+// 驻留字符串句柄：大小与指针相同，复制只增加引用计数；
+// 可隐式转换为 const std::wstring&，按内容比较等价于按条目指针比较
+class InternedString {
+public:
+    InternedString() = default;
+    InternedString(const std::wstring& value) : m_entry(Acquire(value)) {}
+    InternedString(const wchar_t* value) : m_entry(Acquire(value ? std::wstring_view(value) : std::wstring_view())) {}
+    explicit InternedString(std::wstring_view value) : m_entry(Acquire(value)) {}
+
+    InternedString(const InternedString& other) : m_entry(other.m_entry) {
+        if (m_entry) {
+            m_entry->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    InternedString(InternedString&& other) noexcept : m_entry(other.m_entry) {
+        other.m_entry = nullptr;
+    }
+
+    ~InternedString() { Release(); }
+
+    InternedString& operator=(const InternedString& other) {
+        if (m_entry != other.m_entry) {
+            InternedString copy(other);
+            std::swap(m_entry, copy.m_entry);
+        }
+        return *this;
+    }
+
+    InternedString& operator=(InternedString&& other) noexcept {
+        if (this != &other) {
+            Release();
+            m_entry = other.m_entry;
+            other.m_entry = nullptr;
+        }
+        return *this;
+    }
+
+    const std::wstring& str() const { return m_entry ? m_entry->value : EmptyString(); }
+    operator const std::wstring&() const { return str(); }
+    const wchar_t* c_str() const { return str().c_str(); }
+    bool empty() const { return m_entry == nullptr; }
+    size_t size() const { return str().size(); }
+
+    friend bool operator==(const InternedString& a, const InternedString& b) { return a.m_entry == b.m_entry; }
+    friend bool operator!=(const InternedString& a, const InternedString& b) { return a.m_entry != b.m_entry; }
+
+private:
+    // 空字符串不进入驻留池，以空指针表示
+    static StringPool::Entry* Acquire(std::wstring_view value) {
+        return value.empty() ? nullptr : StringPool::Instance().Intern(value);
+    }
+
+    static const std::wstring& EmptyString() {
+        static const std::wstring empty;
+        return empty;
+    }
+
+    void Release() {
+        if (m_entry) {
+            m_entry->refs.fetch_sub(1, std::memory_order_release);
+            m_entry = nullptr;
+        }
+    }
+
+    StringPool::Entry* m_entry = nullptr;
+};
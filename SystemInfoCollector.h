@@ -2,37 +2,113 @@
 #ifndef SYSTEMINFOCOLLECTOR_H
 #define SYSTEMINFOCOLLECTOR_H
 
-#include <windows.h>
+#include "PlatformCompat.h"
+#include "SystemInfoSource.h"
 #include <vector>
 #include <string>
 #include<memory>
-struct SystemInfo {
+// 逻辑处理器拓扑
+struct CpuTopologyEntry {
+    DWORD cpuId = 0;          // 逻辑处理器编号
+    DWORD packageId = 0;      // 物理封装（插槽）
+    DWORD coreId = 0;         // 物理核心（同一核心的超线程共享该值）
+    DWORD numaNode = 0;
+};
+
+// 单个逻辑处理器的累计时间（100 纳秒）；平台不提供的分项为 0
+struct CpuCoreTimes {
+    DWORD cpuId = 0;
+    ULONGLONG user = 0;       // 含 nice
+    ULONGLONG system = 0;
+    ULONGLONG idle = 0;
+    ULONGLONG iowait = 0;
+    ULONGLONG irq = 0;        // 硬中断与软中断（Windows 为中断与 DPC）
+    ULONGLONG steal = 0;      // 虚拟机中被宿主占用的时间
+
+    ULONGLONG Total() const { return user + system + idle + iowait + irq + steal; }
+};
+
+// 两次采样之间单个逻辑处理器的使用率（%）；iowait 与 idle 一样不计入 total
+struct CpuCoreUsage {
+    DWORD cpuId = 0;
+    float total = 0.0f;
+    float user = 0.0f;
+    float system = 0.0f;
+    float iowait = 0.0f;
+    float irq = 0.0f;
+    float steal = 0.0f;
+};
+
+// 静态清单：运行期间基本不变，启动时采集一次，显式失效后才重新采集
+struct SystemInventory {
     std::wstring osVersion;
     std::wstring hostName;
     std::wstring userName;
-    std::wstring systemUpTime;
-    ULONGLONG totalPhysicalMemory;
-    ULONGLONG availablePhysicalMemory;
+    std::wstring systemUpTime;     // 系统启动时刻（本地时间）
     std::wstring cpuInfo;
-    DWORD cpuCores;
+    DWORD cpuCores = 0;
+    std::vector<CpuTopologyEntry> cpuTopology;   // 按 cpuId 排序；平台不支持时为空
+};
+
+// 内存压力停顿信息（PSI）：some 为至少一个任务因内存停顿，full 为全部非空闲任务同时停顿
+struct MemoryPressure {
+    float someAvg10 = 0.0f;            // 最近 10/60/300 秒内停顿时间占比（%）
+    float someAvg60 = 0.0f;
+    float someAvg300 = 0.0f;
+    float fullAvg10 = 0.0f;
+    float fullAvg60 = 0.0f;
+    float fullAvg300 = 0.0f;
+    ULONGLONG someTotal = 0;           // 累计停顿时间（微秒），用于按采样间隔计算
+    ULONGLONG fullTotal = 0;
+};
+
+// 扩展内存计数器（字节或累计页数）；平台不提供的项为 0，速率由相邻两次采样之差计算
+struct MemoryCounters {
+    ULONGLONG commitTotal = 0;         // 已提交（Linux 为 Committed_AS）
+    ULONGLONG commitLimit = 0;
+    ULONGLONG cached = 0;              // 页缓存
+    ULONGLONG buffers = 0;             // 块设备缓冲区
+    ULONGLONG swapTotal = 0;
+    ULONGLONG swapFree = 0;
+    ULONGLONG swapInPages = 0;         // 累计换入页数
+    ULONGLONG swapOutPages = 0;        // 累计换出页数
+    ULONGLONG majorFaults = 0;         // 累计需要读盘的缺页次数
+    bool hasPressure = false;          // 内核未启用 PSI 或平台不支持时为 false
+    MemoryPressure pressure;
+};
+
+// 动态计数器：每次刷新采样，定长且不含堆内存，采样过程不分配内存
+struct SystemCounters {
+    ULONGLONG sampleTime = 0;          // 采样时刻（FILETIME 计数），0 表示尚未采样
+    ULONGLONG totalPhysicalMemory = 0;
+    ULONGLONG availablePhysicalMemory = 0;
+    MemoryCounters memory;
 
-    FILETIME idleTime;      // 空闲 CPU 时间
-    FILETIME kernelTime;    // 内核模式 CPU 时间
-    FILETIME userTime;      // 用户模式 CPU 时间
+    FILETIME idleTime = { 0, 0 };      // 空闲 CPU 时间
+    FILETIME kernelTime = { 0, 0 };    // 内核模式 CPU 时间（含空闲时间，与 GetSystemTimes 一致）
+    FILETIME userTime = { 0, 0 };      // 用户模式 CPU 时间
 };
 
 class SystemInfoCollector {
 public:
     SystemInfoCollector();
+    // 使用指定的数据源（便于替换平台实现或注入测试数据）
+    explicit SystemInfoCollector(std::unique_ptr<ISystemInfoSource> source);
     ~SystemInfoCollector();
 
     bool Initialize();
     void Cleanup();
 
-    std::unique_ptr<SystemInfo> CollectSystemInfo();
+    // 采集静态清单（开销较大：注册表、系统版本、主机名与用户名等）
+    std::unique_ptr<SystemInventory> CollectInventory();
+    // 采样动态计数器（热路径），失败时 counters 保持不变
+    bool CollectCounters(SystemCounters& counters);
+    // 采样各逻辑处理器的累计时间（按 cpuId 升序），不保存状态；使用率由相邻两次采样计算（见 SystemSampler）。
+    // cores 的容量在多次调用间复用，处理器数不变时不分配内存
+    bool CollectCpuCoreTimes(std::vector<CpuCoreTimes>& cores);
 
-    std::wstring GetOsVersionString();
-    
+private:
+    std::unique_ptr<ISystemInfoSource> m_source;
 };
 
 #endif // SYSTEMINFOCOLLECTOR_H    
\ No newline at end of file
@@ -0,0 +1,29 @@
+﻿// SystemInfoSource.h
+#pragma once
+#include "PlatformCompat.h"
+#include <memory>
+#include <vector>
+
+struct SystemInventory;
+struct SystemCounters;
+struct CpuCoreTimes;
+
+// 系统信息数据源接口 - 屏蔽各平台的系统信息查询实现
+// Windows 实现见 SystemInfoSourceWin.cpp，Linux 实现见 SystemInfoSourceLinux.cpp（/proc）
+class ISystemInfoSource {
+public:
+    virtual ~ISystemInfoSource() = default;
+
+    virtual bool Initialize() = 0;
+    virtual void Cleanup() = 0;
+
+    // 查询静态清单，单项失败时填入占位值而非整体失败
+    virtual bool QueryInventory(SystemInventory& inventory) = 0;
+    // 采样动态计数器；位于刷新热路径，实现不应分配内存或重复解析静态信息
+    virtual bool QueryCounters(SystemCounters& counters) = 0;
+    // 采样各在线逻辑处理器的累计时间，按 cpuId 升序；同样位于热路径，应复用 cores 的容量
+    virtual bool QueryCpuCoreTimes(std::vector<CpuCoreTimes>& cores) = 0;
+};
+
+// 创建当前平台的默认系统信息数据源
+std::unique_ptr<ISystemInfoSource> CreateSystemInfoSource();
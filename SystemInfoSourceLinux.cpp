@@ -0,0 +1,510 @@
+﻿// SystemInfoSourceLinux.cpp
+// Linux 系统信息数据源：/etc/os-release、/proc/meminfo、/proc/vmstat、/proc/pressure/memory、
+// /proc/stat、/proc/cpuinfo、/sys/devices/system
+// 动态计数器文件在 Initialize 时打开并保持，每次采样用 pread 从头读入复用的缓冲区就地解析
+#ifdef __linux__
+#include "SystemInfoCollector.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pwd.h>
+#include <sys/utsname.h>
+
+class LinuxSystemInfoSource : public ISystemInfoSource {
+public:
+    ~LinuxSystemInfoSource() override { Cleanup(); }
+
+    bool Initialize() override;
+    void Cleanup() override;
+
+    bool QueryInventory(SystemInventory& info) override;
+    bool QueryCounters(SystemCounters& counters) override;
+    bool QueryCpuCoreTimes(std::vector<CpuCoreTimes>& cores) override;
+
+private:
+    std::wstring GetOsVersionString();
+    std::wstring GetCpuInfo();
+    std::wstring GetSystemUpTime();
+    void GetCpuTopology(std::vector<CpuTopologyEntry>& topology);
+    bool QueryMemory(SystemCounters& counters);
+    bool QueryVmStat(MemoryCounters& memory);
+    bool QueryPressure(MemoryCounters& memory);
+    bool QueryCpuTimes(SystemCounters& counters);
+    // 从头读取整个文件（超出缓冲区的部分丢弃），返回读到的字节数，失败返回 -1
+    ssize_t ReadFromStart(int fd);
+
+    long m_clockTicks = 100;
+    int m_statFd = -1;
+    int m_memInfoFd = -1;
+    int m_vmStatFd = -1;
+    int m_pressureFd = -1;     // 内核未启用 PSI 时为 -1
+    // /proc/stat 首行、/proc/meminfo（约 1.5KB）与 /proc/pressure/memory 都小于 4KB
+    char m_buffer[4096];
+    // /proc/vmstat 有一百多行且随内核版本增长，读不完整时加倍后重读
+    std::vector<char> m_vmStatBuffer = std::vector<char>(8192);
+    // 逐核采样需要 /proc/stat 的全部 cpuN 行，数百个核心时远超 4KB；按需增长后一直复用
+    std::vector<char> m_statBuffer = std::vector<char>(16384);
+};
+
+bool LinuxSystemInfoSource::Initialize() {
+    m_clockTicks = sysconf(_SC_CLK_TCK);
+    if (m_statFd < 0) {
+        m_statFd = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    }
+    if (m_memInfoFd < 0) {
+        m_memInfoFd = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+    }
+    // 以下两项只用于扩展内存计数器，打不开时相应字段保持为 0
+    if (m_vmStatFd < 0) {
+        m_vmStatFd = open("/proc/vmstat", O_RDONLY | O_CLOEXEC);
+    }
+    if (m_pressureFd < 0) {
+        m_pressureFd = open("/proc/pressure/memory", O_RDONLY | O_CLOEXEC);
+    }
+    return m_clockTicks > 0 && m_statFd >= 0 && m_memInfoFd >= 0;
+}
+
+void LinuxSystemInfoSource::Cleanup() {
+    for (int* fd : { &m_statFd, &m_memInfoFd, &m_vmStatFd, &m_pressureFd }) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+bool LinuxSystemInfoSource::QueryInventory(SystemInventory& info) {
+    info.osVersion = GetOsVersionString();
+
+    // 获取主机名
+    char hostName[256] = { 0 };
+    if (gethostname(hostName, sizeof(hostName) - 1) == 0) {
+        info.hostName = Utf8ToWide(hostName);
+    }
+    else {
+        info.hostName = L"未知主机";
+    }
+
+    // 获取当前用户名
+    struct passwd* pw = getpwuid(geteuid());
+    info.userName = pw ? Utf8ToWide(pw->pw_name) : L"未知用户";
+
+    info.systemUpTime = GetSystemUpTime();
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    info.cpuCores = cores > 0 ? static_cast<DWORD>(cores) : 1;
+    info.cpuInfo = GetCpuInfo();
+    GetCpuTopology(info.cpuTopology);
+    return true;
+}
+
+bool LinuxSystemInfoSource::QueryCounters(SystemCounters& counters) {
+    SystemCounters sample;
+    if (!QueryMemory(sample) || !QueryCpuTimes(sample)) {
+        return false;
+    }
+    QueryVmStat(sample.memory);
+    QueryPressure(sample.memory);
+
+    timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    sample.sampleTime = static_cast<ULONGLONG>(now.tv_sec) * 10000000ULL + now.tv_nsec / 100 + kUnixEpochInFileTime;
+    counters = sample;
+    return true;
+}
+
+ssize_t LinuxSystemInfoSource::ReadFromStart(int fd) {
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t length = pread(fd, m_buffer, sizeof(m_buffer) - 1, 0);
+    if (length < 0) {
+        return -1;
+    }
+    m_buffer[length] = '\0';
+    return length;
+}
+
+// 跳过空白后解析十进制整数
+static ULONGLONG ParseUnsigned(const char*& cursor) {
+    while (*cursor == ' ' || *cursor == '\t') {
+        ++cursor;
+    }
+    ULONGLONG value = 0;
+    while (*cursor >= '0' && *cursor <= '9') {
+        value = value * 10 + static_cast<ULONGLONG>(*cursor - '0');
+        ++cursor;
+    }
+    return value;
+}
+
+// 优先使用 /etc/os-release 中的发行版名称，失败时退回 uname
+std::wstring LinuxSystemInfoSource::GetOsVersionString() {
+    struct utsname uts;
+    std::string kernel = uname(&uts) == 0 ? std::string(uts.sysname) + " " + uts.release : "Linux";
+
+    std::ifstream osRelease("/etc/os-release");
+    std::string line;
+    while (std::getline(osRelease, line)) {
+        if (line.compare(0, 12, "PRETTY_NAME=") == 0) {
+            std::string name = line.substr(12);
+            if (name.size() >= 2 && name.front() == '"' && name.back() == '"') {
+                name = name.substr(1, name.size() - 2);
+            }
+            return Utf8ToWide(name + " (" + kernel + ")");
+        }
+    }
+
+    return Utf8ToWide(kernel);
+}
+
+std::wstring LinuxSystemInfoSource::GetCpuInfo() {
+    std::ifstream cpuInfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuInfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                return Utf8ToWide(line.substr(line.find_first_not_of(' ', colon + 1)));
+            }
+        }
+    }
+    return L"未知";
+}
+
+// 系统启动时刻 = 当前时间 - /proc/uptime，按本地时间格式化
+std::wstring LinuxSystemInfoSource::GetSystemUpTime() {
+    std::ifstream uptimeFile("/proc/uptime");
+    double uptime = 0.0;
+    if (!(uptimeFile >> uptime)) {
+        return L"未知";
+    }
+
+    time_t bootTime = time(nullptr) - static_cast<time_t>(uptime);
+    struct tm local;
+    localtime_r(&bootTime, &local);
+
+    wchar_t buffer[26];
+    swprintf(buffer, sizeof(buffer) / sizeof(buffer[0]), L"%04d-%02d-%02d %02d:%02d:%02d",
+        local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+        local.tm_hour, local.tm_min, local.tm_sec);
+    return std::wstring(buffer);
+}
+
+// 跳过空白后解析 "12.34" 形式的小数
+static float ParseFixed(const char*& cursor) {
+    float value = static_cast<float>(ParseUnsigned(cursor));
+    if (*cursor == '.') {
+        float scale = 0.1f;
+        for (++cursor; *cursor >= '0' && *cursor <= '9'; ++cursor) {
+            value += (*cursor - '0') * scale;
+            scale *= 0.1f;
+        }
+    }
+    return value;
+}
+
+// "Key<分隔符> value" 形式的行，key 含分隔符（meminfo 为 ':'，vmstat 为空格）
+struct KeyField {
+    const char* key;
+    size_t length;
+    ULONGLONG* value;
+};
+
+// 逐行匹配行首的键并写入对应字段，全部找到后提前结束，返回找到的键数
+template <size_t N>
+static size_t ParseKeyValues(const char* text, KeyField (&fields)[N]) {
+    size_t found = 0;
+    for (const char* line = text; *line && found < N;) {
+        const char* cursor = line;
+        for (KeyField& field : fields) {
+            if (strncmp(line, field.key, field.length) == 0) {
+                cursor += field.length;
+                *field.value = ParseUnsigned(cursor);
+                ++found;
+                break;
+            }
+        }
+        const char* next = strchr(cursor, '\n');
+        if (!next) {
+            break;
+        }
+        line = next + 1;
+    }
+    return found;
+}
+
+// /proc/meminfo 每行为 "Key:   value kB"
+bool LinuxSystemInfoSource::QueryMemory(SystemCounters& counters) {
+    if (ReadFromStart(m_memInfoFd) <= 0) {
+        return false;
+    }
+
+    ULONGLONG total = 0, available = 0, cached = 0, buffers = 0;
+    ULONGLONG swapTotal = 0, swapFree = 0, commitLimit = 0, committed = 0;
+    KeyField fields[] = {
+        { "MemTotal:", 9, &total },
+        { "MemAvailable:", 13, &available },
+        { "Buffers:", 8, &buffers },
+        { "Cached:", 7, &cached },
+        { "SwapTotal:", 10, &swapTotal },
+        { "SwapFree:", 9, &swapFree },
+        { "CommitLimit:", 12, &commitLimit },
+        { "Committed_AS:", 13, &committed },
+    };
+    ParseKeyValues(m_buffer, fields);
+    if (total == 0) {
+        return false;
+    }
+
+    counters.totalPhysicalMemory = total * 1024;
+    counters.availablePhysicalMemory = available * 1024;
+    MemoryCounters& memory = counters.memory;
+    memory.cached = cached * 1024;
+    memory.buffers = buffers * 1024;
+    memory.swapTotal = swapTotal * 1024;
+    memory.swapFree = swapFree * 1024;
+    memory.commitLimit = commitLimit * 1024;
+    memory.commitTotal = committed * 1024;
+    return true;
+}
+
+// /proc/vmstat 每行为 "key value"，均为开机以来的累计值
+bool LinuxSystemInfoSource::QueryVmStat(MemoryCounters& memory) {
+    if (m_vmStatFd < 0) {
+        return false;
+    }
+
+    ssize_t length = 0;
+    for (;;) {
+        length = pread(m_vmStatFd, m_vmStatBuffer.data(), m_vmStatBuffer.size() - 1, 0);
+        if (length <= 0) {
+            return false;
+        }
+        if (static_cast<size_t>(length) < m_vmStatBuffer.size() - 1) {
+            break;
+        }
+        m_vmStatBuffer.resize(m_vmStatBuffer.size() * 2);
+    }
+    m_vmStatBuffer[length] = '\0';
+
+    KeyField fields[] = {
+        { "pswpin ", 7, &memory.swapInPages },
+        { "pswpout ", 8, &memory.swapOutPages },
+        { "pgmajfault ", 11, &memory.majorFaults },
+    };
+    return ParseKeyValues(m_vmStatBuffer.data(), fields) == 3;
+}
+
+// /proc/pressure/memory 两行："some avg10=0.00 avg60=0.00 avg300=0.00 total=0" 与同格式的 "full ..."
+static void ParsePressureLine(const char* cursor, float& avg10, float& avg60, float& avg300, ULONGLONG& total) {
+    for (float* average : { &avg10, &avg60, &avg300 }) {
+        cursor = strchr(cursor, '=');
+        if (!cursor) {
+            return;
+        }
+        ++cursor;
+        *average = ParseFixed(cursor);
+    }
+    cursor = strchr(cursor, '=');
+    if (cursor) {
+        ++cursor;
+        total = ParseUnsigned(cursor);
+    }
+}
+
+bool LinuxSystemInfoSource::QueryPressure(MemoryCounters& memory) {
+    if (ReadFromStart(m_pressureFd) <= 0) {
+        return false;
+    }
+
+    MemoryPressure& pressure = memory.pressure;
+    for (const char* line = m_buffer; *line;) {
+        if (strncmp(line, "some ", 5) == 0) {
+            ParsePressureLine(line + 5, pressure.someAvg10, pressure.someAvg60, pressure.someAvg300, pressure.someTotal);
+            memory.hasPressure = true;
+        }
+        else if (strncmp(line, "full ", 5) == 0) {
+            ParsePressureLine(line + 5, pressure.fullAvg10, pressure.fullAvg60, pressure.fullAvg300, pressure.fullTotal);
+        }
+        const char* next = strchr(line, '\n');
+        if (!next) {
+            break;
+        }
+        line = next + 1;
+    }
+    return memory.hasPressure;
+}
+
+// /proc/stat 首行为全部 CPU 的累计滴答数：user nice system idle iowait irq softirq steal
+// 为与 GetSystemTimes 语义一致，kernelTime 中包含 idle 时间
+bool LinuxSystemInfoSource::QueryCpuTimes(SystemCounters& counters) {
+    if (ReadFromStart(m_statFd) <= 0 || strncmp(m_buffer, "cpu ", 4) != 0) {
+        return false;
+    }
+
+    const char* cursor = m_buffer + 4;
+    ULONGLONG ticks[8];
+    for (ULONGLONG& value : ticks) {
+        value = ParseUnsigned(cursor);
+    }
+    ULONGLONG user = ticks[0], nice = ticks[1], system = ticks[2], idle = ticks[3];
+    ULONGLONG iowait = ticks[4], irq = ticks[5], softirq = ticks[6], steal = ticks[7];
+
+    auto toFileTime = [this](ULONGLONG value) {
+        return UInt64ToFileTime(value * 10000000ULL / static_cast<ULONGLONG>(m_clockTicks));
+    };
+
+    ULONGLONG idleTicks = idle + iowait;
+    counters.idleTime = toFileTime(idleTicks);
+    counters.kernelTime = toFileTime(system + irq + softirq + steal + idleTicks);
+    counters.userTime = toFileTime(user + nice);
+    return true;
+}
+
+// cpuN 行之后是 intr 行；缓冲区读满且还没读到 intr 时加倍重读，保证所有 cpuN 行完整
+bool LinuxSystemInfoSource::QueryCpuCoreTimes(std::vector<CpuCoreTimes>& cores) {
+    if (m_statFd < 0) {
+        return false;
+    }
+
+    ssize_t length = 0;
+    for (;;) {
+        length = pread(m_statFd, m_statBuffer.data(), m_statBuffer.size() - 1, 0);
+        if (length <= 0) {
+            return false;
+        }
+        m_statBuffer[length] = '\0';
+        if (static_cast<size_t>(length) < m_statBuffer.size() - 1 || strstr(m_statBuffer.data(), "\nintr ")) {
+            break;
+        }
+        m_statBuffer.resize(m_statBuffer.size() * 2);
+    }
+
+    auto toHundredNanoseconds = [this](ULONGLONG ticks) {
+        return ticks * 10000000ULL / static_cast<ULONGLONG>(m_clockTicks);
+    };
+
+    cores.clear();
+    for (const char* line = m_statBuffer.data(); strncmp(line, "cpu", 3) == 0;) {
+        const char* cursor = line + 3;
+        // 跳过首行的汇总 "cpu "
+        if (*cursor >= '0' && *cursor <= '9') {
+            CpuCoreTimes core;
+            core.cpuId = static_cast<DWORD>(ParseUnsigned(cursor));
+            ULONGLONG ticks[8];
+            for (ULONGLONG& value : ticks) {
+                value = ParseUnsigned(cursor);
+            }
+            core.user = toHundredNanoseconds(ticks[0] + ticks[1]);
+            core.system = toHundredNanoseconds(ticks[2]);
+            core.idle = toHundredNanoseconds(ticks[3]);
+            core.iowait = toHundredNanoseconds(ticks[4]);
+            core.irq = toHundredNanoseconds(ticks[5] + ticks[6]);
+            core.steal = toHundredNanoseconds(ticks[7]);
+            cores.push_back(core);
+        }
+        const char* next = strchr(cursor, '\n');
+        if (!next) {
+            break;
+        }
+        line = next + 1;
+    }
+    return !cores.empty();
+}
+
+// 读取 sysfs 中只含一个整数的文件，失败返回 defaultValue
+static DWORD ReadSysfsValue(const std::string& path, DWORD defaultValue) {
+    std::ifstream file(path);
+    long value = 0;
+    return (file >> value) && value >= 0 ? static_cast<DWORD>(value) : defaultValue;
+}
+
+// 解析 "0-3,8-11" 形式的 CPU 列表，对其中每个编号调用 visit
+template <typename Visitor>
+static void ForEachCpuInList(const std::string& list, Visitor visit) {
+    const char* cursor = list.c_str();
+    while (*cursor >= '0' && *cursor <= '9') {
+        ULONGLONG first = ParseUnsigned(cursor);
+        ULONGLONG last = first;
+        if (*cursor == '-') {
+            ++cursor;
+            last = ParseUnsigned(cursor);
+        }
+        for (ULONGLONG cpu = first; cpu <= last; ++cpu) {
+            visit(static_cast<DWORD>(cpu));
+        }
+        if (*cursor != ',') {
+            break;
+        }
+        ++cursor;
+    }
+}
+
+// 封装与核心编号来自 cpuN/topology，NUMA 节点来自 nodeN/cpulist；离线的 CPU 没有 topology 目录，不列出
+void LinuxSystemInfoSource::GetCpuTopology(std::vector<CpuTopologyEntry>& topology) {
+    topology.clear();
+    const std::string cpuRoot = "/sys/devices/system/cpu/";
+    if (DIR* dir = opendir(cpuRoot.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            const char* cursor = entry->d_name;
+            if (strncmp(cursor, "cpu", 3) != 0 || cursor[3] < '0' || cursor[3] > '9') {
+                continue;
+            }
+            cursor += 3;
+            CpuTopologyEntry cpu;
+            cpu.cpuId = static_cast<DWORD>(ParseUnsigned(cursor));
+            if (*cursor != '\0') {
+                continue;
+            }
+            std::string base = cpuRoot + entry->d_name + "/topology/";
+            if (access(base.c_str(), F_OK) != 0) {
+                continue;
+            }
+            cpu.packageId = ReadSysfsValue(base + "physical_package_id", 0);
+            cpu.coreId = ReadSysfsValue(base + "core_id", cpu.cpuId);
+            topology.push_back(cpu);
+        }
+        closedir(dir);
+    }
+    std::sort(topology.begin(), topology.end(),
+        [](const CpuTopologyEntry& a, const CpuTopologyEntry& b) { return a.cpuId < b.cpuId; });
+
+    const std::string nodeRoot = "/sys/devices/system/node/";
+    if (DIR* dir = opendir(nodeRoot.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            const char* cursor = entry->d_name;
+            if (strncmp(cursor, "node", 4) != 0 || cursor[4] < '0' || cursor[4] > '9') {
+                continue;
+            }
+            cursor += 4;
+            DWORD node = static_cast<DWORD>(ParseUnsigned(cursor));
+            std::ifstream file(nodeRoot + entry->d_name + "/cpulist");
+            std::string list;
+            if (!std::getline(file, list)) {
+                continue;
+            }
+            ForEachCpuInList(list, [&topology, node](DWORD cpuId) {
+                auto it = std::lower_bound(topology.begin(), topology.end(), cpuId,
+                    [](const CpuTopologyEntry& cpu, DWORD id) { return cpu.cpuId < id; });
+                if (it != topology.end() && it->cpuId == cpuId) {
+                    it->numaNode = node;
+                }
+            });
+        }
+        closedir(dir);
+    }
+}
+
+std::unique_ptr<ISystemInfoSource> CreateSystemInfoSource() {
+    return std::make_unique<LinuxSystemInfoSource>();
+}
+
+#endif // __linux__
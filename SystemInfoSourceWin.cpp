@@ -0,0 +1,377 @@
+﻿// SystemInfoSourceWin.cpp
+// Windows 系统信息数据源
+#ifdef _WIN32
+#include "SystemInfoCollector.h"
+#include <lmcons.h> // 包含UNLEN和相关常量定义
+#include <psapi.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <winternl.h>
+
+#pragma comment(lib, "psapi.lib")
+
+class WinSystemInfoSource : public ISystemInfoSource {
+public:
+    bool Initialize() override;
+    void Cleanup() override {}
+
+    bool QueryInventory(SystemInventory& inventory) override;
+    bool QueryCounters(SystemCounters& counters) override;
+    bool QueryCpuCoreTimes(std::vector<CpuCoreTimes>& cores) override;
+
+private:
+    typedef NTSTATUS(WINAPI* NtQuerySystemInformationPtr)(SYSTEM_INFORMATION_CLASS, PVOID, ULONG, PULONG);
+    typedef NTSTATUS(WINAPI* NtQuerySystemInformationExPtr)(SYSTEM_INFORMATION_CLASS, PVOID, ULONG, PVOID, ULONG, PULONG);
+
+    std::wstring GetOsVersionString();
+    void GetCpuTopology(std::vector<CpuTopologyEntry>& topology);
+
+    NtQuerySystemInformationPtr m_queryInformation = nullptr;
+    NtQuerySystemInformationExPtr m_queryInformationEx = nullptr;
+    WORD m_groupCount = 1;
+    std::vector<SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION> m_processorTimes;   // 单个处理器组的查询缓冲区
+};
+
+// NtQuerySystemInformation(Ex) 只在这里解析一次；缓冲区按逻辑处理器最多的处理器组分配
+bool WinSystemInfoSource::Initialize() {
+    HMODULE hNtdll = GetModuleHandleW(L"ntdll.dll");
+    if (hNtdll) {
+        m_queryInformation = reinterpret_cast<NtQuerySystemInformationPtr>(
+            GetProcAddress(hNtdll, "NtQuerySystemInformation"));
+        m_queryInformationEx = reinterpret_cast<NtQuerySystemInformationExPtr>(
+            GetProcAddress(hNtdll, "NtQuerySystemInformationEx"));
+    }
+    m_groupCount = (std::max)(GetActiveProcessorGroupCount(), static_cast<WORD>(1));
+    DWORD maxGroupSize = 0;
+    for (WORD group = 0; group < m_groupCount; ++group) {
+        maxGroupSize = (std::max)(maxGroupSize, GetActiveProcessorCount(group));
+    }
+    m_processorTimes.resize(maxGroupSize > 0 ? maxGroupSize : 1);
+    return true;
+}
+
+// 辅助函数：获取CPU信息
+static std::wstring GetCpuInfo() {
+    std::wstring cpuInfo = L"未知";
+
+    // 获取CPU信息
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+
+    // 获取CPU名称
+    HKEY hKey;
+    if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0", 0, KEY_READ, &hKey) == ERROR_SUCCESS) {
+        WCHAR cpuName[512] = { 0 };
+        DWORD size = 512;
+        if (RegQueryValueExW(hKey, L"ProcessorNameString", 0, NULL, (LPBYTE)cpuName, &size) == ERROR_SUCCESS) {
+            cpuInfo = cpuName;
+        }
+        RegCloseKey(hKey);
+    }
+
+    return cpuInfo;
+}
+
+// 辅助函数：获取系统启动时间
+static std::wstring GetSystemUpTime() {
+    FILETIME ftNow, ftSystemStart;
+    GetSystemTimeAsFileTime(&ftNow);
+
+    ULARGE_INTEGER uiNow, uiSystemStart;
+    uiNow.LowPart = ftNow.dwLowDateTime;
+    uiNow.HighPart = ftNow.dwHighDateTime;
+
+    // 获取系统启动时间
+    DWORD upTime = GetTickCount();
+    ULONGLONG systemStartTime = uiNow.QuadPart - (upTime * 10000); // 转换为100纳秒为单位
+
+    ftSystemStart.dwLowDateTime = systemStartTime & 0xFFFFFFFF;
+    ftSystemStart.dwHighDateTime = systemStartTime >> 32;
+
+    // 转换为本地时间
+    SYSTEMTIME stLocal;
+    FileTimeToLocalFileTime(&ftSystemStart, &ftSystemStart);
+    FileTimeToSystemTime(&ftSystemStart, &stLocal);
+
+    wchar_t buffer[26];
+    swprintf_s(buffer, L"%04d-%02d-%02d %02d:%02d:%02d",
+        stLocal.wYear, stLocal.wMonth, stLocal.wDay,
+        stLocal.wHour, stLocal.wMinute, stLocal.wSecond);
+
+    return std::wstring(buffer);
+}
+
+// 静态清单：注册表、RtlGetVersion、主机名与用户名只在这里查询
+bool WinSystemInfoSource::QueryInventory(SystemInventory& info) {
+    // 获取操作系统版本
+    info.osVersion = GetOsVersionString();
+
+    // 获取主机名
+    wchar_t hostName[MAX_COMPUTERNAME_LENGTH + 1] = { 0 };
+    DWORD hostNameSize = MAX_COMPUTERNAME_LENGTH + 1;
+    if (!GetComputerNameW(hostName, &hostNameSize)) {
+        info.hostName = L"未知主机";
+        std::wcerr << L"GetComputerNameW failed with error: " << GetLastError() << std::endl;
+    }
+    else {
+        info.hostName = hostName;
+    }
+
+    // 获取当前用户名
+    wchar_t userName[UNLEN + 1] = { 0 };
+    DWORD userNameSize = UNLEN + 1;
+    if (!GetUserNameW(userName, &userNameSize)) {
+        info.userName = L"未知用户";
+        std::wcerr << L"GetUserNameW failed with error: " << GetLastError() << std::endl;
+    }
+    else {
+        info.userName = userName;
+    }
+
+    // 获取系统启动时间
+    info.systemUpTime = GetSystemUpTime();
+
+    // 获取CPU信息（核心数和型号）
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    info.cpuCores = sysInfo.dwNumberOfProcessors;
+    info.cpuInfo = GetCpuInfo();
+    GetCpuTopology(info.cpuTopology);
+
+    return true;
+}
+
+// 动态计数器：只有几次系统调用，不分配内存
+bool WinSystemInfoSource::QueryCounters(SystemCounters& counters) {
+    MEMORYSTATUSEX memInfo = { 0 };
+    memInfo.dwLength = sizeof(MEMORYSTATUSEX);
+    if (!GlobalMemoryStatusEx(&memInfo)) {
+        std::wcerr << L"GlobalMemoryStatusEx failed with error: " << GetLastError() << std::endl;
+        return false;
+    }
+
+    // 通过GetSystemTimes获取系统级CPU时间（自系统启动以来的累计时间）
+    FILETIME idleTime, kernelTime, userTime;
+    if (!GetSystemTimes(&idleTime, &kernelTime, &userTime)) {
+        std::wcerr << L"GetSystemTimes failed with error: " << GetLastError() << std::endl;
+        return false;
+    }
+
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    counters.sampleTime = FileTimeToUInt64(now);
+    counters.totalPhysicalMemory = memInfo.ullTotalPhys;
+    counters.availablePhysicalMemory = memInfo.ullAvailPhys;
+    counters.idleTime = idleTime;       // 系统空闲时间（所有CPU核心的总空闲时间）
+    counters.kernelTime = kernelTime;   // 内核模式时间（系统+驱动程序使用的CPU时间）
+    counters.userTime = userTime;       // 用户模式时间（应用程序使用的CPU时间）
+
+    // 提交量与系统缓存；页面文件用量、换入换出与主缺页没有廉价的累计计数，保持为 0
+    PERFORMANCE_INFORMATION performance = { 0 };
+    performance.cb = sizeof(performance);
+    if (GetPerformanceInfo(&performance, sizeof(performance))) {
+        ULONGLONG pageSize = performance.PageSize;
+        counters.memory.commitTotal = performance.CommitTotal * pageSize;
+        counters.memory.commitLimit = performance.CommitLimit * pageSize;
+        counters.memory.cached = performance.SystemCache * pageSize;
+    }
+    return true;
+}
+
+// SystemProcessorPerformanceInformation 按处理器返回 Idle/Kernel/User 及 DPC、中断时间；
+// KernelTime 包含空闲、DPC 与中断时间，这里拆开以免重复计入。Windows 不提供 iowait 与 steal。
+// 不带组号的查询只返回调用线程所在处理器组，超过 64 个逻辑处理器时须用 NtQuerySystemInformationEx 逐组查询；
+// 编号为组号 * 64 + 组内下标，与 GetCpuTopology 一致
+bool WinSystemInfoSource::QueryCpuCoreTimes(std::vector<CpuCoreTimes>& cores) {
+    if (!m_queryInformation) {
+        return false;
+    }
+
+    cores.clear();
+    // 系统不提供 NtQuerySystemInformationEx 时只有一个处理器组
+    WORD groupCount = m_queryInformationEx ? m_groupCount : 1;
+    for (WORD group = 0; group < groupCount; ++group) {
+        ULONG returned = 0;
+        ULONG bufferSize = static_cast<ULONG>(m_processorTimes.size() * sizeof(SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION));
+        NTSTATUS status;
+        if (m_queryInformationEx) {
+            USHORT groupNumber = group;
+            status = m_queryInformationEx(SystemProcessorPerformanceInformation, &groupNumber, sizeof(groupNumber),
+                m_processorTimes.data(), bufferSize, &returned);
+        }
+        else {
+            status = m_queryInformation(SystemProcessorPerformanceInformation, m_processorTimes.data(), bufferSize, &returned);
+        }
+        if (!NT_SUCCESS(status)) {
+            std::wcerr << L"NtQuerySystemInformation failed for processor group " << group
+                << L" with status: " << status << std::endl;
+            return false;
+        }
+
+        size_t count = returned / sizeof(SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION);
+        for (size_t i = 0; i < count; ++i) {
+            const SYSTEM_PROCESSOR_PERFORMANCE_INFORMATION& info = m_processorTimes[i];
+            ULONGLONG idle = static_cast<ULONGLONG>(info.IdleTime.QuadPart);
+            ULONGLONG kernel = static_cast<ULONGLONG>(info.KernelTime.QuadPart);
+            ULONGLONG dpc = static_cast<ULONGLONG>(info.Reserved1[0].QuadPart);        // DpcTime
+            ULONGLONG interrupt = static_cast<ULONGLONG>(info.Reserved1[1].QuadPart);  // InterruptTime
+
+            cores.emplace_back();
+            CpuCoreTimes& core = cores.back();
+            core.cpuId = static_cast<DWORD>(group) * 64 + static_cast<DWORD>(i);
+            core.user = static_cast<ULONGLONG>(info.UserTime.QuadPart);
+            core.idle = idle;
+            core.irq = dpc + interrupt;
+            core.system = kernel > idle + core.irq ? kernel - idle - core.irq : 0;
+        }
+    }
+    return !cores.empty();
+}
+
+// 依次遍历封装、核心与 NUMA 节点关系，把各自的处理器掩码展开到逻辑处理器上；
+// 编号为组号 * 64 + 组内位号，与 QueryCpuCoreTimes 逐组查询时的编号一致
+void WinSystemInfoSource::GetCpuTopology(std::vector<CpuTopologyEntry>& topology) {
+    topology.clear();
+    DWORD length = 0;
+    GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+    if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || length == 0) {
+        return;
+    }
+    std::vector<BYTE> buffer(length);
+    auto* first = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data());
+    if (!GetLogicalProcessorInformationEx(RelationAll, first, &length)) {
+        std::wcerr << L"GetLogicalProcessorInformationEx failed with error: " << GetLastError() << std::endl;
+        return;
+    }
+
+    std::vector<CpuTopologyEntry> byId;
+    auto forEachCpu = [&byId](const GROUP_AFFINITY& affinity, auto apply) {
+        for (DWORD bit = 0; bit < sizeof(KAFFINITY) * 8; ++bit) {
+            if (affinity.Mask & (static_cast<KAFFINITY>(1) << bit)) {
+                DWORD cpuId = static_cast<DWORD>(affinity.Group) * 64 + bit;
+                if (cpuId >= byId.size()) {
+                    byId.resize(cpuId + 1);
+                }
+                byId[cpuId].cpuId = cpuId;
+                apply(byId[cpuId]);
+            }
+        }
+    };
+
+    // 只有出现在核心关系中的逻辑处理器才真实存在，以此剔除掩码空洞
+    std::vector<char> present;
+    DWORD packageIndex = 0;
+    DWORD coreIndex = 0;
+    for (DWORD offset = 0; offset < length;) {
+        auto* info = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data() + offset);
+        switch (info->Relationship) {
+        case RelationProcessorPackage:
+            for (WORD group = 0; group < info->Processor.GroupCount; ++group) {
+                forEachCpu(info->Processor.GroupMask[group],
+                    [packageIndex](CpuTopologyEntry& cpu) { cpu.packageId = packageIndex; });
+            }
+            ++packageIndex;
+            break;
+        case RelationProcessorCore:
+            forEachCpu(info->Processor.GroupMask[0], [coreIndex, &present](CpuTopologyEntry& cpu) {
+                cpu.coreId = coreIndex;
+                if (cpu.cpuId >= present.size()) {
+                    present.resize(cpu.cpuId + 1, 0);
+                }
+                present[cpu.cpuId] = 1;
+            });
+            ++coreIndex;
+            break;
+        case RelationNumaNode:
+            forEachCpu(info->NumaNode.GroupMask,
+                [info](CpuTopologyEntry& cpu) { cpu.numaNode = info->NumaNode.NodeNumber; });
+            break;
+        default:
+            break;
+        }
+        offset += info->Size;
+    }
+
+    for (size_t i = 0; i < present.size(); ++i) {
+        if (present[i]) {
+            topology.push_back(byId[i]);
+        }
+    }
+}
+
+// 替代 GetVersionExW 的函数
+std::wstring WinSystemInfoSource::GetOsVersionString() {
+    // 使用 RtlGetVersion (NT 内部函数)
+    typedef NTSTATUS(WINAPI* RtlGetVersionPtr)(PRTL_OSVERSIONINFOW);
+
+    // 动态加载 ntdll.dll 中的 RtlGetVersion 函数
+    HMODULE hNtdll = GetModuleHandleW(L"ntdll.dll");
+    if (!hNtdll) {
+        return L"无法获取操作系统信息";
+    }
+
+    RtlGetVersionPtr pRtlGetVersion = reinterpret_cast<RtlGetVersionPtr>(
+        GetProcAddress(hNtdll, "RtlGetVersion")
+        );
+
+    if (!pRtlGetVersion) {
+        return L"无法获取操作系统信息";
+    }
+
+    RTL_OSVERSIONINFOW osInfo = { 0 };
+    osInfo.dwOSVersionInfoSize = sizeof(osInfo);
+
+    // 调用 RtlGetVersion 获取系统版本
+    NTSTATUS status = pRtlGetVersion(&osInfo);
+    if (!NT_SUCCESS(status)) {
+        return L"无法获取操作系统信息";
+    }
+
+    // 根据版本号构建友好的操作系统名称
+    std::wostringstream osVersion;
+
+    // 判断 Windows 版本
+    if (osInfo.dwMajorVersion == 10) {
+        // 检查是否是 Windows 11 (通过版本号或其他特征判断)
+        // 注意: Windows 11 仍使用 major version 10，但 build number >= 22000
+        if (osInfo.dwBuildNumber >= 22000) {
+            osVersion << L"Windows 11";
+        }
+        else {
+            osVersion << L"Windows 10";
+        }
+    }
+    else if (osInfo.dwMajorVersion == 6) {
+        switch (osInfo.dwMinorVersion) {
+        case 3: osVersion << L"Windows 8.1"; break;
+        case 2: osVersion << L"Windows 8"; break;
+        case 1: osVersion << L"Windows 7"; break;
+        case 0: osVersion << L"Windows Vista"; break;
+        default: osVersion << L"Windows NT 6.x"; break;
+        }
+    }
+    else if (osInfo.dwMajorVersion == 5) {
+        switch (osInfo.dwMinorVersion) {
+        case 2: osVersion << L"Windows Server 2003"; break;
+        case 1: osVersion << L"Windows XP"; break;
+        default: osVersion << L"Windows NT 5.x"; break;
+        }
+    }
+    else {
+        osVersion << L"Windows NT " << osInfo.dwMajorVersion << L"." << osInfo.dwMinorVersion;
+    }
+
+    // 添加版本号信息
+    osVersion << L" (Build " << osInfo.dwBuildNumber << L")";
+
+    return osVersion.str();
+}
+
+std::unique_ptr<ISystemInfoSource> CreateSystemInfoSource() {
+    return std::make_unique<WinSystemInfoSource>();
+}
+
+#endif // _WIN32
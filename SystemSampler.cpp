@@ -0,0 +1,178 @@
+﻿// SystemSampler.cpp
+#include "SystemSampler.h"
+#include <algorithm>
+#include <iostream>
+
+constexpr std::chrono::milliseconds SystemSampler::kMinInterval;
+
+double SampleIntervalSeconds(const SystemSample& previous, const SystemSample& current) {
+    return current.timestamp > previous.timestamp ? (current.timestamp - previous.timestamp) / 10000000.0 : 0.0;
+}
+
+// kernelTime 含 idle；计数回退（不应发生）时视为 0
+double CalculateCpuUsage(const SystemSample& previous, const SystemSample& current) {
+    if (previous.timestamp == 0 || current.timestamp <= previous.timestamp) {
+        return 0.0;
+    }
+
+    auto delta = [](const FILETIME& now, const FILETIME& before) {
+        ULONGLONG a = FileTimeToUInt64(now);
+        ULONGLONG b = FileTimeToUInt64(before);
+        return a > b ? a - b : 0;
+    };
+    ULONGLONG idle = delta(current.counters.idleTime, previous.counters.idleTime);
+    ULONGLONG total = delta(current.counters.kernelTime, previous.counters.kernelTime)
+        + delta(current.counters.userTime, previous.counters.userTime);
+    if (total == 0 || idle > total) {
+        return 0.0;
+    }
+    return 100.0 * (total - idle) / total;
+}
+
+MemoryRates CalculateMemoryRates(const SystemSample& previous, const SystemSample& current) {
+    MemoryRates rates;
+    double seconds = previous.timestamp != 0 ? SampleIntervalSeconds(previous, current) : 0.0;
+    if (seconds <= 0.0) {
+        return rates;
+    }
+
+    auto perSecond = [seconds](ULONGLONG now, ULONGLONG before) {
+        return now > before ? (now - before) / seconds : 0.0;
+    };
+    const MemoryCounters& a = previous.counters.memory;
+    const MemoryCounters& b = current.counters.memory;
+    rates.swapInPerSecond = perSecond(b.swapInPages, a.swapInPages);
+    rates.swapOutPerSecond = perSecond(b.swapOutPages, a.swapOutPages);
+    rates.majorFaultsPerSecond = perSecond(b.majorFaults, a.majorFaults);
+    if (a.hasPressure && b.hasPressure) {
+        // PSI 累计值单位为微秒
+        rates.pressureSome = (std::min)(100.0, perSecond(b.pressure.someTotal, a.pressure.someTotal) / 10000.0);
+        rates.pressureFull = (std::min)(100.0, perSecond(b.pressure.fullTotal, a.pressure.fullTotal) / 10000.0);
+    }
+    return rates;
+}
+
+static float Percent(ULONGLONG current, ULONGLONG previous, ULONGLONG total) {
+    return current >= previous ? static_cast<float>((current - previous) * 100.0 / total) : 0.0f;
+}
+
+void CalculateCpuCoreUsage(const CpuCoreSample& previous, const CpuCoreSample& current, std::vector<CpuCoreUsage>& usage) {
+    bool valid = previous.timestamp != 0 && current.timestamp > previous.timestamp;
+    usage.resize(current.items.size());
+    for (size_t i = 0; i < current.items.size(); ++i) {
+        const CpuCoreTimes& now = current.items[i];
+        CpuCoreUsage& core = usage[i];
+        core = CpuCoreUsage();
+        core.cpuId = now.cpuId;
+
+        // 处理器上下线后下标可能错位，编号不一致时本次不计算
+        if (!valid || i >= previous.items.size() || previous.items[i].cpuId != now.cpuId) {
+            continue;
+        }
+        const CpuCoreTimes& before = previous.items[i];
+        ULONGLONG total = now.Total() > before.Total() ? now.Total() - before.Total() : 0;
+        if (total == 0) {
+            continue;
+        }
+
+        core.user = Percent(now.user, before.user, total);
+        core.system = Percent(now.system, before.system, total);
+        core.iowait = Percent(now.iowait, before.iowait, total);
+        core.irq = Percent(now.irq, before.irq, total);
+        core.steal = Percent(now.steal, before.steal, total);
+        core.total = (std::min)(100.0f, core.user + core.system + core.irq + core.steal);
+    }
+}
+
+SystemSampler::SystemSampler(size_t capacity, size_t coreCapacity)
+    : m_ring(capacity), m_coreRing(coreCapacity), m_intervalMs(1000), m_running(false) {}
+
+SystemSampler::~SystemSampler() {
+    Stop();
+}
+
+bool SystemSampler::Start(std::chrono::milliseconds interval) {
+    if (m_running) {
+        SetInterval(interval);
+        return true;
+    }
+
+    m_collector = std::make_unique<SystemInfoCollector>();
+    if (!m_collector->Initialize()) {
+        std::cerr << "Failed to initialize system sampler!" << std::endl;
+        m_collector.reset();
+        return false;
+    }
+
+    // 按首次查询到的处理器数分配逐核样本，采样线程启动后不再因此分配
+    if (m_collector->CollectCpuCoreTimes(m_coreTimes)) {
+        m_coreRing.Reserve(m_coreTimes.size());
+    }
+
+    SetInterval(interval);
+    m_running = true;
+    m_thread = std::thread(&SystemSampler::ThreadFunction, this);
+    return true;
+}
+
+void SystemSampler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+    }
+    m_condition.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_collector->Cleanup();
+    m_collector.reset();
+}
+
+void SystemSampler::SetInterval(std::chrono::milliseconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_intervalMs = std::max(interval, kMinInterval).count();
+    }
+    m_condition.notify_all();
+}
+
+SystemSampler::Cursor SystemSampler::CreateCursor(bool fromOldest) const {
+    return fromOldest ? m_ring.CreateCursorAtOldest() : m_ring.CreateCursor();
+}
+
+// 按绝对时刻排定下一次采样，采样耗时不会累积成漂移；落后超过一个间隔（如系统休眠后）时从当前时刻重新排定
+void SystemSampler::ThreadFunction() {
+    auto next = std::chrono::steady_clock::now();
+    SystemSample sample;
+    while (m_running) {
+        if (m_collector->CollectCounters(sample.counters)) {
+            auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+            sample.timestamp = static_cast<ULONGLONG>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count() / 100);
+            m_ring.Push(sample);
+
+            // 逐核数据是附加信息，平台不支持时不写入
+            if (m_collector->CollectCpuCoreTimes(m_coreTimes)) {
+                m_coreRing.Push(sample.timestamp, m_coreTimes.data(), m_coreTimes.size());
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        long long intervalMs = m_intervalMs.load();
+        next += std::chrono::milliseconds(intervalMs);
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) {
+            next = now;
+        }
+        // 间隔变化或停止时提前醒来，按新间隔重新排定
+        m_condition.wait_until(lock, next, [this, intervalMs] {
+            return !m_running || m_intervalMs.load() != intervalMs;
+        });
+        if (m_intervalMs.load() != intervalMs) {
+            next = std::chrono::steady_clock::now();
+        }
+    }
+}
@@ -0,0 +1,92 @@
+﻿// SystemSampler.h
+#pragma once
+#include "SystemInfoCollector.h"
+#include "SampleRing.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 一次系统计数器采样；timestamp 取自单调时钟（100 纳秒），速率按相邻样本的 timestamp 差计算
+struct SystemSample {
+    ULONGLONG timestamp = 0;
+    SystemCounters counters;
+};
+
+// 两个样本之间的 CPU 使用率（%），样本无效或时间未前进时返回 0
+double CalculateCpuUsage(const SystemSample& previous, const SystemSample& current);
+// 两个样本之间的秒数
+double SampleIntervalSeconds(const SystemSample& previous, const SystemSample& current);
+
+// 两个样本之间的内存活动速率
+struct MemoryRates {
+    double swapInPerSecond = 0.0;       // 页/秒
+    double swapOutPerSecond = 0.0;
+    double majorFaultsPerSecond = 0.0;
+    double pressureSome = 0.0;          // 间隔内的内存停顿时间占比（%），由 PSI 累计值计算，比 avg10 更及时
+    double pressureFull = 0.0;
+};
+MemoryRates CalculateMemoryRates(const SystemSample& previous, const SystemSample& current);
+
+// 一次逐核计数器采样（items 按 cpuId 升序，包含全部逻辑处理器），与同一时刻的 SystemSample 共用 timestamp
+using CpuCoreSample = SampleArrayRing<CpuCoreTimes>::Sample;
+
+// 两个逐核样本之间各逻辑处理器的使用率（按 cpuId 升序，覆盖 usage 原有内容并复用其容量）；
+// previous 无效或处理器上下线导致编号不一致时，相应项为 0
+void CalculateCpuCoreUsage(const CpuCoreSample& previous, const CpuCoreSample& current, std::vector<CpuCoreUsage>& usage);
+
+// 专用采样线程：按固定节拍采样系统计数器写入无锁环形缓冲区，与界面是否可见、由谁读取无关。
+// 逐核累计时间单独写入一个较小的环形缓冲区（单个样本较大，只保留最近若干个），
+// 每个样本的宽度在 Start 时按实际处理器数确定，处理器增加时随之扩大。
+// 采样线程使用自己的数据源，不占用 DataManager 的数据锁；
+// 读者通过各自的游标读取新样本，或随时取最近若干个样本作为历史
+class SystemSampler {
+public:
+    using Cursor = SampleRing<SystemSample>::Cursor;
+
+    static constexpr std::chrono::milliseconds kMinInterval{ 100 };
+
+    // capacity 与 coreCapacity 为保留的系统样本数与逐核样本数（向上取整为 2 的幂）
+    explicit SystemSampler(size_t capacity = 4096, size_t coreCapacity = 64);
+    ~SystemSampler();
+
+    SystemSampler(const SystemSampler&) = delete;
+    SystemSampler& operator=(const SystemSampler&) = delete;
+
+    // 初始化数据源并启动采样线程，间隔不小于 kMinInterval
+    bool Start(std::chrono::milliseconds interval);
+    void Stop();
+    bool IsRunning() const { return m_running; }
+
+    // 运行中修改间隔，从下一次采样起生效
+    void SetInterval(std::chrono::milliseconds interval);
+    std::chrono::milliseconds GetInterval() const { return std::chrono::milliseconds(m_intervalMs.load()); }
+
+    // 读者游标：只读此后的新样本，或从保留的最旧样本开始
+    Cursor CreateCursor(bool fromOldest = false) const;
+    bool Read(Cursor& cursor, SystemSample& sample) const { return m_ring.Read(cursor, sample); }
+    bool GetLatest(SystemSample& sample) const { return m_ring.ReadLatest(sample); }
+    // 最近至多 count 个样本，按时间顺序
+    size_t GetHistory(size_t count, std::vector<SystemSample>& samples) const { return m_ring.ReadRecent(count, samples); }
+    size_t GetCapacity() const { return m_ring.GetCapacity(); }
+    // 最近至多 count 个逐核样本，按时间顺序；平台不支持逐核数据时为空
+    size_t GetCoreHistory(size_t count, std::vector<CpuCoreSample>& samples) const { return m_coreRing.ReadRecent(count, samples); }
+    // 逐核样本当前能保存的处理器数（尚未采样或平台不支持时为 0）
+    size_t GetCoreStride() const { return m_coreRing.GetStride(); }
+
+private:
+    void ThreadFunction();
+
+    SampleRing<SystemSample> m_ring;
+    SampleArrayRing<CpuCoreTimes> m_coreRing;
+    std::unique_ptr<SystemInfoCollector> m_collector;
+    std::vector<CpuCoreTimes> m_coreTimes;   // 仅采样线程使用，容量在多次采样间复用
+    std::atomic<long long> m_intervalMs;
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+    std::mutex m_mutex;                    // 只用于 Stop 与间隔变化时唤醒采样线程
+    std::condition_variable m_condition;
+};
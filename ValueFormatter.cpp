@@ -0,0 +1,222 @@
+﻿// ValueFormatter.cpp
+#include "ValueFormatter.h"
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    // 单个格式化缓存的默认条目上限
+    constexpr size_t kDefaultCacheEntries = 4096;
+
+    // 定长 CLOCK 缓存：命中只设置访问位；满后指针从上次位置扫描，
+    // 清除途经条目的访问位，替换第一个自上一圈以来未被访问的条目。
+    // 每轮刷新都会再次显示的值（存活的连接、进程）始终带访问位，不会被一次性出现的值挤出
+    template <typename Key, typename Hash = std::hash<Key>>
+    class FormatCache {
+    public:
+        template <typename Formatter>
+        InternedString Get(Key key, Formatter format) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_index.find(key);
+            if (it != m_index.end()) {
+                Slot& slot = m_slots[it->second];
+                slot.referenced = true;
+                return slot.value;
+            }
+
+            InternedString value = format();
+            if (m_slots.size() < m_capacity) {
+                m_index.emplace(key, m_slots.size());
+                m_slots.push_back({ key, value, false });
+                return value;
+            }
+
+            while (m_slots[m_hand].referenced) {
+                m_slots[m_hand].referenced = false;
+                m_hand = (m_hand + 1) % m_slots.size();
+            }
+            Slot& victim = m_slots[m_hand];
+            m_index.erase(victim.key);
+            m_index.emplace(key, m_hand);
+            victim = { key, value, false };
+            m_hand = (m_hand + 1) % m_slots.size();
+            return value;
+        }
+
+        // 调整条目上限；缩小时优先保留带访问位的条目
+        void SetCapacity(size_t capacity) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_capacity = (std::max)(capacity, static_cast<size_t>(1));
+            if (m_slots.size() <= m_capacity) {
+                return;
+            }
+
+            std::stable_partition(m_slots.begin(), m_slots.end(), [](const Slot& slot) { return slot.referenced; });
+            m_slots.resize(m_capacity);
+            m_slots.shrink_to_fit();
+            m_index.clear();
+            for (size_t i = 0; i < m_slots.size(); ++i) {
+                m_index.emplace(m_slots[i].key, i);
+            }
+            m_hand = 0;
+        }
+
+    private:
+        struct Slot {
+            Key key;
+            InternedString value;
+            bool referenced;
+        };
+
+        std::mutex m_mutex;
+        std::vector<Slot> m_slots;
+        std::unordered_map<Key, size_t, Hash> m_index;   // 键 -> m_slots 下标
+        size_t m_hand = 0;                                // CLOCK 指针
+        size_t m_capacity = kDefaultCacheEntries;
+    };
+
+    struct EndpointKey {
+        BYTE address[16];
+        WORD port;
+        bool ipv6;
+
+        bool operator==(const EndpointKey& other) const {
+            return port == other.port && ipv6 == other.ipv6 && memcmp(address, other.address, sizeof(address)) == 0;
+        }
+    };
+
+    struct EndpointKeyHash {
+        size_t operator()(const EndpointKey& key) const {
+            ULONGLONG high, low;
+            memcpy(&high, key.address, sizeof(high));
+            memcpy(&low, key.address + 8, sizeof(low));
+            return std::hash<ULONGLONG>()(high ^ (low * 0x9E3779B97F4A7C15ULL) ^ (static_cast<ULONGLONG>(key.port) << 1) ^ key.ipv6);
+        }
+    };
+
+    // IPv6 文本形式：最长的连续零段（至少两段）压缩为 "::"，IPv4 映射地址以点分十进制结尾
+    void FormatIpv6Address(const BYTE* address, std::wstring& text) {
+        static const BYTE mappedPrefix[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF };
+        wchar_t buffer[32];
+        const size_t capacity = sizeof(buffer) / sizeof(buffer[0]);
+        if (memcmp(address, mappedPrefix, sizeof(mappedPrefix)) == 0) {
+            swprintf(buffer, capacity, L"::ffff:%u.%u.%u.%u", address[12], address[13], address[14], address[15]);
+            text += buffer;
+            return;
+        }
+
+        unsigned groups[8];
+        for (int i = 0; i < 8; ++i) {
+            groups[i] = (static_cast<unsigned>(address[i * 2]) << 8) | address[i * 2 + 1];
+        }
+
+        int bestStart = -1, bestLength = 0;
+        for (int i = 0; i < 8;) {
+            if (groups[i] != 0) {
+                ++i;
+                continue;
+            }
+            int start = i;
+            while (i < 8 && groups[i] == 0) ++i;
+            if (i - start > bestLength) {
+                bestStart = start;
+                bestLength = i - start;
+            }
+        }
+        if (bestLength < 2) {
+            bestStart = -1;
+        }
+
+        for (int i = 0; i < 8; ++i) {
+            if (i == bestStart) {
+                text += L"::";
+                i += bestLength - 1;
+                continue;
+            }
+            if (i > 0 && i != bestStart + bestLength) {
+                text += L':';
+            }
+            swprintf(buffer, capacity, L"%x", groups[i]);
+            text += buffer;
+        }
+    }
+}
+
+InternedString FormatFileTimeCached(const FILETIME& ft) {
+    ULONGLONG value = FileTimeToUInt64(ft);
+    if (value == 0) {
+        return InternedString();
+    }
+
+    // 显示精度为秒，同一秒内的时刻共用一个缓存项
+    static FormatCache<ULONGLONG> cache;
+    ULONGLONG seconds = value / 10000000ULL;
+    return cache.Get(seconds, [seconds]() {
+        return InternedString(FormatFileTime(UInt64ToFileTime(seconds * 10000000ULL)));
+    });
+}
+
+static FormatCache<EndpointKey, EndpointKeyHash>& EndpointCache() {
+    static FormatCache<EndpointKey, EndpointKeyHash> cache;
+    return cache;
+}
+
+void SetEndpointFormatCacheCapacity(size_t liveEndpoints) {
+    EndpointCache().SetCapacity((std::max)(liveEndpoints, kDefaultCacheEntries));
+}
+
+InternedString FormatEndpointCached(bool ipv6, const BYTE* address, WORD port) {
+    EndpointKey key = {};
+    memcpy(key.address, address, ipv6 ? 16 : 4);
+    key.port = port;
+    key.ipv6 = ipv6;
+
+    return EndpointCache().Get(key, [&key]() {
+        wchar_t buffer[64];
+        const size_t capacity = sizeof(buffer) / sizeof(buffer[0]);
+        if (!key.ipv6) {
+            swprintf(buffer, capacity, L"%u.%u.%u.%u:%u",
+                key.address[0], key.address[1], key.address[2], key.address[3], static_cast<unsigned>(key.port));
+            return InternedString(buffer);
+        }
+
+        std::wstring text = L"[";
+        FormatIpv6Address(key.address, text);
+        swprintf(buffer, capacity, L"]:%u", static_cast<unsigned>(key.port));
+        text += buffer;
+        return InternedString(text);
+    });
+}
+
+InternedString FormatPrefixCached(bool ipv6, const BYTE* address, int prefixLength) {
+    // 复用端点键，端口位置保存前缀长度
+    EndpointKey key = {};
+    int addressBits = ipv6 ? 128 : 32;
+    prefixLength = prefixLength < 0 ? 0 : (prefixLength > addressBits ? addressBits : prefixLength);
+    memcpy(key.address, address, prefixLength / 8);
+    if (prefixLength % 8) {
+        key.address[prefixLength / 8] = address[prefixLength / 8] & static_cast<BYTE>(0xFF << (8 - prefixLength % 8));
+    }
+    key.port = static_cast<WORD>(prefixLength);
+    key.ipv6 = ipv6;
+
+    static FormatCache<EndpointKey, EndpointKeyHash> cache;
+    return cache.Get(key, [&key]() {
+        wchar_t buffer[64];
+        const size_t capacity = sizeof(buffer) / sizeof(buffer[0]);
+        if (!key.ipv6) {
+            swprintf(buffer, capacity, L"%u.%u.%u.%u/%u",
+                key.address[0], key.address[1], key.address[2], key.address[3], static_cast<unsigned>(key.port));
+            return InternedString(buffer);
+        }
+
+        std::wstring text;
+        FormatIpv6Address(key.address, text);
+        swprintf(buffer, capacity, L"/%u", static_cast<unsigned>(key.port));
+        text += buffer;
+        return InternedString(text);
+    });
+}
@@ -0,0 +1,22 @@
+﻿// ValueFormatter.h
+#pragma once
+#include "PlatformCompat.h"
+#include "StringPool.h"
+
+// 按值缓存的格式化函数：采集时只保存原始数值，界面或输出需要显示时才调用。
+// 相同的值只格式化一次，结果以驻留字符串返回，重复显示不再分配内存。
+// 缓存有上限，满后按 CLOCK 策略替换近期未再显示的值（已返回的字符串不受影响）。
+
+// "YYYY-MM-DD hh:mm:ss"（UTC），按秒缓存；值为 0 时返回空字符串
+InternedString FormatFileTimeCached(const FILETIME& ft);
+
+// IPv4 为 "a.b.c.d:port"，IPv6 为 "[addr]:port"（按 RFC 5952 压缩零段）；
+// address 为 16 字节网络字节序地址（IPv4 只使用前 4 字节），port 为主机字节序
+InternedString FormatEndpointCached(bool ipv6, const BYTE* address, WORD port);
+
+// 按当前存活的端点数（连接数的两倍）调整端点缓存上限，不低于默认的 4096 项；
+// 界面每次刷新都会格式化全部连接，上限小于存活端点数时缓存无法命中
+void SetEndpointFormatCacheCapacity(size_t liveEndpoints);
+
+// 网段 "a.b.c.0/24" 或 "2001:db8::/64"：address 中前 prefixLength 位之后的部分按 0 处理
+InternedString FormatPrefixCached(bool ipv6, const BYTE* address, int prefixLength);
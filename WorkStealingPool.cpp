@@ -0,0 +1,129 @@
+﻿// WorkStealingPool.cpp
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(size_t workerCount) {
+    workerCount = (std::max)(workerCount, static_cast<size_t>(1));
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i + 1 < workerCount; ++i) {
+        m_threads.emplace_back(&WorkStealingPool::WorkerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeCondition.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+size_t WorkStealingPool::DefaultWorkerCount() {
+    size_t cores = std::thread::hardware_concurrency();
+    return (std::max)(cores / 8, static_cast<size_t>(1));
+}
+
+void WorkStealingPool::ParallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    // 单线程时直接顺序执行，省去任务分发的开销
+    if (m_threads.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(m_submitMutex);
+
+    // 切成约 4 倍线程数的块并轮流放入各队列，耗时长的块由空闲线程窃取分担
+    const size_t workers = m_queues.size();
+    const size_t chunkSize = (std::max)(count / (workers * 4), static_cast<size_t>(1));
+    m_remaining.store(count);
+
+    size_t queueIndex = 0;
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        Task task{ begin, (std::min)(begin + chunkSize, count), &fn };
+        WorkerQueue& queue = *m_queues[queueIndex];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(task);
+        }
+        queueIndex = (queueIndex + 1) % workers;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_batch;
+    }
+    m_wakeCondition.notify_all();
+
+    RunTasks(workers - 1);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_remaining.load() == 0; });
+}
+
+void WorkStealingPool::WorkerLoop(size_t index) {
+    size_t seenBatch = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCondition.wait(lock, [this, seenBatch] { return m_stop || m_batch != seenBatch; });
+            if (m_stop) {
+                return;
+            }
+            seenBatch = m_batch;
+        }
+        RunTasks(index);
+    }
+}
+
+// 先处理自己队列中的任务，队列为空后从其他队列窃取，直到所有队列都为空
+void WorkStealingPool::RunTasks(size_t index) {
+    Task task;
+    while (PopLocal(index, task) || Steal(index, task)) {
+        for (size_t i = task.begin; i < task.end; ++i) {
+            (*task.fn)(i);
+        }
+
+        size_t finished = task.end - task.begin;
+        if (m_remaining.fetch_sub(finished) == finished) {
+            // 加锁后再通知，避免调用线程在检查条件与进入等待之间错过通知
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_doneCondition.notify_all();
+        }
+    }
+}
+
+bool WorkStealingPool::PopLocal(size_t index, Task& task) {
+    WorkerQueue& queue = *m_queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::Steal(size_t thief, Task& task) {
+    const size_t workers = m_queues.size();
+    for (size_t offset = 1; offset < workers; ++offset) {
+        WorkerQueue& queue = *m_queues[(thief + offset) % workers];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,61 @@
+﻿// WorkStealingPool.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 有界工作窃取线程池：每个线程拥有自己的任务队列，从队尾取任务，
+// 空闲时从其他线程队首窃取，用于把耗时不均的逐项查询分摊到固定数量的线程上。
+class WorkStealingPool {
+public:
+    // workerCount 为参与执行的线程总数（含调用 ParallelFor 的线程），为 1 时不创建线程
+    explicit WorkStealingPool(size_t workerCount);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t GetWorkerCount() const { return m_queues.size(); }
+
+    // 对 [0, count) 中的每个下标调用 fn，全部完成后返回；调用线程同样参与执行。
+    // fn 对不同下标并发执行，调用方需保证各下标之间互不干扰
+    void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+    // 默认线程数：核心数的 1/8，至少 1 个，避免监控程序与业务负载争抢 CPU
+    static size_t DefaultWorkerCount();
+
+private:
+    struct Task {
+        size_t begin = 0;
+        size_t end = 0;
+        const std::function<void(size_t)>* fn = nullptr;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerLoop(size_t index);
+    void RunTasks(size_t index);
+    bool PopLocal(size_t index, Task& task);
+    bool Steal(size_t thief, Task& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;  // 最后一个队列属于调用线程
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_doneCondition;
+    std::atomic<size_t> m_remaining{ 0 };  // 当前批次尚未完成的下标数
+    size_t m_batch = 0;                    // 批次编号，递增时唤醒工作线程
+    bool m_stop = false;
+
+    std::mutex m_submitMutex;              // 同一时刻只允许一个批次
+};
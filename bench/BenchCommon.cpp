@@ -0,0 +1,87 @@
+﻿// BenchCommon.cpp
+#include "BenchCommon.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static std::atomic<uint64_t> g_allocations{ 0 };
+
+// 替换全局分配函数以统计分配次数；nothrow 与数组版本在 libstdc++ 中均转发到此处
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+uint64_t BenchAllocationCount() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+double BenchProcessCpuMs() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+        (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+void BenchReport(const char* name, double value, const char* unit) {
+    std::printf("%-48s %14.3f %s\n", name, value, unit);
+    std::fflush(stdout);
+}
+
+size_t BenchArg(int argc, char** argv, int index, size_t defaultValue) {
+    if (index >= argc) {
+        return defaultValue;
+    }
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(argv[index], &end, 10);
+    return (end != argv[index] && *end == '\0') ? static_cast<size_t>(value) : defaultValue;
+}
+
+size_t BenchChildren::Spawn(size_t count, void (*setup)(size_t index, void* context), void* context) {
+    std::fflush(stdout);
+    size_t spawned = 0;
+    for (size_t i = 0; i < count; ++i) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::perror("fork");
+            break;
+        }
+        if (pid == 0) {
+            if (setup) {
+                setup(i, context);
+            }
+            for (;;) {
+                pause();
+            }
+        }
+        m_pids.push_back(pid);
+        ++spawned;
+    }
+    return spawned;
+}
+
+void BenchChildren::KillAll() {
+    for (pid_t pid : m_pids) {
+        kill(pid, SIGKILL);
+    }
+    for (pid_t pid : m_pids) {
+        waitpid(pid, nullptr, 0);
+    }
+    m_pids.clear();
+}
@@ -0,0 +1,52 @@
+﻿// BenchCommon.h
+// 基准程序公用的计时、分配计数、子进程与结果输出
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <sys/types.h>
+
+// 进程内全局 operator new 的累计调用次数（BenchCommon.cpp 替换了全局分配函数）
+uint64_t BenchAllocationCount();
+
+class BenchTimer {
+public:
+    BenchTimer() : m_start(std::chrono::steady_clock::now()) {}
+
+    void Restart() { m_start = std::chrono::steady_clock::now(); }
+    double ElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    }
+    double ElapsedUs() const { return ElapsedMs() * 1000.0; }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// 进程 CPU 时间（用户 + 内核，毫秒），含全部线程
+double BenchProcessCpuMs();
+
+// 按“名称 数值 单位”的固定格式输出一行结果，便于对比多次运行
+void BenchReport(const char* name, double value, const char* unit);
+
+// 第 index 个命令行参数（从 1 开始），缺省或无法解析时返回 defaultValue
+size_t BenchArg(int argc, char** argv, int index, size_t defaultValue);
+
+// 创建一批只等待信号的子进程，用于放大进程数与打开的文件数；析构时全部杀死并回收
+class BenchChildren {
+public:
+    BenchChildren() = default;
+    ~BenchChildren() { KillAll(); }
+
+    BenchChildren(const BenchChildren&) = delete;
+    BenchChildren& operator=(const BenchChildren&) = delete;
+
+    // 子进程在 fork 后调用 setup（可为空）再挂起；返回实际创建的数量
+    size_t Spawn(size_t count, void (*setup)(size_t index, void* context) = nullptr, void* context = nullptr);
+    void KillAll();
+    const std::vector<pid_t>& Pids() const { return m_pids; }
+
+private:
+    std::vector<pid_t> m_pids;
+};
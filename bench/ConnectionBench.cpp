@@ -0,0 +1,332 @@
+﻿// ConnectionBench.cpp
+// 连接记录（user-011）：定长 POD ConnectionInfo 与旧的字符串记录在大量连接下的构建、复制与显示开销，
+// 以及本机真实连接表的采集耗时与分配次数。
+// 连接跟踪（user-012）：每轮大量连接建立又关闭时活动表与关闭连接表的大小和分配次数。
+// Linux 后端（user-013）：核对本程序建立的回环连接的端口、所属进程与状态，以及状态过滤。
+// 用法：ConnectionBench [合成连接数=200000] [本机回环 TCP 连接对数=1000] [刷新轮数=20] [每轮建立/关闭的连接数=50000]
+#include "BenchCommon.h"
+#include "ConnectionTracker.h"
+#include "NetworkCollector.h"
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static void Check(const char* name, bool passed) {
+    std::printf("check: %-48s %s\n", name, passed ? "PASS" : "FAIL");
+}
+
+// 改造前的记录：协议、两个端点与状态均为堆字符串，采集时即格式化
+struct LegacyConnectionInfo {
+    std::wstring protocol;
+    std::wstring localAddress;
+    std::wstring remoteAddress;
+    std::wstring state;
+    DWORD pid = 0;
+};
+
+static std::wstring LegacyEndpoint(const ConnectionInfo& info, bool local) {
+    char text[INET6_ADDRSTRLEN];
+    inet_ntop(info.IsIpv6() ? AF_INET6 : AF_INET, local ? info.localAddress : info.remoteAddress, text, sizeof(text));
+    wchar_t buffer[64];
+    swprintf(buffer, sizeof(buffer) / sizeof(buffer[0]), L"%s:%u", text,
+        static_cast<unsigned>(local ? info.localPort : info.remotePort));
+    return buffer;
+}
+
+static std::vector<ConnectionInfo> MakeConnections(size_t count) {
+    std::mt19937 random(42);
+    std::vector<ConnectionInfo> connections(count);
+    for (size_t i = 0; i < count; ++i) {
+        ConnectionInfo& info = connections[i];
+        std::memset(&info, 0, sizeof(info));
+        bool ipv6 = i % 4 == 0;
+        info.family = ipv6 ? ADDRESS_FAMILY_IPV6 : ADDRESS_FAMILY_IPV4;
+        info.protocol = i % 10 == 0 ? IPPROTO_UDP : IPPROTO_TCP;
+        info.state = info.protocol == IPPROTO_UDP ? CONNECTION_STATE_LISTEN : CONNECTION_STATE_ESTABLISHED;
+        // 本地端点集中在少数服务端口，远程端点各不相同
+        info.localAddress[0] = 10;
+        info.localAddress[3] = static_cast<BYTE>(i % 4);
+        info.localPort = static_cast<WORD>(i % 8 == 0 ? 32768 + i % 20000 : 443);
+        for (size_t b = 0; b < (ipv6 ? 16u : 4u); ++b) {
+            info.remoteAddress[b] = static_cast<BYTE>(random());
+        }
+        info.remotePort = static_cast<WORD>(1024 + random() % 60000);
+        info.pid = static_cast<DWORD>(1000 + i % 500);
+    }
+    return connections;
+}
+
+static void BenchSynthetic(size_t count) {
+    std::vector<ConnectionInfo> connections = MakeConnections(count);
+    BenchReport("pod: record size", static_cast<double>(sizeof(ConnectionInfo)), "bytes");
+
+    // 旧做法：采集时为每条记录生成字符串
+    uint64_t allocations = BenchAllocationCount();
+    BenchTimer timer;
+    std::vector<LegacyConnectionInfo> legacy;
+    legacy.reserve(count);
+    for (const auto& info : connections) {
+        LegacyConnectionInfo record;
+        record.protocol = info.protocol == IPPROTO_TCP ? L"TCP" : L"UDP";
+        record.localAddress = LegacyEndpoint(info, true);
+        record.remoteAddress = LegacyEndpoint(info, false);
+        record.state = info.GetStateString();
+        record.pid = info.pid;
+        legacy.push_back(std::move(record));
+    }
+    BenchReport("legacy: build records", timer.ElapsedMs(), "ms");
+    BenchReport("legacy: build allocations", static_cast<double>(BenchAllocationCount() - allocations) / count, "allocs/row");
+
+    allocations = BenchAllocationCount();
+    timer.Restart();
+    std::vector<LegacyConnectionInfo> legacyCopy = legacy;
+    BenchReport("legacy: snapshot copy", timer.ElapsedMs(), "ms");
+    BenchReport("legacy: snapshot copy allocations", static_cast<double>(BenchAllocationCount() - allocations), "allocs");
+
+    allocations = BenchAllocationCount();
+    timer.Restart();
+    std::vector<ConnectionInfo> copy = connections;
+    BenchReport("pod: snapshot copy", timer.ElapsedMs(), "ms");
+    BenchReport("pod: snapshot copy allocations", static_cast<double>(BenchAllocationCount() - allocations), "allocs");
+
+    // 新做法：显示时经缓存格式化，第二遍起命中缓存（上限按存活端点数设置，同 DataManager）
+    SetEndpointFormatCacheCapacity(count * 2 + count / 4);
+    for (int pass = 0; pass < 2; ++pass) {
+        allocations = BenchAllocationCount();
+        timer.Restart();
+        size_t characters = 0;
+        for (const auto& info : copy) {
+            characters += info.GetLocalAddressString().size() + info.GetRemoteAddressString().size();
+            characters += std::wcslen(info.GetStateString());
+        }
+        std::string name = pass == 0 ? "pod: format all rows (cold)" : "pod: format all rows (cached)";
+        BenchReport(name.c_str(), timer.ElapsedMs(), "ms");
+        BenchReport((name + " allocations").c_str(),
+            static_cast<double>(BenchAllocationCount() - allocations) / count, "allocs/row");
+        if (characters == 0) {
+            std::printf("unexpected empty text\n");
+        }
+    }
+}
+
+// 第 serial 个合成连接：远程地址与端口由序号决定，各不相同
+static ConnectionInfo MakeChurnConnection(ULONGLONG serial) {
+    ConnectionInfo info;
+    std::memset(&info, 0, sizeof(info));
+    info.family = ADDRESS_FAMILY_IPV4;
+    info.protocol = IPPROTO_TCP;
+    info.state = CONNECTION_STATE_ESTABLISHED;
+    info.localAddress[0] = 10;
+    info.localAddress[3] = 1;
+    info.localPort = 443;
+    info.remoteAddress[0] = 172;
+    info.remoteAddress[1] = static_cast<BYTE>(serial >> 24);
+    info.remoteAddress[2] = static_cast<BYTE>(serial >> 16);
+    info.remoteAddress[3] = static_cast<BYTE>(serial >> 8);
+    info.remotePort = static_cast<WORD>(1024 + (serial & 0xff));
+    info.pid = static_cast<DWORD>(1000 + serial % 500);
+    return info;
+}
+
+// 固定的 base 个长连接之外，每轮新建 churn 个连接并关闭上一轮的 churn 个；
+// 最后一轮只保留长连接，观察高峰过后活动表能否收缩
+static void BenchChurn(size_t churn, size_t rounds) {
+    const size_t base = 1000;
+    ConnectionTracker tracker;
+    std::vector<ConnectionInfo> snapshot;
+    std::vector<ConnectionEvent> events;
+    ULONGLONG serial = 0;
+    ULONGLONG now = ConnectionTracker::Now();
+
+    for (size_t i = 0; i < base; ++i) {
+        snapshot.push_back(MakeChurnConnection(serial++));
+    }
+    snapshot.resize(base + churn);
+
+    size_t warmupBuckets = 0;
+    size_t maxBuckets = 0;
+    uint64_t allocations = 0;
+    double elapsedMs = 0.0;
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t i = base; i < base + churn; ++i) {
+            snapshot[i] = MakeChurnConnection(serial++);
+        }
+        events.clear();
+        now += 10000000;   // 每轮 1 秒
+
+        uint64_t before = BenchAllocationCount();
+        BenchTimer timer;
+        tracker.Update(snapshot, events, now);
+        // 第一轮建立活动表，不计入稳态
+        if (round == 0) {
+            warmupBuckets = tracker.GetActiveBucketCount();
+            continue;
+        }
+        elapsedMs += timer.ElapsedMs();
+        allocations += BenchAllocationCount() - before;
+        maxBuckets = (std::max)(maxBuckets, tracker.GetActiveBucketCount());
+    }
+    size_t steadyRounds = rounds > 1 ? rounds - 1 : 1;
+
+    BenchReport("churn: opened + closed per round", static_cast<double>(churn), "conns");
+    BenchReport("churn: update", elapsedMs / steadyRounds, "ms/round");
+    BenchReport("churn: allocations", static_cast<double>(allocations) / steadyRounds, "allocs/round");
+    BenchReport("churn: active connections", static_cast<double>(tracker.GetActiveCount()), "");
+    BenchReport("churn: active buckets after first round", static_cast<double>(warmupBuckets), "");
+    BenchReport("churn: active buckets max", static_cast<double>(maxBuckets), "");
+    BenchReport("churn: closed ring size", static_cast<double>(tracker.GetClosedCount()), "");
+    Check("active buckets do not grow under churn", maxBuckets <= warmupBuckets);
+    Check("closed ring stays at its capacity", tracker.GetClosedCount() <= tracker.GetMaxClosed());
+
+    snapshot.resize(base);
+    events.clear();
+    tracker.Update(snapshot, events, now + 10000000);
+    BenchReport("quiet: active connections", static_cast<double>(tracker.GetActiveCount()), "");
+    BenchReport("quiet: active buckets", static_cast<double>(tracker.GetActiveBucketCount()), "");
+}
+
+static bool IsLoopback(const BYTE* address) {
+    return address[0] == 127 && address[1] == 0 && address[2] == 0 && address[3] == 1;
+}
+
+// 本程序的 TCP 回环连接记录：本地端口 local、远程端口 remote、属于本进程且为 ESTABLISHED 时计数
+static size_t CountOwnEstablished(const std::vector<ConnectionInfo>& connections, WORD local, WORD remote) {
+    size_t count = 0;
+    for (const auto& info : connections) {
+        if (info.protocol == IPPROTO_TCP && !info.IsIpv6() && info.localPort == local && info.remotePort == remote &&
+            IsLoopback(info.localAddress) && IsLoopback(info.remoteAddress) &&
+            info.pid == static_cast<DWORD>(getpid()) && info.state == CONNECTION_STATE_ESTABLISHED) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// 用本程序建立的回环连接核对采集结果：每对连接的两端各出现一次，端口、所属进程与状态正确；
+// 只采集 LISTEN 时恰好返回本程序的监听套接字，只采集 ESTABLISHED 时不含监听套接字
+static void CheckLive(NetworkCollector& collector, WORD listenPort, const std::vector<WORD>& clientPorts) {
+    std::vector<ConnectionInfo> connections;
+    collector.SetStateFilter(CONNECTION_STATES_ALL);
+    collector.CollectConnections(connections);
+
+    size_t matchedPairs = 0;
+    for (WORD clientPort : clientPorts) {
+        if (CountOwnEstablished(connections, clientPort, listenPort) == 1 &&
+            CountOwnEstablished(connections, listenPort, clientPort) == 1) {
+            ++matchedPairs;
+        }
+    }
+    BenchReport("live: harness pairs found", static_cast<double>(matchedPairs), "");
+    Check("both ends of every pair, pid, ESTABLISHED", matchedPairs == clientPorts.size());
+
+    collector.SetStateFilter(ConnectionStateMask(CONNECTION_STATE_LISTEN));
+    collector.CollectConnections(connections);
+    size_t listeners = 0;
+    bool onlyListen = true;
+    for (const auto& info : connections) {
+        onlyListen = onlyListen && info.state == CONNECTION_STATE_LISTEN;
+        if (info.protocol == IPPROTO_TCP && info.localPort == listenPort) {
+            listeners += info.pid == static_cast<DWORD>(getpid()) ? 1 : 100;
+        }
+    }
+    Check("LISTEN filter returns only LISTEN", onlyListen);
+    Check("LISTEN filter returns exactly the listener", listeners == 1);
+
+    collector.SetStateFilter(ConnectionStateMask(CONNECTION_STATE_ESTABLISHED));
+    collector.CollectConnections(connections);
+    size_t own = 0;
+    bool onlyEstablished = true;
+    for (const auto& info : connections) {
+        onlyEstablished = onlyEstablished && info.state == CONNECTION_STATE_ESTABLISHED;
+        if (info.protocol == IPPROTO_TCP && (info.localPort == listenPort || info.remotePort == listenPort)) {
+            ++own;
+        }
+    }
+    Check("ESTABLISHED filter returns only ESTABLISHED", onlyEstablished);
+    Check("ESTABLISHED filter returns both ends of pairs", own == clientPorts.size() * 2);
+    collector.SetStateFilter(CONNECTION_STATES_ALL);
+}
+
+// 建立 pairs 对回环 TCP 连接，测量真实连接表的采集
+static void BenchLive(size_t pairs, size_t rounds) {
+    rlimit limit{};
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, 4096) != 0 || getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        std::perror("listen");
+        return;
+    }
+
+    std::vector<int> sockets;
+    std::vector<WORD> clientPorts;
+    for (size_t i = 0; i < pairs; ++i) {
+        int client = socket(AF_INET, SOCK_STREAM, 0);
+        if (client < 0 || connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            if (client >= 0) {
+                close(client);
+            }
+            break;
+        }
+        int server = accept(listener, nullptr, nullptr);
+        sockets.push_back(client);
+        if (server < 0) {
+            break;
+        }
+        sockets.push_back(server);
+        sockaddr_in clientAddress{};
+        socklen_t clientLength = sizeof(clientAddress);
+        getsockname(client, reinterpret_cast<sockaddr*>(&clientAddress), &clientLength);
+        clientPorts.push_back(ntohs(clientAddress.sin_port));
+    }
+
+    NetworkCollector collector;
+    std::vector<ConnectionInfo> connections;
+    std::vector<ConnectionStats> stats;
+    BenchTimer timer;
+    if (!collector.Initialize() || !collector.CollectConnections(connections, stats)) {
+        std::printf("live: CollectConnections failed\n");
+    }
+    else {
+        BenchReport("live: first collect", timer.ElapsedMs(), "ms");
+        uint64_t allocations = BenchAllocationCount();
+        timer.Restart();
+        for (size_t i = 0; i < rounds; ++i) {
+            collector.CollectConnections(connections, stats);
+        }
+        BenchReport("live: connections", static_cast<double>(connections.size()), "");
+        BenchReport("live: refresh", timer.ElapsedMs() / rounds, "ms");
+        BenchReport("live: refresh allocations", static_cast<double>(BenchAllocationCount() - allocations) / rounds, "allocs/refresh");
+        CheckLive(collector, ntohs(address.sin_port), clientPorts);
+    }
+
+    for (int fd : sockets) {
+        close(fd);
+    }
+    close(listener);
+}
+
+int main(int argc, char** argv) {
+    size_t count = BenchArg(argc, argv, 1, 200000);
+    size_t pairs = BenchArg(argc, argv, 2, 1000);
+    size_t rounds = BenchArg(argc, argv, 3, 20);
+    size_t churn = BenchArg(argc, argv, 4, 50000);
+
+    BenchSynthetic(count ? count : 1);
+    BenchChurn(churn, rounds ? rounds : 1);
+    BenchLive(pairs, rounds ? rounds : 1);
+    return 0;
+}
@@ -0,0 +1,49 @@
+﻿// ProcessEnumBench.cpp
+// 进程采集：按不同线程数测量首次全量采集与稳态刷新的耗时（user-005 并行补全）
+// 用法：ProcessEnumBench [子进程数=500] [刷新轮数=20]
+#include "BenchCommon.h"
+#include "ProcessCollector.h"
+#include <cstdio>
+#include <string>
+
+int main(int argc, char** argv) {
+    size_t childCount = BenchArg(argc, argv, 1, 500);
+    size_t rounds = BenchArg(argc, argv, 2, 20);
+
+    BenchChildren children;
+    children.Spawn(childCount);
+
+    size_t serialCount = 0;
+    for (size_t workers : { 1, 2, 4, 8 }) {
+        ProcessCollector collector;
+        collector.SetWorkerCount(workers);
+        std::vector<ProcessInfo> processes;
+        ProcessDelta delta;
+
+        BenchTimer timer;
+        if (!collector.CollectProcesses(processes, delta)) {
+            std::fprintf(stderr, "CollectProcesses failed\n");
+            return 1;
+        }
+        double coldMs = timer.ElapsedMs();
+
+        timer.Restart();
+        for (size_t i = 0; i < rounds; ++i) {
+            collector.CollectProcesses(processes, delta);
+        }
+        double refreshMs = timer.ElapsedMs() / static_cast<double>(rounds ? rounds : 1);
+
+        if (workers == 1) {
+            serialCount = processes.size();
+        }
+        std::string prefix = "workers=" + std::to_string(workers) + " ";
+        BenchReport((prefix + "processes").c_str(), static_cast<double>(processes.size()), "");
+        BenchReport((prefix + "cold collect").c_str(), coldMs, "ms");
+        BenchReport((prefix + "steady refresh").c_str(), refreshMs, "ms");
+        if (processes.size() != serialCount) {
+            // 并行补全的结果应与顺序执行一致；进程数只会因外部进程启停而略有出入
+            std::printf("  note: process count differs from serial run (%zu vs %zu)\n", processes.size(), serialCount);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,244 @@
+﻿// ProcessEventBench.cpp
+// 进程事件与定时扫描对比（user-010）：新进程的检测延迟、漏检的短命进程数，以及采集方的 CPU 开销。
+// 事件模式按刷新间隔只做计数器刷新（RefreshVolatileFields + 速率），与 DataManager 的自动刷新一致。
+// 需要 CAP_NET_ADMIN（netlink proc connector），否则只运行定时扫描。
+// 用法：ProcessEventBench [每种模式秒数=5] [每秒启动进程数=20] [刷新间隔毫秒=1000] [子进程存活毫秒=200] [背景子进程数=300]
+#include "BenchCommon.h"
+#include "ProcessCollector.h"
+#include "ProcessRateCalculator.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unistd.h>
+#include <sys/wait.h>
+
+struct BenchOptions {
+    size_t seconds = 5;
+    size_t spawnPerSecond = 20;
+    size_t intervalMs = 1000;
+    size_t lifetimeMs = 200;
+};
+
+static ULONGLONG NowNs() {
+    return static_cast<ULONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 按固定频率启动短命子进程，记录各 pid 的启动时刻，检测到时计算延迟
+class Spawner {
+public:
+    explicit Spawner(const BenchOptions& options) : m_options(options) {}
+
+    void Start() {
+        m_running = true;
+        m_thread = std::thread(&Spawner::Run, this);
+    }
+
+    void Stop() {
+        m_running = false;
+        m_thread.join();
+        for (pid_t pid : m_children) {
+            waitpid(pid, nullptr, 0);
+        }
+        m_children.clear();
+    }
+
+    // 首次检测到某个由本程序启动的 pid 时记录延迟
+    void Detected(DWORD pid) {
+        ULONGLONG now = NowNs();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_pending.find(static_cast<pid_t>(pid));
+        if (it != m_pending.end()) {
+            m_latenciesMs.push_back((now - it->second) / 1e6);
+            m_pending.erase(it);
+        }
+        else {
+            // 事件可能先于 fork 在父进程中返回到达，登记时再计算
+            m_early.emplace(static_cast<pid_t>(pid), now);
+        }
+    }
+
+    void Report(const std::string& mode) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::sort(m_latenciesMs.begin(), m_latenciesMs.end());
+        double sum = 0.0;
+        for (double latency : m_latenciesMs) {
+            sum += latency;
+        }
+        size_t count = m_latenciesMs.size();
+        BenchReport((mode + ": spawned").c_str(), static_cast<double>(m_spawned), "");
+        BenchReport((mode + ": detected").c_str(), static_cast<double>(count), "");
+        BenchReport((mode + ": missed").c_str(), static_cast<double>(m_spawned - count), "");
+        if (count != 0) {
+            BenchReport((mode + ": latency mean").c_str(), sum / count, "ms");
+            BenchReport((mode + ": latency p99").c_str(), m_latenciesMs[(count - 1) * 99 / 100], "ms");
+        }
+    }
+
+private:
+    void Run() {
+        auto period = std::chrono::microseconds(1000000 / std::max<size_t>(m_options.spawnPerSecond, 1));
+        auto next = std::chrono::steady_clock::now();
+        while (m_running) {
+            ULONGLONG forkTime = NowNs();
+            std::fflush(stdout);
+            pid_t pid = fork();
+            if (pid == 0) {
+                usleep(static_cast<useconds_t>(m_options.lifetimeMs * 1000));
+                _exit(0);
+            }
+            if (pid > 0) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto early = m_early.find(pid);
+                if (early != m_early.end()) {
+                    m_latenciesMs.push_back((early->second - forkTime) / 1e6);
+                    m_early.erase(early);
+                }
+                else {
+                    m_pending[pid] = forkTime;
+                }
+                ++m_spawned;
+                m_children.push_back(pid);
+            }
+            // 回收已退出的子进程（只回收本线程启动的）
+            m_children.erase(std::remove_if(m_children.begin(), m_children.end(), [](pid_t child) {
+                return waitpid(child, nullptr, WNOHANG) == child;
+            }), m_children.end());
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    BenchOptions m_options;
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::unordered_map<pid_t, ULONGLONG> m_pending;   // 已启动尚未检测到的 pid -> 启动时刻
+    std::unordered_map<pid_t, ULONGLONG> m_early;     // 先于登记检测到的 pid -> 检测时刻
+    std::vector<pid_t> m_children;   // 尚未回收的子进程
+    std::vector<double> m_latenciesMs;
+    size_t m_spawned = 0;
+};
+
+// 只启动子进程，不采集：作为 CPU 开销的基线
+static double RunBaseline(const BenchOptions& options) {
+    Spawner spawner(options);
+    double cpuStart = BenchProcessCpuMs();
+    spawner.Start();
+    std::this_thread::sleep_for(std::chrono::seconds(options.seconds));
+    spawner.Stop();
+    return (BenchProcessCpuMs() - cpuStart) / options.seconds;
+}
+
+static void RunPolling(const BenchOptions& options, double baselineCpu) {
+    ProcessCollector collector;
+    ProcessRateCalculator rates;
+    std::vector<ProcessInfo> processes;
+    ProcessDelta delta;
+    collector.CollectProcesses(processes, delta);
+
+    Spawner spawner(options);
+    double cpuStart = BenchProcessCpuMs();
+    spawner.Start();
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(options.seconds);
+    auto next = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() < end) {
+        collector.CollectProcesses(processes, delta);
+        rates.Update(processes, std::thread::hardware_concurrency());
+        for (size_t index : delta.added) {
+            spawner.Detected(processes[index].pid);
+        }
+        next += std::chrono::milliseconds(options.intervalMs);
+        std::this_thread::sleep_until(next);
+    }
+    spawner.Stop();
+    double cpu = (BenchProcessCpuMs() - cpuStart) / options.seconds - baselineCpu;
+
+    BenchReport("polling: processes", static_cast<double>(processes.size()), "");
+    spawner.Report("polling");
+    BenchReport("polling: collector cpu", cpu, "ms/s");
+}
+
+static void RunEvents(const BenchOptions& options, double baselineCpu) {
+    std::unique_ptr<IProcessEventSource> source = CreateProcessEventSource();
+    if (!source || !source->Initialize()) {
+        std::printf("events: process event source unavailable (needs CAP_NET_ADMIN), skipped\n");
+        return;
+    }
+
+    ProcessCollector collector;
+    ProcessRateCalculator rates;
+    std::vector<ProcessInfo> processes;
+    ProcessDelta delta;
+    collector.CollectProcesses(processes, delta);
+    std::mutex mutex;   // 与 DataManager 的数据锁相同：事件线程与计数器刷新互斥
+
+    Spawner spawner(options);
+    std::atomic<bool> running{ true };
+    double cpuStart = BenchProcessCpuMs();
+    std::thread eventThread([&] {
+        std::vector<ProcessEvent> events;
+        ProcessDelta eventDelta;
+        while (running) {
+            events.clear();
+            if (!source->WaitEvents(events, 200) || events.empty()) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            collector.ApplyEvents(events, processes, eventDelta);
+            for (const auto& event : events) {
+                if (event.type == PROCESS_EVENT_FORK) {
+                    spawner.Detected(event.pid);
+                }
+            }
+        }
+    });
+
+    spawner.Start();
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(options.seconds);
+    auto next = std::chrono::steady_clock::now();
+    size_t inconsistent = 0;
+    while (std::chrono::steady_clock::now() < end) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!collector.RefreshVolatileFields(processes, delta)) {
+                ++inconsistent;
+            }
+            rates.Update(processes, std::thread::hardware_concurrency());
+        }
+        next += std::chrono::milliseconds(options.intervalMs);
+        std::this_thread::sleep_until(next);
+    }
+    spawner.Stop();
+    running = false;
+    eventThread.join();
+    double cpu = (BenchProcessCpuMs() - cpuStart) / options.seconds - baselineCpu;
+    source->Cleanup();
+
+    BenchReport("events: processes", static_cast<double>(processes.size()), "");
+    spawner.Report("events");
+    BenchReport("events: counter passes needing reconcile", static_cast<double>(inconsistent), "");
+    BenchReport("events: collector cpu", cpu, "ms/s");
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    options.seconds = std::max<size_t>(BenchArg(argc, argv, 1, options.seconds), 1);
+    options.spawnPerSecond = BenchArg(argc, argv, 2, options.spawnPerSecond);
+    options.intervalMs = std::max<size_t>(BenchArg(argc, argv, 3, options.intervalMs), 10);
+    options.lifetimeMs = BenchArg(argc, argv, 4, options.lifetimeMs);
+    size_t childCount = BenchArg(argc, argv, 5, 300);
+
+    BenchChildren children;
+    children.Spawn(childCount);
+
+    double baselineCpu = RunBaseline(options);
+    BenchReport("baseline: spawner cpu", baselineCpu, "ms/s");
+    RunPolling(options, baselineCpu);
+    RunEvents(options, baselineCpu);
+    return 0;
+}
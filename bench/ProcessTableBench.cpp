@@ -0,0 +1,137 @@
+﻿// ProcessTableBench.cpp
+// 列式进程表（user-008）：在大量合成进程行上对比列式表与逐行遍历 ProcessInfo 的
+// 求和、最大值、阈值掩码、前 N 名、全排序与汇总耗时，并核对两种做法的结果一致。
+// 用法：ProcessTableBench [进程行数=100000] [重复次数=50]
+#include "BenchCommon.h"
+#include "ProcessTable.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+
+static std::vector<ProcessInfo> MakeProcesses(size_t count) {
+    std::mt19937_64 random(42);
+    std::vector<ProcessInfo> processes(count);
+    for (size_t i = 0; i < count; ++i) {
+        ProcessInfo& info = processes[i];
+        info.pid = static_cast<DWORD>(i * 4 + 4);
+        info.parentPid = static_cast<DWORD>(i / 8 * 4);
+        info.memoryUsage = static_cast<SIZE_T>(random() % (512ull << 20));
+        info.kernelTime = UInt64ToFileTime(random() % 100000000000ull);
+        info.userTime = UInt64ToFileTime(random() % 100000000000ull);
+        // 大多数进程空闲，少数占用较高
+        info.cpuUsage = i % 50 == 0 ? (random() % 10000) / 100.0 : (random() % 100) / 100.0;
+        info.memoryGrowthRate = static_cast<double>(static_cast<long long>(random() % 2000000) - 1000000);
+    }
+    return processes;
+}
+
+// 每种操作重复 rounds 次，报告单次的微秒数
+template <typename Work>
+static void Measure(const char* name, size_t rounds, Work work) {
+    BenchTimer timer;
+    for (size_t i = 0; i < rounds; ++i) {
+        work();
+    }
+    BenchReport(name, timer.ElapsedUs() / rounds, "us");
+}
+
+static void Check(const char* name, bool passed) {
+    std::printf("check: %-40s %s\n", name, passed ? "PASS" : "FAIL");
+}
+
+int main(int argc, char** argv) {
+    size_t count = std::max<size_t>(BenchArg(argc, argv, 1, 100000), 1);
+    size_t rounds = std::max<size_t>(BenchArg(argc, argv, 2, 50), 1);
+    const size_t topCount = 20;
+    const double cpuThreshold = 50.0;
+
+    std::vector<ProcessInfo> processes = MakeProcesses(count);
+    BenchReport("rows", static_cast<double>(count), "");
+
+    ProcessTable table;
+    Measure("columnar: build", rounds, [&] { table.Build(processes); });
+
+    // 逐行遍历 ProcessInfo 的做法（改造前）
+    volatile double sink = 0.0;
+    double rowSum = 0.0;
+    Measure("rows: sum memory", rounds, [&] {
+        double sum = 0.0;
+        for (const auto& info : processes) {
+            sum += static_cast<double>(info.memoryUsage);
+        }
+        rowSum = sum;
+    });
+    double columnSum = 0.0;
+    Measure("columnar: sum memory", rounds, [&] { columnSum = table.Sum(ProcessTable::COLUMN_MEMORY); });
+
+    double rowMax = 0.0;
+    Measure("rows: max cpu", rounds, [&] {
+        double value = 0.0;
+        for (const auto& info : processes) {
+            value = (std::max)(value, info.cpuUsage);
+        }
+        rowMax = value;
+    });
+    double columnMax = 0.0;
+    Measure("columnar: max cpu", rounds, [&] { columnMax = table.Max(ProcessTable::COLUMN_CPU_USAGE); });
+
+    size_t rowMatched = 0;
+    Measure("rows: mask cpu >= 50", rounds, [&] {
+        size_t matched = 0;
+        for (const auto& info : processes) {
+            matched += info.cpuUsage >= cpuThreshold;
+        }
+        rowMatched = matched;
+    });
+    std::vector<uint8_t> mask;
+    size_t columnMatched = 0;
+    Measure("columnar: mask cpu >= 50", rounds, [&] {
+        columnMatched = table.Mask(ProcessTable::COLUMN_CPU_USAGE, cpuThreshold, mask);
+    });
+
+    std::vector<ProcessInfo> rowTop;
+    Measure("rows: top 20 by memory (copy + partial_sort)", rounds, [&] {
+        rowTop = processes;
+        std::partial_sort(rowTop.begin(), rowTop.begin() + (std::min)(topCount, rowTop.size()), rowTop.end(),
+            [](const ProcessInfo& a, const ProcessInfo& b) { return a.memoryUsage > b.memoryUsage; });
+        rowTop.resize((std::min)(topCount, rowTop.size()));
+    });
+    std::vector<size_t> columnTop;
+    Measure("columnar: top 20 by memory", rounds, [&] {
+        columnTop = table.TopN(ProcessTable::COLUMN_MEMORY, topCount);
+    });
+
+    // 与列式表相同，值相同按原顺序（pid 升序）排列
+    Measure("rows: sort all by cpu (copy + sort)", rounds, [&] {
+        std::vector<ProcessInfo> sorted = processes;
+        std::sort(sorted.begin(), sorted.end(), [](const ProcessInfo& a, const ProcessInfo& b) {
+            return a.cpuUsage != b.cpuUsage ? a.cpuUsage > b.cpuUsage : a.pid < b.pid;
+        });
+        sink = sorted.front().cpuUsage;
+    });
+    std::vector<size_t> sortedRows;
+    Measure("columnar: sort all by cpu", rounds, [&] {
+        sortedRows = table.SortedRows(ProcessTable::COLUMN_CPU_USAGE, true);
+    });
+
+    ProcessSummary summary;
+    Measure("columnar: summarize", rounds, [&] { summary = table.Summarize(); });
+
+    Check("sum matches rows", columnSum == rowSum || (columnSum - rowSum) / rowSum < 1e-12);
+    Check("max matches rows", columnMax == rowMax);
+    Check("mask count matches rows", columnMatched == rowMatched);
+    bool topMatches = columnTop.size() == rowTop.size();
+    for (size_t i = 0; topMatches && i < columnTop.size(); ++i) {
+        topMatches = processes[columnTop[i]].memoryUsage == rowTop[i].memoryUsage;
+    }
+    Check("top 20 matches rows", topMatches);
+    bool sortedDescending = sortedRows.size() == count;
+    for (size_t i = 1; sortedDescending && i < sortedRows.size(); ++i) {
+        sortedDescending = processes[sortedRows[i - 1]].cpuUsage >= processes[sortedRows[i]].cpuUsage;
+    }
+    Check("sorted rows are descending", sortedDescending);
+    Check("summary matches columns", summary.processCount == count &&
+        static_cast<double>(summary.totalMemory) == columnSum && summary.maxCpuUsage == columnMax);
+    return 0;
+}
@@ -0,0 +1,351 @@
+﻿// ServiceBench.cpp
+// 服务采集与控制，全部基于内存中的模拟服务管理器（SimulatedServiceSource），可在 Linux 上复现：
+//   配置缓存（user-018）：稳态刷新不查询配置，配置版本号变化时只重新查询该服务并报告变化，
+//   不提供版本号的修改在定期校正时发现。
+//   异步控制（user-019）：大量服务并发启动与逐个启动的耗时对比，同一服务上的操作按提交顺序执行，
+//   超时、启动失败与关闭时取消。
+//   依赖图（user-020）：8 条深度 5 的依赖链、一个菱形依赖与一个两节点依赖环，按依赖顺序并发执行计划
+//   与逐个执行的耗时对比，依赖环被拒绝，某一步失败时只跳过所在链上的后续服务。
+// 用法：ServiceBench [服务数=500] [并发启动的服务数=65] [状态转换毫秒=300]
+#include "BenchCommon.h"
+#include "ServiceCollector.h"
+#include "ServiceController.h"
+#include "ServiceDependencyGraph.h"
+#include "ServiceSourceSimulated.h"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+static void Check(const char* name, bool passed) {
+    std::printf("check: %-48s %s\n", name, passed ? "PASS" : "FAIL");
+}
+
+static std::wstring ServiceName(size_t index) {
+    return L"svc" + std::to_wstring(index);
+}
+
+static const ServiceConfigChange* FindChange(const std::vector<ServiceConfigChange>& changes, const std::wstring& serviceName) {
+    for (const auto& change : changes) {
+        if (change.serviceName == serviceName) {
+            return &change;
+        }
+    }
+    return nullptr;
+}
+
+static void BenchConfigCache(size_t serviceCount) {
+    auto owned = std::make_unique<SimulatedServiceSource>();
+    SimulatedServiceSource& source = *owned;
+    for (size_t i = 0; i < serviceCount; ++i) {
+        source.AddService(ServiceName(i), L"Service " + std::to_wstring(i),
+            i % 2 ? SERVICE_RUNNING : SERVICE_STOPPED, SERVICE_DEMAND_START, L"/usr/sbin/" + ServiceName(i));
+    }
+
+    ServiceCollector collector(std::move(owned));
+    if (!collector.Initialize()) {
+        std::printf("config: ServiceCollector::Initialize failed\n");
+        return;
+    }
+    collector.SetConfigReconcileInterval(1);
+
+    std::vector<ServiceInfo> services;
+    std::vector<ServiceConfigChange> changes;
+    BenchTimer timer;
+    collector.CollectServices(services, changes);
+    BenchReport("config: services", static_cast<double>(services.size()), "");
+    BenchReport("config: first refresh (queries every service)", timer.ElapsedUs(), "us");
+    BenchReport("config: first refresh config queries", static_cast<double>(collector.GetLastConfigQueryCount()), "");
+
+    size_t queriesBefore = source.GetConfigQueryCount();
+    changes.clear();
+    timer.Restart();
+    collector.CollectServices(services, changes);
+    BenchReport("config: steady refresh", timer.ElapsedUs(), "us");
+    BenchReport("config: steady refresh config queries", static_cast<double>(source.GetConfigQueryCount() - queriesBefore), "");
+    Check("steady refresh issues no config queries",
+        source.GetConfigQueryCount() == queriesBefore && collector.GetLastConfigQueryCount() == 0 && changes.empty());
+
+    // 配置版本号递增：只重新查询该服务，并报告旧值与新值
+    const std::wstring bumped = ServiceName(7);
+    source.SetConfig(bumped, SERVICE_AUTO_START, L"/tmp/implant", true);
+    queriesBefore = source.GetConfigQueryCount();
+    changes.clear();
+    collector.CollectServices(services, changes);
+    const ServiceConfigChange* change = FindChange(changes, bumped);
+    BenchReport("config: refresh after generation bump, queries", static_cast<double>(source.GetConfigQueryCount() - queriesBefore), "");
+    Check("generation bump re-queries only that service", source.GetConfigQueryCount() - queriesBefore == 1);
+    Check("generation bump reports the config change", changes.size() == 1 && change &&
+        change->changedFields == (SERVICE_CONFIG_CHANGED_START_TYPE | SERVICE_CONFIG_CHANGED_BINARY_PATH) &&
+        change->oldStartType == SERVICE_DEMAND_START && change->newStartType == SERVICE_AUTO_START &&
+        change->oldBinaryPath.str() == L"/usr/sbin/" + bumped && change->newBinaryPath.str() == L"/tmp/implant");
+
+    // 不递增版本号的修改：下一次普通刷新发现不了，定期校正时发现
+    const std::wstring silent = ServiceName(9);
+    auto lastReconcile = std::chrono::steady_clock::now();
+    source.SetConfig(silent, SERVICE_DISABLED, L"/tmp/silent", false);
+    changes.clear();
+    collector.CollectServices(services, changes);
+    Check("change without bump is not seen before reconcile", collector.GetLastConfigQueryCount() == 0 && changes.empty());
+
+    std::this_thread::sleep_until(lastReconcile + std::chrono::milliseconds(1100));
+    changes.clear();
+    timer.Restart();
+    collector.CollectServices(services, changes);
+    BenchReport("config: reconcile refresh", timer.ElapsedUs(), "us");
+    BenchReport("config: reconcile refresh config queries", static_cast<double>(collector.GetLastConfigQueryCount()), "");
+    change = FindChange(changes, silent);
+    Check("reconcile detects the change without bump", changes.size() == 1 && change &&
+        (change->changedFields & SERVICE_CONFIG_CHANGED_BINARY_PATH) && change->newStartType == SERVICE_DISABLED);
+}
+
+// count 个处于 STOPPED 的服务，名称前缀为 prefix
+static void AddStoppedServices(SimulatedServiceSource& source, const std::wstring& prefix, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        source.AddService(prefix + std::to_wstring(i), prefix + std::to_wstring(i),
+            SERVICE_STOPPED, SERVICE_DEMAND_START, L"/usr/sbin/" + prefix);
+    }
+}
+
+static void BenchParallelStart(size_t count, std::chrono::milliseconds transition) {
+    SimulatedServiceSource source;
+    source.SetTransitionDelay(transition);
+    AddStoppedServices(source, L"par", count);
+    AddStoppedServices(source, L"ser", 8);
+    ServiceController controller(source);
+
+    std::vector<std::wstring> names;
+    for (size_t i = 0; i < count; ++i) {
+        names.push_back(L"par" + std::to_wstring(i));
+    }
+    BenchTimer timer;
+    size_t succeeded = 0;
+    for (auto& future : controller.SubmitBatch(names, SERVICE_OPERATION_START)) {
+        succeeded += future.get().Succeeded();
+    }
+    double parallelMs = timer.ElapsedMs();
+
+    // 逐个提交并等待完成（改造前的同步做法），只测 8 个服务再按数量折算
+    timer.Restart();
+    size_t serialSucceeded = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        serialSucceeded += controller.Submit(L"ser" + std::to_wstring(i), SERVICE_OPERATION_START).get().Succeeded();
+    }
+    double serialPerService = timer.ElapsedMs() / 8;
+
+    BenchReport("control: services started in parallel", static_cast<double>(count), "");
+    BenchReport("control: parallel start wall time", parallelMs, "ms");
+    BenchReport("control: one-at-a-time start per service", serialPerService, "ms");
+    BenchReport("control: one-at-a-time estimate for all", serialPerService * count, "ms");
+    Check("all parallel starts succeed", succeeded == count && serialSucceeded == 8);
+    Check("parallel starts overlap (< 3 transitions)", parallelMs < transition.count() * 3.0);
+}
+
+// 同一服务上的操作按提交顺序逐个执行，每个操作看到前一个操作的结果
+static void CheckServiceOrdering(std::chrono::milliseconds transition) {
+    SimulatedServiceSource source;
+    source.SetTransitionDelay(transition);
+    AddStoppedServices(source, L"fifo", 1);
+    ServiceController controller(source);
+
+    const ServiceOperationType types[] = {
+        SERVICE_OPERATION_START, SERVICE_OPERATION_STOP, SERVICE_OPERATION_RESTART, SERVICE_OPERATION_STOP };
+    const DWORD expected[] = { SERVICE_RUNNING, SERVICE_STOPPED, SERVICE_RUNNING, SERVICE_STOPPED };
+    std::mutex mutex;
+    std::vector<ServiceOperationType> completed;
+    std::vector<std::future<ServiceOperationOutcome>> futures;
+    for (ServiceOperationType type : types) {
+        futures.push_back(controller.Submit(L"fifo0", type, [&mutex, &completed](const ServiceOperationOutcome& outcome) {
+            std::lock_guard<std::mutex> lock(mutex);
+            completed.push_back(outcome.type);
+        }));
+    }
+
+    bool statusesMatch = true;
+    for (size_t i = 0; i < futures.size(); ++i) {
+        ServiceOperationOutcome outcome = futures[i].get();
+        statusesMatch = statusesMatch && outcome.Succeeded() && outcome.finalStatus == expected[i];
+    }
+    Check("same-service operations complete in FIFO order",
+        completed == std::vector<ServiceOperationType>(std::begin(types), std::end(types)));
+    Check("each operation reaches its target status", statusesMatch);
+}
+
+static void CheckTimeoutAndFailure() {
+    SimulatedServiceSource source;
+    source.SetTransitionDelay(std::chrono::milliseconds(2000));
+    AddStoppedServices(source, L"slow", 1);
+    ServiceController controller(source);
+    controller.SetTimeout(std::chrono::milliseconds(300));
+    ServiceOperationOutcome outcome = controller.Submit(L"slow0", SERVICE_OPERATION_START).get();
+    BenchReport("control: timed out after", outcome.elapsedMs, "ms");
+    Check("start slower than timeout reports TIMED_OUT",
+        outcome.result == SERVICE_OPERATION_TIMED_OUT && outcome.finalStatus == SERVICE_START_PENDING &&
+        outcome.elapsedMs < 1000.0);
+
+    SimulatedServiceSource failing;
+    failing.SetTransitionDelay(std::chrono::milliseconds(100));
+    AddStoppedServices(failing, L"bad", 1);
+    failing.SetStartFailure(L"bad0", true);
+    ServiceController failingController(failing);
+    outcome = failingController.Submit(L"bad0", SERVICE_OPERATION_START).get();
+    Check("start falling back to STOPPED reports FAILED",
+        outcome.result == SERVICE_OPERATION_FAILED && outcome.finalStatus == SERVICE_STOPPED);
+}
+
+static void CheckCancellation() {
+    SimulatedServiceSource source;
+    source.SetTransitionDelay(std::chrono::milliseconds(5000));
+    AddStoppedServices(source, L"long", 10);
+    ServiceController controller(source);
+
+    std::vector<std::future<ServiceOperationOutcome>> futures;
+    for (size_t i = 0; i < 10; ++i) {
+        futures.push_back(controller.Submit(L"long" + std::to_wstring(i), SERVICE_OPERATION_START));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    BenchTimer timer;
+    controller.Shutdown();
+    size_t cancelled = 0;
+    for (auto& future : futures) {
+        cancelled += future.get().result == SERVICE_OPERATION_CANCELLED;
+    }
+    BenchReport("control: shutdown with pending operations", timer.ElapsedMs(), "ms");
+    Check("shutdown cancels every pending operation", cancelled == futures.size());
+    Check("submit after shutdown is cancelled",
+        controller.Submit(L"long0", SERVICE_OPERATION_STOP).get().result == SERVICE_OPERATION_CANCELLED);
+}
+
+static const size_t kChainCount = 8;
+static const size_t kChainDepth = 5;
+
+static std::wstring ChainName(size_t chain, size_t depth) {
+    return L"chain" + std::to_wstring(chain) + L"_" + std::to_wstring(depth);
+}
+
+// 全部服务处于 STOPPED：root <- chainK_0 <- ... <- chainK_4（K = 0..7），
+// 菱形 diamondTop -> diamondLeft/diamondRight -> diamondBase，以及 cycleA <-> cycleB
+static std::unique_ptr<SimulatedServiceSource> MakeGraphSource(std::chrono::milliseconds transition) {
+    auto source = std::make_unique<SimulatedServiceSource>();
+    source->SetTransitionDelay(transition);
+    auto add = [&source](const std::wstring& name, const std::vector<std::wstring>& dependencies) {
+        source->AddService(name, name, SERVICE_STOPPED, SERVICE_DEMAND_START, L"/usr/sbin/" + name);
+        source->SetDependencies(name, dependencies);
+    };
+    add(L"root", {});
+    for (size_t chain = 0; chain < kChainCount; ++chain) {
+        for (size_t depth = 0; depth < kChainDepth; ++depth) {
+            add(ChainName(chain, depth), { depth == 0 ? std::wstring(L"root") : ChainName(chain, depth - 1) });
+        }
+    }
+    add(L"diamondBase", {});
+    add(L"diamondLeft", { L"diamondBase" });
+    add(L"diamondRight", { L"diamondBase" });
+    add(L"diamondTop", { L"diamondLeft", L"diamondRight" });
+    add(L"cycleA", { L"cycleB" });
+    add(L"cycleB", { L"cycleA" });
+    return source;
+}
+
+// 启动每条链的末端与菱形顶端，计划中包含它们的全部传递依赖
+static std::vector<std::wstring> GraphTargets() {
+    std::vector<std::wstring> targets;
+    for (size_t chain = 0; chain < kChainCount; ++chain) {
+        targets.push_back(ChainName(chain, kChainDepth - 1));
+    }
+    targets.push_back(L"diamondTop");
+    return targets;
+}
+
+static const ServiceOperationOutcome* FindStep(const ServicePlanOutcome& outcome, const std::wstring& serviceName) {
+    for (const auto& step : outcome.steps) {
+        if (step.serviceName == serviceName) {
+            return &step;
+        }
+    }
+    return nullptr;
+}
+
+static void BenchDependencyPlan(std::chrono::milliseconds transition) {
+    auto owned = MakeGraphSource(transition);
+    SimulatedServiceSource& source = *owned;
+    ServiceCollector collector(std::move(owned));
+    if (!collector.Initialize()) {
+        std::printf("plan: ServiceCollector::Initialize failed\n");
+        return;
+    }
+    std::vector<ServiceInfo> services;
+    std::vector<ServiceConfigChange> changes;
+    collector.CollectServices(services, changes);
+    const ServiceDependencyGraph& graph = collector.GetDependencyGraph();
+
+    const std::vector<std::wstring>& cycle = graph.GetCycleServices();
+    ServiceOperationPlan cyclePlan;
+    Check("plan touching the dependency cycle is rejected",
+        !graph.Plan({ L"cycleA" }, SERVICE_OPERATION_START, cyclePlan) &&
+        cycle.size() == 2 && std::count(cycle.begin(), cycle.end(), L"cycleB") == 1);
+
+    ServiceOperationPlan plan;
+    if (!graph.Plan(GraphTargets(), SERVICE_OPERATION_START, plan)) {
+        std::printf("plan: ServiceDependencyGraph::Plan failed\n");
+        return;
+    }
+    BenchReport("plan: steps", static_cast<double>(plan.steps.size()), "");
+    BenchReport("plan: waves", static_cast<double>(plan.waveCount), "");
+
+    // 按依赖顺序并发执行
+    ServicePlanOutcome outcome;
+    {
+        ServiceController controller(source);
+        outcome = controller.SubmitPlan(plan).get();
+    }
+    BenchReport("plan: ordered parallel wall time", outcome.elapsedMs, "ms");
+    Check("ordered parallel plan starts every service",
+        outcome.succeededCount == plan.steps.size() && outcome.failedCount == 0 && outcome.skippedCount == 0);
+
+    // 同一计划在一份新的服务图上按步骤顺序逐个执行
+    auto serialSource = MakeGraphSource(transition);
+    ServiceController serialController(*serialSource);
+    BenchTimer timer;
+    size_t serialSucceeded = 0;
+    for (const auto& step : plan.steps) {
+        serialSucceeded += serialController.Submit(step.serviceName, step.type).get().Succeeded();
+    }
+    BenchReport("plan: serial wall time", timer.ElapsedMs(), "ms");
+    Check("serial execution starts every service", serialSucceeded == plan.steps.size());
+
+    // 链 3 的第 2 个服务启动失败：只跳过该链上的后续服务
+    auto failingSource = MakeGraphSource(transition);
+    const size_t failingChain = 3;
+    const size_t failingDepth = 2;
+    failingSource->SetStartFailure(ChainName(failingChain, failingDepth), true);
+    ServiceController failingController(*failingSource);
+    outcome = failingController.SubmitPlan(plan).get();
+
+    bool onlyChainSkipped = outcome.failedCount == 1 &&
+        outcome.skippedCount == kChainDepth - failingDepth - 1 &&
+        outcome.succeededCount == plan.steps.size() - (kChainDepth - failingDepth);
+    for (size_t depth = failingDepth + 1; onlyChainSkipped && depth < kChainDepth; ++depth) {
+        const ServiceOperationOutcome* step = FindStep(outcome, ChainName(failingChain, depth));
+        onlyChainSkipped = step && step->result == SERVICE_OPERATION_SKIPPED;
+    }
+    const ServiceOperationOutcome* failed = FindStep(outcome, ChainName(failingChain, failingDepth));
+    const ServiceOperationOutcome* neighbour = FindStep(outcome, ChainName(failingChain + 1, kChainDepth - 1));
+    Check("failure skips only its own chain's dependents", onlyChainSkipped &&
+        failed && failed->result == SERVICE_OPERATION_FAILED && neighbour && neighbour->Succeeded());
+}
+
+int main(int argc, char** argv) {
+    size_t serviceCount = std::max<size_t>(BenchArg(argc, argv, 1, 500), 16);
+    size_t parallelCount = std::max<size_t>(BenchArg(argc, argv, 2, 65), 1);
+    std::chrono::milliseconds transition(std::max<size_t>(BenchArg(argc, argv, 3, 300), 10));
+
+    BenchConfigCache(serviceCount);
+    BenchParallelStart(parallelCount, transition);
+    CheckServiceOrdering(transition / 3);
+    CheckTimeoutAndFailure();
+    CheckCancellation();
+    BenchDependencyPlan(transition / 3);
+    return 0;
+}
@@ -0,0 +1,180 @@
+﻿// SocketIndexBench.cpp
+// 套接字归属索引（user-014）：大量进程共享套接字时的首次、增量、失效与全量扫描耗时，
+// 重新扫描期间报告的所属进程是否保持稳定，以及首个持有进程退出后是否由其余持有进程接替。
+// 用法：SocketIndexBench [子进程数=200] [套接字数=4000] [每个子进程保留的套接字数=50] [工作线程数=4]
+#include "BenchCommon.h"
+#include "SocketOwnerIndex.h"
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+struct ShareContext {
+    std::vector<int> fds;
+    size_t perChild = 50;
+    int readyFd = -1;   // 子进程关闭多余的 fd 后写入一个字节
+};
+
+// 第 index 个子进程只保留第 index % 块数 块套接字，块数少于子进程数时每块由多个进程共享
+static void KeepBlock(size_t index, void* context) {
+    auto* share = static_cast<ShareContext*>(context);
+    size_t blocks = std::max<size_t>(share->fds.size() / share->perChild, 1);
+    for (size_t i = 0; i < share->fds.size(); ++i) {
+        if (i / share->perChild % blocks != index % blocks) {
+            close(share->fds[i]);
+        }
+    }
+    char byte = 1;
+    if (write(share->readyFd, &byte, 1) != 1) {
+        _exit(1);
+    }
+}
+
+static ULONGLONG InodeOf(int fd) {
+    struct stat info;
+    return fstat(fd, &info) == 0 ? static_cast<ULONGLONG>(info.st_ino) : 0;
+}
+
+static void Report(const char* phase, const SocketOwnerIndex& index) {
+    const SocketOwnerIndex::Stats& stats = index.GetLastStats();
+    std::string name = phase;
+    BenchReport((name + ": elapsed").c_str(), stats.elapsedMs, "ms");
+    BenchReport((name + ": scanned processes").c_str(), static_cast<double>(stats.scannedCount), "");
+    BenchReport((name + ": indexed sockets").c_str(), static_cast<double>(stats.socketCount), "");
+}
+
+static void BenchShared(size_t childCount, size_t socketCount, size_t perChild, size_t workers) {
+    ShareContext share;
+    share.perChild = std::max<size_t>(perChild, 1);
+    for (size_t i = 0; i + 1 < socketCount; i += 2) {
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+            break;
+        }
+        share.fds.push_back(pair[0]);
+        share.fds.push_back(pair[1]);
+    }
+    int ready[2];
+    if (pipe(ready) != 0) {
+        std::perror("pipe");
+        return;
+    }
+    share.readyFd = ready[1];
+
+    BenchChildren children;
+    size_t spawned = children.Spawn(childCount, KeepBlock, &share);
+    for (size_t i = 0; i < spawned; ++i) {
+        char byte;
+        if (read(ready[0], &byte, 1) != 1) {
+            break;
+        }
+    }
+    close(ready[0]);
+    close(ready[1]);
+
+    // 本进程关闭自己的副本，套接字只由子进程持有
+    std::vector<ULONGLONG> inodes;
+    for (int fd : share.fds) {
+        inodes.push_back(InodeOf(fd));
+        close(fd);
+    }
+    BenchReport("shared: child processes", static_cast<double>(spawned), "");
+    BenchReport("shared: sockets", static_cast<double>(inodes.size()), "");
+
+    SocketOwnerIndex index(workers);
+    index.SetFullRescanInterval(0);
+    index.Refresh();
+    Report("cold", index);
+
+    std::unordered_map<ULONGLONG, DWORD> owners;
+    for (ULONGLONG inode : inodes) {
+        owners[inode] = index.FindOwner(inode);
+    }
+
+    index.Refresh();
+    Report("steady", index);
+
+    // 使全部子进程失效（相当于一批进程变化），再强制一次全量扫描
+    for (pid_t pid : children.Pids()) {
+        index.Invalidate(static_cast<DWORD>(pid));
+    }
+    index.Refresh();
+    Report("invalidate all", index);
+
+    index.SetFullRescanInterval(1);
+    index.Refresh();
+    Report("full rescan", index);
+
+    size_t changed = 0;
+    size_t unowned = 0;
+    for (ULONGLONG inode : inodes) {
+        DWORD owner = index.FindOwner(inode);
+        unowned += owner == 0;
+        changed += owner != owners[inode];
+    }
+    // 所有持有进程都仍存活，两项都应为 0
+    BenchReport("shared: owner changes across rescans", static_cast<double>(changed), "");
+    BenchReport("shared: sockets without owner", static_cast<double>(unowned), "");
+}
+
+// 两个子进程继承同一对套接字；先扫描到的一方退出后，所属进程应改为另一方
+static void CheckHandover() {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+        std::perror("socketpair");
+        return;
+    }
+    ULONGLONG inode = InodeOf(pair[0]);
+
+    std::fflush(stdout);
+    pid_t holders[2];
+    for (pid_t& holder : holders) {
+        holder = fork();
+        if (holder == 0) {
+            for (;;) {
+                pause();
+            }
+        }
+    }
+    close(pair[0]);
+    close(pair[1]);
+
+    SocketOwnerIndex index(1);
+    index.Refresh();
+    DWORD first = index.FindOwner(inode);
+    pid_t other = static_cast<pid_t>(first) == holders[0] ? holders[1] : holders[0];
+
+    kill(static_cast<pid_t>(first), SIGKILL);
+    waitpid(static_cast<pid_t>(first), nullptr, 0);
+    index.Refresh();
+    DWORD after = index.FindOwner(inode);
+    std::printf("handover: owner %u exited, owner now %u (expected %d) %s\n",
+        first, after, static_cast<int>(other), static_cast<pid_t>(after) == other ? "ok" : "FAILED");
+
+    kill(other, SIGKILL);
+    waitpid(other, nullptr, 0);
+    index.Refresh();
+    std::printf("handover: all holders exited, owner now %u %s\n", index.FindOwner(inode),
+        index.FindOwner(inode) == 0 ? "ok" : "FAILED");
+}
+
+int main(int argc, char** argv) {
+    size_t childCount = BenchArg(argc, argv, 1, 200);
+    size_t socketCount = BenchArg(argc, argv, 2, 4000);
+    size_t perChild = BenchArg(argc, argv, 3, 50);
+    size_t workers = BenchArg(argc, argv, 4, 4);
+
+    rlimit limit{};
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    BenchShared(childCount, socketCount, perChild, workers);
+    CheckHandover();
+    return 0;
+}
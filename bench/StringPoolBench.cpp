@@ -0,0 +1,114 @@
+﻿// StringPoolBench.cpp
+// 字符串驻留（user-007）：进程名查找的分配次数、驻留池命中在多线程下的吞吐，以及稳态刷新的分配次数
+// 用法：StringPoolBench [子进程数=500] [刷新轮数=20]
+#include "BenchCommon.h"
+#include "ProcessCollector.h"
+#include "ProcessNameCache.h"
+#include <cstdio>
+#include <string>
+#include <thread>
+
+static const size_t kNameCount = 512;
+static const size_t kLookups = 1000000;
+
+// 旧做法：每次都构造 std::string 与 std::wstring 再驻留；新做法：按 pid 比较原始字节
+static void BenchNameLookup(const std::vector<std::string>& names) {
+    std::vector<InternedString> handles(names.size());
+
+    uint64_t allocations = BenchAllocationCount();
+    BenchTimer timer;
+    for (size_t i = 0; i < kLookups; ++i) {
+        const std::string& raw = names[i % names.size()];
+        handles[i % names.size()] = InternedString(Utf8ToWide(std::string(raw.data(), raw.size())));
+    }
+    BenchReport("name: convert + intern", timer.ElapsedMs() * 1e6 / kLookups, "ns/lookup");
+    BenchReport("name: convert + intern allocations",
+        static_cast<double>(BenchAllocationCount() - allocations) / kLookups, "allocs/lookup");
+
+    ProcessNameCache<char> cache;
+    cache.BeginPass();
+    for (size_t i = 0; i < names.size(); ++i) {
+        cache.Lookup(static_cast<DWORD>(i), names[i]);
+    }
+    cache.EndPass();
+
+    allocations = BenchAllocationCount();
+    timer.Restart();
+    for (size_t round = 0; round < kLookups / names.size(); ++round) {
+        cache.BeginPass();
+        for (size_t i = 0; i < names.size(); ++i) {
+            handles[i] = cache.Lookup(static_cast<DWORD>(i), names[i]);
+        }
+        cache.EndPass();
+    }
+    size_t lookups = kLookups / names.size() * names.size();
+    BenchReport("name: cached raw bytes", timer.ElapsedMs() * 1e6 / lookups, "ns/lookup");
+    BenchReport("name: cached raw bytes allocations",
+        static_cast<double>(BenchAllocationCount() - allocations) / lookups, "allocs/lookup");
+}
+
+// 多个线程同时驻留同一组已存在的字符串（全部命中）
+static void BenchInternHits(const std::vector<std::wstring>& names) {
+    std::vector<InternedString> keep(names.begin(), names.end());
+
+    for (size_t threads : { 1, 2, 4, 8 }) {
+        size_t perThread = kLookups / threads;
+        BenchTimer timer;
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&names, perThread, t] {
+                for (size_t i = 0; i < perThread; ++i) {
+                    InternedString handle(std::wstring_view(names[(i + t * 7) % names.size()]));
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        std::string name = "intern hits, threads=" + std::to_string(threads);
+        // 墙钟时间除以总次数：线程间没有争用时应随线程数（不超过核心数）下降
+        BenchReport(name.c_str(), timer.ElapsedMs() * 1e6 / (perThread * threads), "ns/op");
+    }
+}
+
+static void BenchRefresh(size_t rounds) {
+    ProcessCollector collector;
+    std::vector<ProcessInfo> processes;
+    ProcessDelta delta;
+    collector.CollectProcesses(processes, delta);
+    collector.CollectProcesses(processes, delta);
+
+    StringPool::Stats before = StringPool::Instance().GetStats();
+    uint64_t allocations = BenchAllocationCount();
+    for (size_t i = 0; i < rounds; ++i) {
+        collector.CollectProcesses(processes, delta);
+    }
+    double perRefresh = static_cast<double>(BenchAllocationCount() - allocations) / rounds;
+    StringPool::Stats after = StringPool::Instance().GetStats();
+
+    BenchReport("refresh: processes", static_cast<double>(processes.size()), "");
+    BenchReport("refresh: allocations", perRefresh, "allocs/refresh");
+    BenchReport("refresh: allocations per process", perRefresh / processes.size(), "allocs/process");
+    BenchReport("refresh: pool intern calls",
+        static_cast<double>(after.internCalls - before.internCalls) / rounds, "calls/refresh");
+}
+
+int main(int argc, char** argv) {
+    size_t childCount = BenchArg(argc, argv, 1, 500);
+    size_t rounds = BenchArg(argc, argv, 2, 20);
+
+    std::vector<std::string> names;
+    std::vector<std::wstring> wideNames;
+    for (size_t i = 0; i < kNameCount; ++i) {
+        names.push_back("worker-" + std::to_string(i));
+        wideNames.push_back(L"service-" + std::to_wstring(i) + L".exe");
+    }
+
+    BenchNameLookup(names);
+    BenchInternHits(wideNames);
+
+    BenchChildren children;
+    children.Spawn(childCount);
+    BenchRefresh(rounds ? rounds : 1);
+    return 0;
+}
@@ -0,0 +1,131 @@
+﻿// SystemInfoBench.cpp
+// 系统信息拆分（user-021）：静态清单与动态计数器各自的采集耗时与分配次数。
+// 拆分前每次刷新都采集完整的系统信息（相当于清单 + 计数器），拆分后刷新只采样计数器。
+// 逐核样本（user-023）：合成的多处理器样本写入逐核环形缓冲区后完整读回，处理器增加时不截断。
+// 用法：SystemInfoBench [清单采集次数=200] [计数器采样次数=2000] [合成处理器数=384]
+#include "BenchCommon.h"
+#include "SystemInfoCollector.h"
+#include "SystemSampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static void Check(const char* name, bool passed) {
+    std::printf("check: %-48s %s\n", name, passed ? "PASS" : "FAIL");
+}
+
+// 第 round 次采样：每个处理器在两次采样之间忙 (cpuId % 100)% 的时间
+static void MakeCoreTimes(size_t cpuCount, ULONGLONG round, std::vector<CpuCoreTimes>& cores) {
+    const ULONGLONG interval = 10000000;   // 1 秒
+    cores.resize(cpuCount);
+    for (size_t i = 0; i < cpuCount; ++i) {
+        CpuCoreTimes& core = cores[i];
+        core.cpuId = static_cast<DWORD>(i);
+        core.user = round * interval * (i % 100) / 100;
+        core.idle = round * interval - core.user;
+    }
+}
+
+static bool UsageMatches(const std::vector<CpuCoreUsage>& usage, size_t cpuCount) {
+    if (usage.size() != cpuCount) {
+        return false;
+    }
+    for (size_t i = 0; i < cpuCount; ++i) {
+        if (usage[i].cpuId != i || std::abs(usage[i].total - static_cast<float>(i % 100)) > 0.01f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 逐核环形缓冲区按首次样本的处理器数分配；之后处理器增加（热插拔）时扩大，不丢弃新增的处理器
+static void BenchCoreSamples(size_t cpuCount) {
+    size_t initialCount = std::max<size_t>(cpuCount / 2, 1);
+    SampleArrayRing<CpuCoreTimes> ring(64, initialCount);
+    std::vector<CpuCoreTimes> cores;
+    MakeCoreTimes(initialCount, 1, cores);
+    ring.Push(10000000, cores.data(), cores.size());
+
+    BenchTimer timer;
+    const size_t rounds = 1000;
+    for (ULONGLONG round = 2; round < rounds + 2; ++round) {
+        MakeCoreTimes(cpuCount, round, cores);
+        ring.Push(round * 10000000, cores.data(), cores.size());
+    }
+    BenchReport("cores: synthetic cpus", static_cast<double>(cpuCount), "");
+    BenchReport("cores: push (incl. building the sample)", timer.ElapsedUs() / rounds, "us/sample");
+
+    std::vector<CpuCoreSample> samples;
+    std::vector<CpuCoreUsage> usage;
+    uint64_t allocations = BenchAllocationCount();
+    timer.Restart();
+    for (size_t i = 0; i < rounds; ++i) {
+        ring.ReadRecent(2, samples);
+        CalculateCpuCoreUsage(samples[0], samples[1], usage);
+    }
+    BenchReport("cores: read last two + usage", timer.ElapsedUs() / rounds, "us/call");
+    BenchReport("cores: read allocations", static_cast<double>(BenchAllocationCount() - allocations) / rounds, "allocs/call");
+
+    Check("ring widened to every cpu", ring.GetStride() >= cpuCount);
+    Check("every cpu is kept and usage is correct", samples.size() == 2 &&
+        samples[1].items.size() == cpuCount && UsageMatches(usage, cpuCount));
+
+    // 处理器数变化前后的两个样本：新增的处理器没有上一次的数据，使用率为 0
+    SampleArrayRing<CpuCoreTimes> growing(4, initialCount);
+    MakeCoreTimes(initialCount, 1, cores);
+    growing.Push(10000000, cores.data(), cores.size());
+    MakeCoreTimes(cpuCount, 2, cores);
+    growing.Push(20000000, cores.data(), cores.size());
+    growing.ReadRecent(2, samples);
+    CalculateCpuCoreUsage(samples.size() == 2 ? samples[0] : CpuCoreSample(), samples.back(), usage);
+    Check("growth keeps the new sample and every cpu", samples.back().items.size() == cpuCount &&
+        usage.size() == cpuCount && usage.back().cpuId == cpuCount - 1 && usage.back().total == 0.0f);
+}
+
+int main(int argc, char** argv) {
+    size_t inventoryRounds = std::max<size_t>(BenchArg(argc, argv, 1, 200), 1);
+    size_t counterRounds = std::max<size_t>(BenchArg(argc, argv, 2, 2000), 1);
+    size_t cpuCount = std::max<size_t>(BenchArg(argc, argv, 3, 384), 2);
+
+    SystemInfoCollector collector;
+    if (!collector.Initialize()) {
+        std::printf("SystemInfoCollector::Initialize failed\n");
+        return 1;
+    }
+
+    uint64_t allocations = BenchAllocationCount();
+    BenchTimer timer;
+    size_t cores = 0;
+    for (size_t i = 0; i < inventoryRounds; ++i) {
+        std::unique_ptr<SystemInventory> inventory = collector.CollectInventory();
+        cores = inventory ? inventory->cpuCores : 0;
+    }
+    double inventoryUs = timer.ElapsedUs() / inventoryRounds;
+    double inventoryAllocations = static_cast<double>(BenchAllocationCount() - allocations) / inventoryRounds;
+    BenchReport("inventory: cpu cores", static_cast<double>(cores), "");
+    BenchReport("inventory: collect", inventoryUs, "us/call");
+    BenchReport("inventory: allocations", inventoryAllocations, "allocs/call");
+
+    SystemCounters counters;
+    collector.CollectCounters(counters);
+    allocations = BenchAllocationCount();
+    timer.Restart();
+    size_t failures = 0;
+    for (size_t i = 0; i < counterRounds; ++i) {
+        failures += !collector.CollectCounters(counters);
+    }
+    double countersUs = timer.ElapsedUs() / counterRounds;
+    double counterAllocations = static_cast<double>(BenchAllocationCount() - allocations) / counterRounds;
+    BenchReport("counters: collect", countersUs, "us/call");
+    BenchReport("counters: allocations", counterAllocations, "allocs/call");
+    BenchReport("counters: failed samples", static_cast<double>(failures), "");
+
+    // 每次刷新的开销：拆分前采集清单与计数器，拆分后只采样计数器
+    BenchReport("refresh before split (inventory + counters)", inventoryUs + countersUs, "us/refresh");
+    BenchReport("refresh after split (counters)", countersUs, "us/refresh");
+    BenchReport("refresh allocations before split", inventoryAllocations + counterAllocations, "allocs/refresh");
+    BenchReport("refresh allocations after split", counterAllocations, "allocs/refresh");
+
+    BenchCoreSamples(cpuCount);
+    return 0;
+}
@@ -0,0 +1,153 @@
+﻿#include "cpuheatstrip.h"
+#include <QPainter>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <algorithm>
+#include <tuple>
+
+CpuHeatStrip::CpuHeatStrip(QWidget* parent) : QWidget(parent) {
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+    // 每次都整块重绘，背景由 paintEvent 负责
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void CpuHeatStrip::setTopology(const std::vector<CpuTopologyEntry>& topology) {
+    m_topology = topology;
+    std::sort(m_topology.begin(), m_topology.end(),
+        [](const CpuTopologyEntry& a, const CpuTopologyEntry& b) { return a.cpuId < b.cpuId; });
+    rebuildOrder();
+    updateGeometry();
+    update();
+}
+
+void CpuHeatStrip::setUsage(const std::vector<CpuCoreUsage>& usage) {
+    bool sameCpus = usage.size() == m_usage.size();
+    for (size_t i = 0; sameCpus && i < usage.size(); ++i) {
+        sameCpus = usage[i].cpuId == m_usage[i].cpuId;
+    }
+
+    m_usage.assign(usage.begin(), usage.end());
+    // 只有处理器上下线时才需要重新排序与布局
+    if (!sameCpus) {
+        rebuildOrder();
+        updateGeometry();
+    }
+    update();
+}
+
+const CpuTopologyEntry* CpuHeatStrip::findTopology(DWORD cpuId) const {
+    auto it = std::lower_bound(m_topology.begin(), m_topology.end(), cpuId,
+        [](const CpuTopologyEntry& cpu, DWORD id) { return cpu.cpuId < id; });
+    return it != m_topology.end() && it->cpuId == cpuId ? &*it : nullptr;
+}
+
+void CpuHeatStrip::rebuildOrder() {
+    m_order.resize(m_usage.size());
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        m_order[i] = i;
+    }
+
+    // 没有拓扑信息的处理器视为封装 0、节点 0、独占一个核心
+    auto key = [this](size_t index) {
+        DWORD cpuId = m_usage[index].cpuId;
+        const CpuTopologyEntry* cpu = findTopology(cpuId);
+        return cpu ? std::make_tuple(cpu->packageId, cpu->numaNode, cpu->coreId, cpuId)
+                   : std::make_tuple(DWORD(0), DWORD(0), cpuId, cpuId);
+    };
+    std::stable_sort(m_order.begin(), m_order.end(),
+        [&key](size_t a, size_t b) { return key(a) < key(b); });
+
+    m_groupStart.assign(m_order.size(), 0);
+    for (size_t position = 1; position < m_order.size(); ++position) {
+        m_groupStart[position] = std::get<0>(key(m_order[position])) != std::get<0>(key(m_order[position - 1]));
+    }
+}
+
+int CpuHeatStrip::columnsFor(int width) const {
+    return std::max(1, (width + kSpacing) / (kCellSize + kSpacing));
+}
+
+template <typename Visitor>
+void CpuHeatStrip::forEachCell(int width, Visitor visit) const {
+    int columns = columnsFor(width);
+    int row = 0;
+    int column = 0;
+    for (size_t position = 0; position < m_order.size(); ++position) {
+        if (column == columns || (m_groupStart[position] && column != 0)) {
+            ++row;
+            column = 0;
+        }
+        QRect cell(column * (kCellSize + kSpacing), row * (kCellSize + kSpacing), kCellSize, kCellSize);
+        if (!visit(position, cell)) {
+            return;
+        }
+        ++column;
+    }
+}
+
+int CpuHeatStrip::heightForWidth(int width) const {
+    int bottom = kCellSize;
+    forEachCell(width, [&bottom](size_t, const QRect& cell) {
+        bottom = cell.bottom() + 1;
+        return true;
+    });
+    return bottom;
+}
+
+QSize CpuHeatStrip::sizeHint() const {
+    int width = 32 * (kCellSize + kSpacing) - kSpacing;
+    return QSize(width, heightForWidth(width));
+}
+
+QSize CpuHeatStrip::minimumSizeHint() const {
+    return QSize(kCellSize, kCellSize);
+}
+
+// 使用率 0% 为绿色，经黄色过渡到 100% 的红色
+static QColor HeatColor(float percent) {
+    float clamped = std::min(std::max(percent, 0.0f), 100.0f);
+    return QColor::fromHsv(static_cast<int>(120.0f * (1.0f - clamped / 100.0f)), 200, 230);
+}
+
+void CpuHeatStrip::paintEvent(QPaintEvent*) {
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().window());
+    forEachCell(width(), [this, &painter](size_t position, const QRect& cell) {
+        if (cell.top() > height()) {
+            return false;
+        }
+        painter.fillRect(cell, HeatColor(m_usage[m_order[position]].total));
+        return true;
+    });
+}
+
+bool CpuHeatStrip::event(QEvent* event) {
+    if (event->type() != QEvent::ToolTip) {
+        return QWidget::event(event);
+    }
+
+    QHelpEvent* helpEvent = static_cast<QHelpEvent*>(event);
+    const CpuCoreUsage* hit = nullptr;
+    forEachCell(width(), [this, helpEvent, &hit](size_t position, const QRect& cell) {
+        if (cell.contains(helpEvent->pos())) {
+            hit = &m_usage[m_order[position]];
+            return false;
+        }
+        return true;
+    });
+    if (!hit) {
+        QToolTip::hideText();
+        event->ignore();
+        return true;
+    }
+
+    QString text = QString("CPU %1").arg(hit->cpuId);
+    if (const CpuTopologyEntry* cpu = findTopology(hit->cpuId)) {
+        text += QString("（封装 %1，NUMA 节点 %2，核心 %3）").arg(cpu->packageId).arg(cpu->numaNode).arg(cpu->coreId);
+    }
+    text += QString("\n总计 %1%\n用户 %2%  系统 %3%\niowait %4%  中断 %5%  steal %6%")
+        .arg(hit->total, 0, 'f', 1).arg(hit->user, 0, 'f', 1).arg(hit->system, 0, 'f', 1)
+        .arg(hit->iowait, 0, 'f', 1).arg(hit->irq, 0, 'f', 1).arg(hit->steal, 0, 'f', 1);
+    QToolTip::showText(helpEvent->globalPos(), text, this);
+    return true;
+}
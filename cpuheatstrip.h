@@ -0,0 +1,47 @@
+﻿#ifndef CPUHEATSTRIP_H
+#define CPUHEATSTRIP_H
+
+#include <QWidget>
+#include <vector>
+#include "SystemInfoCollector.h"
+
+// 逐核 CPU 使用率热力条：每个逻辑处理器一个色块，按宽度自动换行，每个物理封装另起一行；
+// 同一封装内按 NUMA 节点、物理核心排列，超线程兄弟相邻。
+// 全部色块在 paintEvent 中直接绘制，不为每个核心创建子控件；处理器数不变时刷新只触发重绘，不触发重新布局
+class CpuHeatStrip : public QWidget {
+public:
+    explicit CpuHeatStrip(QWidget* parent = nullptr);
+
+    // 清单变化时调用，决定色块顺序与分组
+    void setTopology(const std::vector<CpuTopologyEntry>& topology);
+    // 每次采样后调用；usage 按 cpuId 升序
+    void setUsage(const std::vector<CpuCoreUsage>& usage);
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+    bool hasHeightForWidth() const override { return true; }
+    int heightForWidth(int width) const override;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    bool event(QEvent* event) override;   // 悬停提示
+
+private:
+    static const int kCellSize = 14;
+    static const int kSpacing = 2;
+
+    // 按拓扑重建显示顺序与分组边界
+    void rebuildOrder();
+    const CpuTopologyEntry* findTopology(DWORD cpuId) const;
+    int columnsFor(int width) const;
+    // 依次给出每个显示位置的色块矩形，visit 返回 false 时提前结束
+    template <typename Visitor>
+    void forEachCell(int width, Visitor visit) const;
+
+    std::vector<CpuTopologyEntry> m_topology;   // 按 cpuId 排序
+    std::vector<CpuCoreUsage> m_usage;
+    std::vector<size_t> m_order;                // 显示位置 -> m_usage 下标
+    std::vector<char> m_groupStart;             // 显示位置是否开始一个新封装
+};
+
+#endif // CPUHEATSTRIP_H
@@ -0,0 +1,146 @@
+﻿// diskwidget.cpp
+#include "diskwidget.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QDateTime>
+#include <cmath>
+
+// 辅助函数：以数值形式保存单元格内容，保证按列排序时按大小而不是按字符串比较
+static QStandardItem* CreateNumberItem(double value, int precision) {
+    QStandardItem* item = new QStandardItem();
+    double factor = std::pow(10.0, precision);
+    item->setData(std::round(value * factor) / factor, Qt::DisplayRole);
+    return item;
+}
+
+DiskWidget::DiskWidget(QWidget* parent) : QWidget(parent) {
+    initUI();
+
+    // 每 2 秒采样一次（即速率的统计窗口）
+    m_autoRefreshTimer = new QTimer(this);
+    m_autoRefreshTimer->setInterval(2000);
+    connect(m_autoRefreshTimer, &QTimer::timeout, this, &DiskWidget::onAutoRefresh);
+    m_autoRefreshTimer->start();
+
+    onRefreshButtonClicked(); // 初始加载（首次采样只建立基准，速率为 0）
+}
+
+DiskWidget::~DiskWidget() {}
+
+void DiskWidget::initUI() {
+    // 主布局
+    QVBoxLayout* mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(0, 0, 0, 0);
+
+    // 控制栏
+    QHBoxLayout* controlLayout = new QHBoxLayout();
+    m_refreshBtn = new QPushButton("立即刷新", this);
+    connect(m_refreshBtn, &QPushButton::clicked, this, &DiskWidget::onRefreshButtonClicked);
+    controlLayout->addWidget(m_refreshBtn);
+    controlLayout->addStretch();
+
+    // 表格模型
+    m_model = new QStandardItemModel(0, 10, this);
+    m_model->setHorizontalHeaderLabels({
+        "设备", "读IOPS", "写IOPS", "读取(KB/s)", "写入(KB/s)",
+        "读延迟(ms)", "写延迟(ms)", "平均队列深度", "利用率(%)", "未完成请求"
+        });
+
+    // 表格视图
+    m_tableView = new QTableView(this);
+    m_tableView->setModel(m_model);
+    m_tableView->setSortingEnabled(true);
+    m_tableView->sortByColumn(8, Qt::DescendingOrder);   // 默认按利用率降序
+    m_tableView->setAlternatingRowColors(true);
+    m_tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_tableView->horizontalHeader()->setStretchLastSection(true);
+
+    // 状态栏
+    m_statusLabel = new QLabel("就绪", this);
+
+    // 组装布局
+    mainLayout->addLayout(controlLayout);
+    mainLayout->addWidget(m_tableView);
+    mainLayout->addWidget(m_statusLabel);
+
+    setLayout(mainLayout);
+}
+
+void DiskWidget::refreshTable() {
+    m_model->removeRows(0, m_model->rowCount());
+
+    std::vector<DiskInfo> disks = DataManager::GetInstance().GetDisks();
+    if (disks.empty()) {
+        updateStatus("未发现块设备");
+        return;
+    }
+
+    double totalRead = 0.0;
+    double totalWrite = 0.0;
+    for (const auto& disk : disks) {
+        QList<QStandardItem*> items;
+
+        QStandardItem* nameItem = new QStandardItem(QString::fromStdWString(disk.deviceName));
+        nameItem->setToolTip(QString("累计读取 %1 MB，累计写入 %2 MB")
+            .arg(disk.bytesRead / (1024 * 1024)).arg(disk.bytesWritten / (1024 * 1024)));
+        items << nameItem;
+        items << CreateNumberItem(disk.readIops, 1);
+        items << CreateNumberItem(disk.writeIops, 1);
+        items << CreateNumberItem(disk.readBytesPerSec / 1024.0, 1);
+        items << CreateNumberItem(disk.writeBytesPerSec / 1024.0, 1);
+        items << CreateNumberItem(disk.readLatencyMs, 2);
+        items << CreateNumberItem(disk.writeLatencyMs, 2);
+        items << CreateNumberItem(disk.queueDepth, 2);
+
+        // 利用率（带颜色标记）
+        QStandardItem* utilizationItem = CreateNumberItem(disk.utilization, 1);
+        if (disk.utilization > 80) {
+            utilizationItem->setForeground(QColor(255, 82, 82));   // 红色
+        }
+        else if (disk.utilization > 50) {
+            utilizationItem->setForeground(QColor(247, 150, 70));  // 橙色
+        }
+        items << utilizationItem;
+        items << CreateNumberItem(disk.inFlight, 0);
+
+        // 设置单元格不可编辑
+        for (auto* item : items) {
+            item->setEditable(false);
+        }
+
+        m_model->appendRow(items);
+        totalRead += disk.readBytesPerSec;
+        totalWrite += disk.writeBytesPerSec;
+    }
+
+    // 追加行不会自动重新排序，按当前排序列重排
+    QHeaderView* header = m_tableView->horizontalHeader();
+    m_model->sort(header->sortIndicatorSection(), header->sortIndicatorOrder());
+
+    // 更新状态栏
+    updateStatus(QString("共 %1 个块设备，读取 %2 KB/s，写入 %3 KB/s")
+        .arg(disks.size())
+        .arg(totalRead / 1024.0, 0, 'f', 1)
+        .arg(totalWrite / 1024.0, 0, 'f', 1));
+}
+
+void DiskWidget::updateStatus(const QString& text) {
+    m_statusLabel->setText(QString("%1，最后更新于 %2")
+        .arg(text)
+        .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss")));
+}
+
+// 手动刷新只采样磁盘，不触发其他收集器
+void DiskWidget::onRefreshButtonClicked() {
+    DataManager::GetInstance().CollectDisks();
+    refreshTable();
+}
+
+void DiskWidget::onAutoRefresh() {
+    // 仅在可见时刷新，节省资源
+    if (isVisible()) {
+        onRefreshButtonClicked();
+    }
+}
@@ -0,0 +1,35 @@
+﻿// diskwidget.h
+#ifndef DISKWIDGET_H
+#define DISKWIDGET_H
+
+#include <QWidget>
+#include <QTableView>
+#include <QStandardItemModel>
+#include <QPushButton>
+#include <QLabel>
+#include <QTimer>
+#include "DataManager.h"
+
+class DiskWidget : public QWidget {
+    Q_OBJECT
+public:
+    explicit DiskWidget(QWidget* parent = nullptr);
+    ~DiskWidget() override;
+
+private slots:
+    void onRefreshButtonClicked();
+    void onAutoRefresh();     // 定时器自动刷新，仅在可见时采样
+
+private:
+    void initUI();
+    void refreshTable();
+    void updateStatus(const QString& text);
+
+    QTableView* m_tableView;
+    QStandardItemModel* m_model;
+    QPushButton* m_refreshBtn;
+    QLabel* m_statusLabel;
+    QTimer* m_autoRefreshTimer;   // 速率按两次采样之差计算，定时采样保证统计窗口稳定
+};
+
+#endif // DISKWIDGET_H
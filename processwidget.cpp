@@ -4,7 +4,10 @@
 #include <QHeaderView>
 #include <QDateTime>
 #include <qstandarditemmodel.h>
+#include <cmath>
+#ifdef _WIN32
 #include <warning.h>
+#endif
 
 // 辅助函数：将FILETIME转换为秒数
 double FileTimeToSeconds(const FILETIME& ft) {
@@ -14,7 +17,28 @@ double FileTimeToSeconds(const FILETIME& ft) {
     return static_cast<double>(ull.QuadPart) / 10000000.0;
 }
 
+// 辅助函数：以数值形式保存单元格内容，保证按列排序时按大小而不是按字符串比较
+static QStandardItem* CreateNumberItem(double value, int precision) {
+    QStandardItem* item = new QStandardItem();
+    double factor = std::pow(10.0, precision);
+    item->setData(std::round(value * factor) / factor, Qt::DisplayRole);
+    return item;
+}
+
+// 表格中的数值列对应的列式进程表列；其余列（PID、名称、路径等）返回 false
+static bool ToTableColumn(int section, ProcessTable::Column& column) {
+    switch (section) {
+        case 6:  column = ProcessTable::COLUMN_CPU_USAGE; return true;
+        case 7:  column = ProcessTable::COLUMN_MEMORY; return true;
+        case 8:  column = ProcessTable::COLUMN_MEMORY_GROWTH; return true;
+        case 9:  column = ProcessTable::COLUMN_KERNEL_TIME; return true;
+        case 10: column = ProcessTable::COLUMN_USER_TIME; return true;
+        default: return false;
+    }
+}
+
 ProcessWidget::~ProcessWidget() {
+    DataManager::GetInstance().SetProcessChangeCallback(nullptr);
     delete ui;
 }
 ProcessWidget::ProcessWidget(QWidget* parent) :
@@ -29,40 +53,77 @@ ProcessWidget::ProcessWidget(QWidget* parent) :
     mainLayout->setSpacing(0); // 控件间无间距
 
     // 1. 初始化表格模型
-    QStandardItemModel* model = new QStandardItemModel(0, 9, this);
+    QStandardItemModel* model = new QStandardItemModel(0, 11, this);
     model->setHorizontalHeaderLabels({
         "PID", "PPID", "进程名", "可执行路径", "命令行",
-        "创建时间", "内存(KB)", "内核时间(s)", "用户时间(s)"
+        "创建时间", "CPU(%)", "内存(KB)", "内存增长(KB/s)", "内核时间(s)", "用户时间(s)"
         });
 
     // 2. 配置表格视图
     ui->tableView->setModel(model);
     ui->tableView->setSortingEnabled(true);
+    ui->tableView->sortByColumn(6, Qt::DescendingOrder);  // 默认按 CPU 使用率降序
     ui->tableView->setAlternatingRowColors(true);
     ui->tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
     ui->tableView->horizontalHeader()->setStretchLastSection(true);
     // 设置表格大小策略为“扩展”，确保填满布局空间
     ui->tableView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
+    // 树形视图：按父子关系展示进程，附带子树内存与 CPU 时间合计，默认隐藏
+    QStandardItemModel* treeModel = new QStandardItemModel(0, 6, this);
+    treeModel->setHorizontalHeaderLabels({
+        "进程名", "PID", "内存(KB)", "子树内存(KB)", "子树CPU时间(s)", "子孙进程数"
+        });
+    m_treeView = new QTreeView(this);
+    m_treeView->setModel(treeModel);
+    m_treeView->setSortingEnabled(true);
+    m_treeView->setAlternatingRowColors(true);
+    m_treeView->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    m_treeView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    m_treeView->hide();
+
+    m_treeModeCheck = new QCheckBox("树形视图", this);
+
     // 3. 处理“终止进程”相关控件（假设ui中包含按钮和输入框）
     // 创建一个水平布局存放“刷新按钮”“终止按钮”和输入框
     QHBoxLayout* controlLayout = new QHBoxLayout();
     controlLayout->addWidget(ui->btnFresh); // 刷新按钮
     controlLayout->addWidget(ui->processInfo); // 进程输入框（QLineEdit）
     controlLayout->addWidget(ui->btnTerminateProcess); // 终止按钮
+    controlLayout->addWidget(m_treeModeCheck); // 树形视图开关
 
     // 4. 将所有控件添加到顶层布局
     mainLayout->addLayout(controlLayout); // 添加控制栏（按钮+输入框）
     mainLayout->addWidget(ui->tableView); // 添加表格
+    mainLayout->addWidget(m_treeView); // 添加树形视图（与表格二选一显示）
     mainLayout->addWidget(ui->bottomState); // 添加状态栏（假设是QLabel）
 
     // 5. 连接刷新按钮事件
     connect(ui->btnFresh, &QPushButton::clicked, this, &ProcessWidget::on_refreshButton_clicked);
+    connect(m_treeModeCheck, &QCheckBox::toggled, this, &ProcessWidget::on_treeMode_toggled);
+
+    // 后台线程的更新通知排队到界面线程，合并后刷新
+    m_changeTimer = new QTimer(this);
+    m_changeTimer->setSingleShot(true);
+    m_changeTimer->setInterval(1000);
+    connect(m_changeTimer, &QTimer::timeout, this, &ProcessWidget::refreshTable);
+    connect(this, &ProcessWidget::processesChanged,
+        this, &ProcessWidget::onProcessesChanged, Qt::QueuedConnection);
+    // 回调在后台线程上执行，只转发信号；析构时先注销，注销会等待正在执行的回调
+    DataManager::GetInstance().SetProcessChangeCallback([this]() {
+        emit processesChanged();
+    });
 
     // 初始加载数据
     refreshTable();
 }
 
+void ProcessWidget::onProcessesChanged() {
+    if (!m_changeTimer->isActive()) {
+        m_changeTimer->start();
+    }
+}
+
 
 
 // 刷新表格数据（从DataManager单例获取数据）
@@ -73,8 +134,16 @@ void ProcessWidget::refreshTable() {
     // 清空表格
     model->removeRows(0, model->rowCount());
 
-    // 通过单例获取进程数据
-    const std::vector<ProcessInfo>& processes = DataManager::GetInstance().GetProcesses();
+    // 通过单例获取进程数据（锁内复制的快照，后台更新不影响本次遍历）。
+    // 当前按数值列排序时直接取列式进程表排好序的快照，按原顺序追加即可；其余列由模型排序
+    QHeaderView* header = ui->tableView->horizontalHeader();
+    int sortSection = header->sortIndicatorSection();
+    Qt::SortOrder sortOrder = header->sortIndicatorOrder();
+    ProcessTable::Column sortColumn;
+    bool presorted = ToTableColumn(sortSection, sortColumn);
+    std::vector<ProcessInfo> processes = presorted
+        ? DataManager::GetInstance().GetSortedProcesses(sortColumn, sortOrder == Qt::DescendingOrder)
+        : DataManager::GetInstance().GetProcesses();
     if (processes.empty()) {
         ui->bottomState->setText("无进程数据");
         return;
@@ -88,23 +157,80 @@ void ProcessWidget::refreshTable() {
             << new QStandardItem(QString::fromStdWString(proc.processName))
             << new QStandardItem(QString::fromStdWString(proc.executablePath))
             << new QStandardItem(QString::fromStdWString(proc.commandLine).left(100))
-            << new QStandardItem(QString::fromStdWString(proc.creationTime))
-            << new QStandardItem(QString::number(proc.memoryUsage / 1024.0, 'f', 1))
-            << new QStandardItem(QString::number(FileTimeToSeconds(proc.kernelTime), 'f', 2))
-            << new QStandardItem(QString::number(FileTimeToSeconds(proc.userTime), 'f', 2));
+            << new QStandardItem(QString::fromStdWString(proc.GetCreationTimeString()))
+            << CreateNumberItem(proc.cpuUsage, 1)
+            << CreateNumberItem(proc.memoryUsage / 1024.0, 1)
+            << CreateNumberItem(proc.memoryGrowthRate / 1024.0, 1)
+            << CreateNumberItem(FileTimeToSeconds(proc.kernelTime), 2)
+            << CreateNumberItem(FileTimeToSeconds(proc.userTime), 2);
 
         for (auto* item : items) {
             item->setEditable(false);
         }
         model->appendRow(items);
     }
+    if (!presorted && sortSection >= 0) {
+        model->sort(sortSection, sortOrder);
+    }
+
+    if (m_treeModeCheck->isChecked()) {
+        refreshTree();
+    }
 
     // 更新状态栏
-    ui->bottomState->setText(QString("共 %1 个进程，最后更新于 %2")
+    ProcessSummary summary = DataManager::GetInstance().GetProcessSummary();
+    ui->bottomState->setText(QString("共 %1 个进程，总内存 %2 MB，CPU %3%，最后更新于 %4")
         .arg(processes.size())
+        .arg(summary.totalMemory / (1024.0 * 1024.0), 0, 'f', 1)
+        .arg(summary.totalCpuUsage, 0, 'f', 1)
         .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss")));
 }
 
+// 刷新树形视图
+void ProcessWidget::refreshTree() {
+    QStandardItemModel* model = qobject_cast<QStandardItemModel*>(m_treeView->model());
+    if (!model) return;
+
+    model->removeRows(0, model->rowCount());
+
+    ProcessTree tree = DataManager::GetInstance().GetProcessTree();
+    for (DWORD pid : tree.GetRoots()) {
+        appendTreeNode(tree, pid, model->invisibleRootItem());
+    }
+    m_treeView->expandToDepth(0);
+}
+
+// 递归添加节点及其子进程
+void ProcessWidget::appendTreeNode(const ProcessTree& tree, DWORD pid, QStandardItem* parent) {
+    const ProcessTreeNode* node = tree.FindNode(pid);
+    if (!node) return;
+
+    QList<QStandardItem*> items;
+    items << new QStandardItem(QString::fromStdWString(node->processName))
+        << CreateNumberItem(pid, 0)
+        << CreateNumberItem(node->memoryUsage / 1024.0, 1)
+        << CreateNumberItem(node->subtreeMemory / 1024.0, 1)
+        << CreateNumberItem(node->subtreeCpuTime / 10000000.0, 2)
+        << CreateNumberItem(node->descendantCount, 0);
+
+    for (auto* item : items) {
+        item->setEditable(false);
+    }
+    parent->appendRow(items);
+
+    for (DWORD childPid : node->children) {
+        appendTreeNode(tree, childPid, items.first());
+    }
+}
+
+void ProcessWidget::on_treeMode_toggled(bool checked) {
+    ui->tableView->setVisible(!checked);
+    m_treeView->setVisible(checked);
+    if (checked) {
+        refreshTree();
+    }
+}
+
 void ProcessWidget::on_btnTerminateProcess_clicked()
 {
     // 确保DataManager已初始化
@@ -6,7 +6,11 @@
 #include<QMessageBox>
 #include<QHBoxLayout>
 #include<QVBoxLayout>
-#include "datamanager.h"  // 包含DataManager头文件
+#include<QCheckBox>
+#include<QTreeView>
+#include<QStandardItemModel>
+#include<QTimer>
+#include "DataManager.h"  // 包含DataManager头文件
 
 namespace Ui {
     class ProcessWidget;
@@ -22,13 +26,28 @@ public:
     // 刷新表格数据
     void refreshTable();
 
+signals:
+    // 进程列表已在后台更新（由进程事件线程发出，排队到界面线程处理）
+    void processesChanged();
+
 private slots:
     void on_refreshButton_clicked();  // 刷新按钮点击事件
 
     void on_btnTerminateProcess_clicked();
 
+    void on_treeMode_toggled(bool checked);  // 切换列表/树形视图
+
+    void onProcessesChanged();  // 合并短时间内的多次通知，由 m_changeTimer 到期后统一重绘
+
 private:
+    // 刷新树形视图（父子关系与子树统计来自 DataManager 的进程树）
+    void refreshTree();
+    void appendTreeNode(const ProcessTree& tree, DWORD pid, QStandardItem* parent);
+
     Ui::ProcessWidget* ui;
+    QTreeView* m_treeView;
+    QCheckBox* m_treeModeCheck;
+    QTimer* m_changeTimer;   // 进程事件可能每秒到达多次，表格最多每秒重建一次
     // 不需要保存DataManager指针，直接通过单例访问
 };
 
@@ -1,10 +1,16 @@
 ﻿#include "servicewidget.h"
+#include <QCoreApplication>
 #include <QDateTime>
+#include <QPointer>
+#include <QItemSelectionModel>
+#include <map>
+#ifdef _WIN32
 #include <windows.h>
 #include <winsvc.h>
 
 // 链接WTSAPI32库（用于服务状态转换）
 #pragma comment(lib, "advapi32.lib")
+#endif
 
 // 服务状态转换为字符串
 QString ServiceWidget::serviceStatusToString(DWORD status) {
@@ -27,7 +33,11 @@ ServiceWidget::ServiceWidget(QWidget *parent) :
     m_tableView(nullptr),
     m_model(nullptr),
     m_refreshBtn(nullptr),
-    m_statusLabel(nullptr)
+    m_startBtn(nullptr),
+    m_stopBtn(nullptr),
+    m_restartBtn(nullptr),
+    m_statusLabel(nullptr),
+    m_pendingOperations(0)
 {
     initUI();
     onRefreshClicked(); // 初始加载数据
@@ -49,12 +59,23 @@ void ServiceWidget::initUI() {
     m_refreshBtn = new QPushButton("刷新服务列表", this);
     connect(m_refreshBtn, &QPushButton::clicked, this, &ServiceWidget::onRefreshClicked);
     controlLayout->addWidget(m_refreshBtn);
+
+    // 服务控制按钮：对选中的服务异步执行，不阻塞界面
+    m_startBtn = new QPushButton("启动", this);
+    m_stopBtn = new QPushButton("停止", this);
+    m_restartBtn = new QPushButton("重启", this);
+    connect(m_startBtn, &QPushButton::clicked, this, &ServiceWidget::onStartClicked);
+    connect(m_stopBtn, &QPushButton::clicked, this, &ServiceWidget::onStopClicked);
+    connect(m_restartBtn, &QPushButton::clicked, this, &ServiceWidget::onRestartClicked);
+    controlLayout->addWidget(m_startBtn);
+    controlLayout->addWidget(m_stopBtn);
+    controlLayout->addWidget(m_restartBtn);
     controlLayout->addStretch();
 
     // 表格模型
-    m_model = new QStandardItemModel(0, 5, this);
+    m_model = new QStandardItemModel(0, 6, this);
     m_model->setHorizontalHeaderLabels({
-        "服务名称", "显示名称", "状态", "启动类型", "二进制路径"
+        "服务名称", "显示名称", "状态", "启动类型", "依赖服务", "二进制路径"
     });
 
     // 表格视图
@@ -62,6 +83,8 @@ void ServiceWidget::initUI() {
     m_tableView->setModel(m_model);
     m_tableView->setSortingEnabled(true);
     m_tableView->setAlternatingRowColors(true);
+    m_tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_tableView->setSelectionMode(QAbstractItemView::ExtendedSelection);
     m_tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
     m_tableView->horizontalHeader()->setStretchLastSection(true);
     m_tableView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -81,13 +104,19 @@ void ServiceWidget::refreshTable() {
     // 清空表格
     m_model->removeRows(0, m_model->rowCount());
 
-    // 获取服务数据
-    const std::vector<ServiceInfo>& services = DataManager::GetInstance().GetServices();
+    // 获取服务数据（副本，控制线程可能同时更新服务状态）
+    const std::vector<ServiceInfo> services = DataManager::GetInstance().GetServices();
     if (services.empty()) {
         updateStatus("未发现服务信息");
         return;
     }
 
+    // 最近检测到配置变化的服务（同一服务保留最后一次变化）
+    std::map<std::wstring, ServiceConfigChange> configChanges;
+    for (auto& change : DataManager::GetInstance().GetServiceConfigChanges()) {
+        configChanges[change.serviceName] = std::move(change);
+    }
+
     // 填充表格
     for (const auto& service : services) {
         QList<QStandardItem*> items;
@@ -114,10 +143,36 @@ void ServiceWidget::refreshTable() {
 
         // 4. 启动类型
         items << new QStandardItem(QString::fromStdWString(service.startTypeStr));
-        // 5. 二进制路径（长路径截断）
+        // 5. 依赖服务
+        QStringList dependencyNames;
+        for (const auto& dependency : service.dependencies) {
+            dependencyNames << QString::fromStdWString(dependency);
+        }
+        QStandardItem* dependencyItem = new QStandardItem(dependencyNames.join(", "));
+        dependencyItem->setToolTip(dependencyNames.join("\n"));
+        items << dependencyItem;
+        // 6. 二进制路径（长路径截断）
         QString binPath = QString::fromStdWString(service.binaryPath);
         QStandardItem* pathItem = new QStandardItem(binPath.left(50) + "...");
         pathItem->setToolTip(binPath); // 完整路径提示
+        // 配置发生过变化的服务标红，二进制路径被修改可能是持久化行为
+        auto changeIt = configChanges.find(service.serviceName);
+        if (changeIt != configChanges.end()) {
+            const ServiceConfigChange& change = changeIt->second;
+            pathItem->setForeground(QColor(255, 59, 48)); // 红色
+            QString tip = binPath;
+            if (change.changedFields & SERVICE_CONFIG_CHANGED_BINARY_PATH) {
+                tip += QString("\n二进制路径已变更，原路径：%1").arg(QString::fromStdWString(change.oldBinaryPath));
+            }
+            if (change.changedFields & SERVICE_CONFIG_CHANGED_START_TYPE) {
+                tip += QString("\n启动类型已变更，原类型：%1")
+                    .arg(QString::fromStdWString(ServiceCollector::StartTypeToString(change.oldStartType)));
+            }
+            if (change.changedFields & SERVICE_CONFIG_CHANGED_DEPENDENCIES) {
+                tip += "\n依赖服务已变更";
+            }
+            pathItem->setToolTip(tip);
+        }
         items << pathItem;
 
         // 设置单元格不可编辑
@@ -141,4 +196,89 @@ void ServiceWidget::updateStatus(const QString& text) {
 void ServiceWidget::onRefreshClicked() {
     DataManager::GetInstance().ManualRefresh(); // 刷新数据
     refreshTable(); // 刷新表格
+}
+
+void ServiceWidget::onStartClicked() {
+    controlSelectedServices(SERVICE_OPERATION_START);
+}
+
+void ServiceWidget::onStopClicked() {
+    controlSelectedServices(SERVICE_OPERATION_STOP);
+}
+
+void ServiceWidget::onRestartClicked() {
+    controlSelectedServices(SERVICE_OPERATION_RESTART);
+}
+
+std::vector<std::wstring> ServiceWidget::selectedServiceNames() const {
+    std::vector<std::wstring> names;
+    for (const QModelIndex& index : m_tableView->selectionModel()->selectedRows(0)) {
+        names.push_back(index.data().toString().toStdWString());
+    }
+    return names;
+}
+
+void ServiceWidget::controlSelectedServices(ServiceOperationType type) {
+    std::vector<std::wstring> names = selectedServiceNames();
+    if (names.empty()) {
+        updateStatus("请先选择服务");
+        return;
+    }
+
+    // 按依赖关系展开：停止/重启连带依赖方，启动连带未运行的依赖
+    ServiceOperationPlan plan;
+    if (!DataManager::GetInstance().PlanServiceOperation(names, type, plan)) {
+        updateStatus("无法生成操作计划：服务不存在或存在循环依赖");
+        return;
+    }
+
+    // 回调在控制线程上执行，不访问窗口：把结果排队到应用对象（属于界面线程），
+    // 窗口是否已销毁在界面线程上检查
+    QPointer<ServiceWidget> guard(this);
+    m_pendingOperations += static_cast<int>(plan.steps.size());
+    DataManager::GetInstance().ExecuteServicePlan(plan,
+        [guard](const ServiceOperationOutcome& outcome) {
+            QCoreApplication* app = QCoreApplication::instance();
+            if (!app) {
+                return;
+            }
+            QString serviceName = QString::fromStdWString(outcome.serviceName);
+            int type = outcome.type;
+            int result = outcome.result;
+            quint32 status = outcome.finalStatus;
+            QMetaObject::invokeMethod(app, [guard, serviceName, type, result, status]() {
+                if (guard) {
+                    guard->onServiceOperationFinished(serviceName, type, result, status);
+                }
+            }, Qt::QueuedConnection);
+        });
+    updateStatus(QString("已提交 %1 个服务操作（%2 层，含依赖相关服务），进行中 %3 个")
+        .arg(plan.steps.size()).arg(plan.waveCount).arg(m_pendingOperations));
+}
+
+void ServiceWidget::onServiceOperationFinished(QString serviceName, int type, int result, quint32 status) {
+    if (m_pendingOperations > 0) {
+        --m_pendingOperations;
+    }
+
+    QString action;
+    switch (type) {
+        case SERVICE_OPERATION_START:   action = "启动"; break;
+        case SERVICE_OPERATION_STOP:    action = "停止"; break;
+        default:                        action = "重启"; break;
+    }
+    QString resultStr;
+    switch (result) {
+        case SERVICE_OPERATION_SUCCEEDED: resultStr = "成功"; break;
+        case SERVICE_OPERATION_TIMED_OUT: resultStr = "超时"; break;
+        case SERVICE_OPERATION_CANCELLED: resultStr = "已取消"; break;
+        case SERVICE_OPERATION_SKIPPED:   resultStr = "已跳过（前置操作未成功）"; break;
+        default:                          resultStr = "失败"; break;
+    }
+
+    // 服务列表中的状态已由 DataManager 更新，直接重绘表格
+    refreshTable();
+    updateStatus(QString("%1服务 %2 %3（当前状态：%4），进行中 %5 个")
+        .arg(action).arg(serviceName).arg(resultStr)
+        .arg(serviceStatusToString(status)).arg(m_pendingOperations));
 }
\ No newline at end of file
@@ -9,7 +9,8 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QHeaderView>
-#include "datamanager.h"
+#include <vector>
+#include "DataManager.h"
 
 // 服务窗口类
 class ServiceWidget : public QWidget {
@@ -20,11 +21,18 @@ public:
 
 private slots:
     void onRefreshClicked(); // 刷新按钮点击事件
+    void onStartClicked();
+    void onStopClicked();
+    void onRestartClicked();
+    void onServiceOperationFinished(QString serviceName, int type, int result, quint32 status);
 
 private:
     void initUI(); // 初始化UI
     void refreshTable(); // 刷新服务表格
     void updateStatus(const QString& text); // 更新状态栏
+    // 对选中的服务批量提交异步操作
+    void controlSelectedServices(ServiceOperationType type);
+    std::vector<std::wstring> selectedServiceNames() const;
 
     // 状态转换辅助函数
     QString serviceStatusToString(DWORD status);
@@ -33,7 +41,11 @@ private:
     QTableView* m_tableView;
     QStandardItemModel* m_model;
     QPushButton* m_refreshBtn;
+    QPushButton* m_startBtn;
+    QPushButton* m_stopBtn;
+    QPushButton* m_restartBtn;
     QLabel* m_statusLabel;
+    int m_pendingOperations; // 已提交尚未完成的服务操作数
 };
 
 #endif // SERVICEWIDGET_H
\ No newline at end of file
@@ -3,8 +3,10 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QHeaderView>
+#ifdef _WIN32
 #include <WtsApi32.h>
 #pragma comment(lib, "WtsApi32.lib")
+#endif
 
 SessionWidget::SessionWidget(QWidget* parent) : QWidget(parent) {
     initUI();
@@ -94,8 +96,9 @@ void SessionWidget::refreshTable() {
         items << domainItem;
 
         // 4. 登录时间
-        QStandardItem* timeItem = new QStandardItem(QString::fromStdWString(session.loginTime));
-        timeItem->setToolTip(QString::fromStdWString(session.loginTime));
+        QString loginTime = QString::fromStdWString(session.GetLoginTimeString());
+        QStandardItem* timeItem = new QStandardItem(loginTime);
+        timeItem->setToolTip(loginTime);
         items << timeItem;
 
         // 5. 状态（带颜色标记）
@@ -8,7 +8,7 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QDateTime>
-#include "datamanager.h"
+#include "DataManager.h"
 
 class SessionWidget : public QWidget {
     Q_OBJECT
@@ -12,6 +12,10 @@ SystemInfoMonitor::SystemInfoMonitor(QWidget* parent)
         qCritical() << "DataManager初始化失败！";
         // 可根据需要弹出错误提示或退出程序
     }
+    else if (!DataManager::GetInstance().StartProcessEvents()) {
+        // 平台不支持或权限不足，进程列表仅靠定时扫描刷新
+        qDebug() << "进程事件不可用，使用定时扫描";
+    }
 
     // 设置tabWidget填满主窗口
     //ui.tabWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -22,6 +26,7 @@ SystemInfoMonitor::SystemInfoMonitor(QWidget* parent)
     ui.tabWidget->addTab(new NetworkConnectionWidget(this), "网络信息");
     ui.tabWidget->addTab(new ServiceWidget(this), "服务信息");
     ui.tabWidget->addTab(new SessionWidget(this), "登录会话"); // 添加会话页
+    ui.tabWidget->addTab(new DiskWidget(this), "磁盘I/O");
 
 
     // 绑定标签页切换事件（控制自动刷新）
@@ -3,12 +3,13 @@
 
 #include <QMainWindow>
 #include "ui_systeminfomonitor.h" // 包含UI头文件
-#include "datamanager.h" // 包含DataManager头文件
+#include "DataManager.h" // 包含DataManager头文件
 #include "processwidget.h"
 #include "systeminfowidget.h"
 #include"NetworkConnectionWidget.h"
 #include "servicewidget.h"
 #include "sessionwidget.h" // 包含会话Widget头文件
+#include "diskwidget.h"
 class SystemInfoMonitor : public QMainWindow {
     Q_OBJECT
 
@@ -119,6 +119,14 @@ void SystemInfoWidget::initUI() {
     m_hardwareGroup->setLayout(hardwareLayout);
     mainLayout->addWidget(m_hardwareGroup);
 
+    // ===== 逐核使用率热力条 =====
+    m_cpuCoreGroup = new QGroupBox("逐核CPU使用率", this);
+    QVBoxLayout* cpuCoreLayout = new QVBoxLayout(m_cpuCoreGroup);
+    m_cpuHeatStrip = new CpuHeatStrip(this);
+    cpuCoreLayout->addWidget(m_cpuHeatStrip);
+    m_cpuCoreGroup->setLayout(cpuCoreLayout);
+    mainLayout->addWidget(m_cpuCoreGroup);
+
     // ===== 3. 内存信息组 =====
     m_memoryGroup = new QGroupBox("内存信息", this);
     QVBoxLayout* memoryLayout = new QVBoxLayout(m_memoryGroup);
@@ -148,6 +156,22 @@ void SystemInfoWidget::initUI() {
     usageMemLayout->addWidget(m_memoryUsageBar);
     memoryLayout->addLayout(usageMemLayout);
 
+    // 扩展内存指标：提交量、缓存、交换区、换页与缺页速率、内存压力
+    auto addMemoryRow = [this, memoryLayout](const QString& title) {
+        QHBoxLayout* rowLayout = new QHBoxLayout();
+        rowLayout->addWidget(new QLabel(title, this));
+        QLabel* valueLabel = new QLabel("-", this);
+        rowLayout->addWidget(valueLabel);
+        rowLayout->addStretch();
+        memoryLayout->addLayout(rowLayout);
+        return valueLabel;
+    };
+    m_commitLabel = addMemoryRow("已提交/提交上限：");
+    m_cacheLabel = addMemoryRow("页缓存/缓冲区：");
+    m_swapLabel = addMemoryRow("交换区已用/总量：");
+    m_pagingLabel = addMemoryRow("换入/换出/主缺页：");
+    m_pressureLabel = addMemoryRow("内存压力（PSI）：");
+
     m_memoryGroup->setLayout(memoryLayout);
     mainLayout->addWidget(m_memoryGroup);
 
@@ -159,11 +183,16 @@ void SystemInfoWidget::initUI() {
     setLayout(mainLayout);
 }
 
-// 刷新系统信息（核心数据更新逻辑）
+// 刷新系统信息：清单只在首次或失效后重新采集，计数器读取采样线程的最新样本
 void SystemInfoWidget::refreshSystemInfo() {
-    // 强制刷新数据管理器中的最新数据
-    m_dataManager.ManualRefresh();
-    const SystemInfo& sysInfo = m_dataManager.GetSystemInfo();
+    m_dataManager.CollectSystemInfo();
+    updateInventoryLabels();
+    updateCounterLabels();
+    m_firstLoad = false; // 标记首次加载完成
+}
+
+void SystemInfoWidget::updateInventoryLabels() {
+    SystemInventory sysInfo = m_dataManager.GetSystemInventory();
 
     // 更新操作系统信息
     m_osVersionLabel->setText(QString::fromStdWString(sysInfo.osVersion));
@@ -174,6 +203,14 @@ void SystemInfoWidget::refreshSystemInfo() {
     // 更新CPU信息
     m_cpuInfoLabel->setText(QString::fromStdWString(sysInfo.cpuInfo));
     m_cpuCoresLabel->setText(QString::number(sysInfo.cpuCores));
+    m_cpuHeatStrip->setTopology(sysInfo.cpuTopology);
+}
+
+void SystemInfoWidget::updateCounterLabels() {
+    // 与 CPU 使用率、内存速率取自同一个采样线程，各项数值一致
+    SystemSample sample;
+    m_dataManager.GetLatestSystemSample(sample);
+    const SystemCounters& sysInfo = sample.counters;
 
     // 更新CPU使用率
     double cpuUsage = m_dataManager.GetCpuUsage();
@@ -193,6 +230,10 @@ void SystemInfoWidget::refreshSystemInfo() {
             "QProgressBar::chunk {background-color: #4CAF50;}");
     }
 
+    // 更新逐核热力条（悬停查看各分项占比）
+    m_dataManager.GetCpuCoreUsage(m_cpuCoreUsage);
+    m_cpuHeatStrip->setUsage(m_cpuCoreUsage);
+
     // 更新内存信息
     m_totalMemoryLabel->setText(bytesToGB(sysInfo.totalPhysicalMemory));
     m_availableMemoryLabel->setText(bytesToGB(sysInfo.availablePhysicalMemory));
@@ -222,19 +263,40 @@ void SystemInfoWidget::refreshSystemInfo() {
         m_memoryUsageBar->setValue(0);
     }
 
-    m_firstLoad = false; // 标记首次加载完成
+    // 扩展内存指标（速率取自采样线程的最近两个样本）
+    const MemoryCounters& memory = sysInfo.memory;
+    m_commitLabel->setText(memory.commitLimit > 0
+        ? bytesToGB(memory.commitTotal) + " / " + bytesToGB(memory.commitLimit) : QString("不支持"));
+    m_cacheLabel->setText(bytesToGB(memory.cached) + " / " + bytesToGB(memory.buffers));
+    m_swapLabel->setText(memory.swapTotal > 0
+        ? bytesToGB(memory.swapTotal - memory.swapFree) + " / " + bytesToGB(memory.swapTotal) : QString("未启用"));
+
+    MemoryRates rates = m_dataManager.GetMemoryRates();
+    m_pagingLabel->setText(QString("%1 / %2 页/秒，%3 次/秒")
+        .arg(rates.swapInPerSecond, 0, 'f', 0)
+        .arg(rates.swapOutPerSecond, 0, 'f', 0)
+        .arg(rates.majorFaultsPerSecond, 0, 'f', 0));
+    if (memory.hasPressure) {
+        m_pressureLabel->setText(QString("some %1%（10秒 %2%），full %3%（10秒 %4%）")
+            .arg(rates.pressureSome, 0, 'f', 1).arg(memory.pressure.someAvg10, 0, 'f', 1)
+            .arg(rates.pressureFull, 0, 'f', 1).arg(memory.pressure.fullAvg10, 0, 'f', 1));
+    }
+    else {
+        m_pressureLabel->setText("不支持");
+    }
 }
 
-// 手动刷新按钮点击事件
+// 手动刷新按钮点击事件：连同静态清单一起重新采集
 void SystemInfoWidget::onRefreshClicked() {
+    m_dataManager.InvalidateSystemInventory();
     refreshSystemInfo();
 }
 
-// 定时器自动刷新事件（1秒一次）
+// 定时器自动刷新事件（1秒一次）：只读取采样线程的最新样本，不在界面线程上采集
 void SystemInfoWidget::onAutoRefresh() {
     // 仅在可见时刷新，节省资源
     if (isVisible()) {
-        refreshSystemInfo();
+        updateCounterLabels();
     }
 }
 
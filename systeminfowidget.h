@@ -9,7 +9,8 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
-#include "datamanager.h"
+#include "DataManager.h"
+#include "cpuheatstrip.h"
 
 namespace Ui {
     class SystemInfoWidget;
@@ -35,6 +36,9 @@ private slots:
     void onTabVisibleChanged(bool visible); // 标签页显示/隐藏状态变化
 
 private:
+    void updateInventoryLabels(); // 更新静态清单（系统版本、主机名、CPU 型号等）
+    void updateCounterLabels();   // 更新动态计数器（CPU 与内存使用率）
+
     Ui::SystemInfoWidget* ui;
     DataManager& m_dataManager;
 
@@ -51,11 +55,20 @@ private:
     QLabel* m_cpuUsageLabel;
     QProgressBar* m_cpuUsageBar;
 
+    QGroupBox* m_cpuCoreGroup;
+    CpuHeatStrip* m_cpuHeatStrip;
+    std::vector<CpuCoreUsage> m_cpuCoreUsage;   // 每次刷新复用
+
     QGroupBox* m_memoryGroup;
     QLabel* m_totalMemoryLabel;
     QLabel* m_availableMemoryLabel;
     QLabel* m_memoryUsageLabel;
     QProgressBar* m_memoryUsageBar;
+    QLabel* m_commitLabel;
+    QLabel* m_cacheLabel;
+    QLabel* m_swapLabel;
+    QLabel* m_pagingLabel;
+    QLabel* m_pressureLabel;
 
     QPushButton* m_refreshBtn;
     QTimer* m_autoRefreshTimer; // 自动刷新定时器